@@ -22,17 +22,17 @@ n = 6: Lê duas matrizes geradas pelo MATLAB e calcula o produto através de div
 n = 7: Lê um sistema gerado pelo MATLAB, resolve-o através da bioblioteca LAPACK e calcula a norma 2 do resultado.
 n = 8: Lê um sistema gerado pelo MATLAB, resolve-o pelo método de diagonalização e calcula o determinante e a norma 2 do resultado.
 n = 9: Lê um sistema gerado pelo MATLAB, resolve-o pelo método do cálculo da matriz inversa por eliminação de Gauss e calcula o determinante e a norma 2 do resultado.
-n = 10: Lê um sistema gerado pelo MATLAB e retorna a equação característica da matriz, o determinante e a inversa.
+n = 10: Lê um sistema gerado pelo MATLAB e retorna a equação característica da matriz (por redução à forma de Hessenberg e recorrência de La Budde), o determinante e, para matrizes pequenas, a inversa (por Leverrier-Faddeev).
 n = 11: Lê um sistema gerado pelo MATLAB, resolve-o pelo método de decomposição LU, verifica a precisão conforme a tolerância permitida e aplica a correção, se necessário.
 n = 12: Lê um sistema gerado pelo MATLAB e o resolve pelo método iterativo de Jacobi.
 n = 13: Lê um sistema gerado pelo MATLAB e o resolve pelo método de Gauss-Seidel.
 n = 14: Lê uma matriz gerada pelo MATLAB e calcula o maior e o menor autovalor pelo método das potências.
 n = 15: Lê uma matriz gerada pelo MATLAB e calcula todos os seus autovalores pelo método de Jacobi.
-n = 16: Lê uma matriz gerada pelo MATLAB e calcula todos os seus autovalores pelo método de Rutishauer e seus autovetores por eliminação Gaussiana com pivotação.
+n = 16: Lê uma matriz gerada pelo MATLAB e calcula todos os seus autovalores pelo método QR de Francis (deslocamento duplo, após redução à forma de Hessenberg) e os autovetores dos autovalores reais por iteração inversa (eliminação Gaussiana com pivotação na forma de Hessenberg).
 n = 17: Lê uma matriz gerada pelo MATLAB e decompõe-na em valores singulares.
 n = 18: Lê uma tabela gerada pelo MATLAB e calcula o polinômio interpolador.
 n = 19: Lê uma tabela gerada pelo MATLAB e interpola um ponto pelo método de Lagrange.
-n = 20: Lê uma matriz gerada pelo MATLAB e comprime-a, por meio de decomposição em valores singulares.
+n = 20: Lê uma matriz gerada pelo MATLAB e comprime-a, por meio de decomposição em valores singulares, gravando as matrizes comprimidas e seus fatores (formato binário de posto baixo, .flr).
 n = 21: Lê uma tabela gerada pelo MATLAB e interpola um ponto pelo método de Hermite.
 n = 22: Lê uma tabela gerada pelo MATLAB e interpola um ponto pelo método do spline cúbico.'2
 n = 23: Lê uma tabela gerada pelo MATLAB e extrapola um ponto pelo método tradicional e pelo de Richardson.
@@ -53,6 +53,18 @@ n = 33: Lê uma tabela gerada pelo MATLAB e calcula a integral dupla corresponde
 n = 34: Calcula a integral dupla por diversos métodos.
 n = 35: Lê especificação de um capacitor coaxial e calcula o potencial e o campo elétrico no seu interior.
 n = 36: Lê uma tabela gerada pelo MATLAB e interpola um ponto por regressão polinomial.
+n = 37: Lê um sistema gerado pelo MATLAB e o resolve pelo método iterativo de Jacobi assíncrono (caótico), em paralelo.
+n = 38: Lê uma matriz gerada pelo MATLAB e calcula todos os seus autovalores pelo método de Jacobi paralelo (ordenação de Brent-Luk).
+n = 39: Lê uma matriz gerada pelo MATLAB e calcula os maiores e os menores autovalores e autovetores pelo método da iteração em subespaço.
+n = 40: Lê uma matriz gerada pelo MATLAB, armazena-a em formato esparso e calcula os maiores e os menores autovalores e autovetores pelo método de Lanczos (os menores por inversão espectral).
+n = 41: Lê uma matriz gerada pelo MATLAB e calcula todos os seus autovalores e autovetores por redução à forma tridiagonal e dividir e conquistar.
+n = 42: Lê uma matriz gerada pelo MATLAB e uma especificação [a b il iu] e calcula, por bissecção na forma tridiagonal, os autovalores em [a, b) e os de índices il a iu, com seus autovetores por iteração inversa.
+n = 43: Lê uma matriz gerada pelo MATLAB e uma especificação [k e q] e calcula a decomposição SVD truncada por projeção aleatória (posto k ou, se k = 0, a fração e da energia de Frobenius, com q iterações de potência).
+n = 44: Lê uma matriz gerada pelo MATLAB por blocos de linhas, sem carregá-la inteira, calcula sua decomposição SVD por QR sequencial (TSQR) e grava U no arquivo 'us'.
+n = 45: Lê uma imagem em tons de cinza (im'm'.pfm ou im'm'.pgm), comprime-a por peças, cada uma com sua própria SVD, em paralelo, grava os fatores (im'm'.flt) e a imagem reconstruída (imr'm').
+n = 46: Lê uma matriz gerada pelo MATLAB e uma especificação [p t] e calcula A^p, por quadrados sucessivos, e e^(t A), por escalonamento e quadrados sucessivos com aproximação de Padé.
+n = 47: Converte os arquivos gerados pelo MATLAB com tamanho m (MatA'm', S'm', C'm' etc.) para o formato binário ('nome''m'.fmb). Quando existe, o arquivo binário é usado no lugar do arquivo texto, mapeado em memória, sem conversão.
+n = 48: Multiplica MatA'm' por MatB'm' fora da memória, por peças lidas dos arquivos binários ('nome''m'.fmb, criados a partir dos arquivos texto, por blocos de linhas, se não existirem), com a leitura das peças seguintes em paralelo com o cálculo, e grava o produto, peça a peça, em MatC'm'.fmb.
 
 
 
@@ -91,17 +103,18 @@ Observações:
 1) Compilado e testado com MinGW 4.8.2.
 2) Utiliza a biblioteca OpenBlas 2.15.
 3) Utiliza a biblioteca LAPACK 3.6.0. Compilar com as opções -D__USE_MINGW_ANSI_STDIO e -DHAVE_LAPACK_CONFIG_H -DLAPACK_COMPLEX_CPP e linkar com compilador Fortran (gfortran).
+4) Os dados de entrada 'nome''m' são procurados, nesta ordem, em 'nome''m'.fmb (problema 47), nos arquivos MAT do MATLAB 'nome''m'.mat e dados'm'.mat (nível 5, sem compressão: save -v6) e no arquivo texto 'nome''m'.
+5) Na primeira leitura de um arquivo texto, os dados convertidos são gravados em 'nome''m'.cache, com o tamanho, a data e o hash do arquivo texto; enquanto estes não mudarem, as leituras seguintes apenas mapeiam o cache em memória.
 
 
 TO DO:
-1) Verificar liberação de memória alocada, principalmente em fsolveG e fmavJ.
-2) Testar função fpower.
-3) Verificar aumento do esforço com aumento do tamanho:
+1) Verificar liberação de memória alocada, principalmente em fsolveG.
+2) Verificar aumento do esforço com aumento do tamanho:
 	Gauss x Cholesky
-	Leverrier x Leverrier-Faddeev
-4) Implementar critério de parada para método de Rutshauer.
-5) Implementar regressão polinomial múltipla.
-6) Implementar splino cúbico não-natural.
+	Leverrier-Faddeev x Hessenberg (La Budde)
+3) Implementar critério de parada para método de Rutshauer.
+4) Implementar regressão polinomial múltipla.
+5) Implementar splino cúbico não-natural.
 */
 
 #define __USE_MINGW_ANSI_STDIO 1	// para usar precisão estendida
@@ -110,7 +123,11 @@ TO DO:
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <float.h>
 #include <omp.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <sys/time.h>
 #include <windows.h>
 #include <time.h>
@@ -126,10 +143,7 @@ TO DO:
 #define MAIORQUEDOISPI 		6.3
 
 // para leitura dos dados em arquivo
-#define bufsize 		50000				
 #define FNAME_MAX_SIZE	255
-#define POSROWNBR		7			// posição do número de linhas no arquivo
-#define POSCOLNBR 		10			// posição do número de colunas no arquivo
 // custo de operações
 // (https://www-ssl.intel.com/content/dam/www/public/us/en/documents/manuals/64-ia-32-architectures-optimization-manual.pdf)
 #define FLOPS_SQRT		10
@@ -140,11 +154,45 @@ TO DO:
 #define DEBUGLEVEL_DEF	0			// nível de debug
 #define MAXERR_DEF		1e-5		// valor de erro máximo
 #define MAXITER_DEF		100			// número de iterações máximo
+#define NAV_DEF			4			// número de autovalores extremos procurados
+#define NLANCZOS_MIN	20			// dimensão adicional do subespaço de Krylov no método de Lanczos
+#define NB_TRID			32			// largura do bloco de reflexões na redução à forma tridiagonal
+#define NDC_MIN			25			// dimensão abaixo da qual o método de dividir e conquistar usa o método QL
+#define MAXITER_SEC		200			// número máximo de bissecções na solução da equação secular
+#define NSUB_BISEC		4			// subintervalos de bissecção por thread
+#define PIVMIN_STURM	(DBL_MIN / DBL_EPSILON)	// menor pivô admitido na sequência de Sturm
+#define MAXITER_INV		5			// número máximo de iterações da iteração inversa
+#define ORTOL_INV		1e-3		// separação relativa abaixo da qual os autovetores são reortogonalizados
+#define NMAX_LF			100			// dimensão acima da qual o método de Leverrier-Faddeev não é usado no problema 10
+#define PADE_EXPM		6			// grau da aproximação de Padé na exponencial de matriz
+#define NOVER_RSVD		10			// colunas adicionais da amostra aleatória na SVD truncada
+#define NB_RSVD			16			// colunas acrescentadas à amostra aleatória a cada passo na SVD truncada por energia
+// métodos paralelos
+#define PERIODO_JA		4			// intervalo, em varreduras, entre verificações do resíduo global no Jacobi assíncrono
+#define PAD_JA			16			// espaçamento entre os resíduos de cada thread (evita falso compartilhamento)
+// arquivos
+#define FLR_MAGIC		"FLR1"		// identificação do arquivo binário de matriz de posto baixo
+#define NB_LINHAS		64			// linhas por bloco na leitura e na reconstrução por blocos
+#define FLT_MAGIC		"FLT1"		// identificação do arquivo binário de matriz comprimida por peças
+#define NB_TILE			64			// dimensão das peças na compressão por peças
+#define FMB_MAGIC		"FMB1"		// identificação do arquivo binário de matriz densa
+#define FMB_DADOS		64			// posição (alinhada) dos dados no arquivo binário de matriz densa
+#define MEM_OOC			1024		// memória, em MB, ocupada pelas peças na multiplicação fora da memória
+#define FMB_CHAVE		24			// posição, no cabeçalho do cache, da chave do arquivo texto (tamanho, data e hash)
+#define FSAVE_VALMAX	16			// número máximo de caracteres de um valor gravado por fsaveval
+#define FSAVE_BLOCO		(1 << 22)	// tamanho aproximado, em bytes, de cada bloco de linhas formatado por fsavelinhas
+#define BIN_RA			false		// grava os níveis de compressão do problema 20 no formato binário (ra<n>.fmb), e não em texto
+#define MAT5_CABEC		128			// tamanho do cabeçalho do arquivo MAT do MATLAB (nível 5)
+#define MAT5_COMPLEXO	0x0800		// indicador de matriz complexa no arquivo MAT
+#define mxDOUBLE_CLASS	6			// primeira e última classes numéricas do arquivo MAT (double, single e inteiras)
+#define mxUINT64_CLASS	15
 
 void *__gxx_personality_v0;			// desabilita tratamento de exceção
 
 typedef enum {Progressivo, Retroativo, Central} ModoDeriv;
 typedef enum {NewtonCotes, GaussLegendre} ModoIntegr;
+// tipos de dados do arquivo MAT do MATLAB (nível 5)
+typedef enum {miINT8 = 1, miUINT8, miINT16, miUINT16, miINT32, miUINT32, miSINGLE, miDOUBLE = 9, miINT64 = 12, miUINT64, miMATRIX, miCOMPRESSED} TipoMat5;
 static const char * ModoIntegrStr[] = {"Newton-Cotes", "Gauss-Legendre"};
 
 typedef void f_exec(int);			// função a ser despachada
@@ -153,6 +201,19 @@ typedef float f_func1(float);
 typedef float f_func2(float, float);
 
 typedef int f_iter(float *, float *, float *, float *, float **, float *, float *, int *, int);
+// operador linear y = A x, com os dados da matriz em 'pdata'
+typedef void f_oper(float * px, float * py, void * pdata);
+// decomposição LU (f2LU) de uma matriz n x n, usada pelo operador y = A^-1 x
+typedef struct {
+	float * pL, * pU;
+	int * pP;
+	int n;
+	} fLUmat;
+typedef struct {
+	int nrows, ncols, nnz;
+	int * prow, * pcol;
+	float * pval;
+	} fcsrmat;
 typedef struct {
 	int rank;
 	float ncond, sum, max, min;
@@ -160,6 +221,38 @@ typedef struct {
 typedef struct {
 	fcompressdetail antes, depois;
 	} fcompressdata;
+typedef struct {
+	float val;
+	int pos;
+	} fsingdata;
+// matriz de posto baixo A = U S V^T: U é nrows x rank, S é diagonal (rank) e V é ncols x rank
+typedef struct {
+	int nrows, ncols, rank;
+	float * pS, * pU, * pV;
+	float * pwork;
+	} flowrank;
+// arquivo do MATLAB/Octave mapeado em memória: 'pcur' aponta para a próxima linha de dados, que é a linha 'linha' da matriz
+typedef struct {
+	char name[FNAME_MAX_SIZE + 1];
+	HANDLE hfile, hmap;
+	const char * pini, * pfim, * pcur;
+	int nrows, ncols, linha;
+	} fmatfile;
+// arquivo binário de matriz densa (.fmb) aberto para leitura ou gravação por peças; 'paux' guarda uma linha em double e 'tmp' é o
+// arquivo temporário em que a gravação é feita até fmbfecha (vazio na leitura)
+typedef struct {
+	char name[FNAME_MAX_SIZE + 8];
+	char tmp[FNAME_MAX_SIZE + 40];
+	FILE * fp;
+	int tipo, nrows, ncols, ld;
+	void * paux;
+	} fmbfile;
+// destinos da leitura de uma matriz em diversas precisões: cada ponteiro não nulo recebe os valores lidos
+typedef struct {
+	float * pf;
+	double * pd;
+	long double * pld;
+	} fmatprec;
 
 typedef struct {
 	float x, x2, phi, valor;
@@ -181,6 +274,7 @@ typedef struct {
 // Protótipos de funções
 void calcn2(float * fmat, double * dmat, long double * ldmat, int nrows, int ncols);
 void dchangerows(double * pmat, int rows, int ncols, int row1, int row2);
+void dcvtfd(const float * psrc, double * pdst, size_t n);
 int dfindmax(double * pmat, int nrows, int ncols, int pos, bool colmode, int start);	
 double * dmmult(double * pA, int nrowA, int ncolA, double * pB, int nrowB, int ncolB);
 double dmnorm2(double * pmat, int nrow, int ncol);
@@ -195,28 +289,34 @@ f_exec execprob1, execprob2, execprob3, execprob4, execprob5,
 	execprob21, execprob22, execprob23, execprob24, execprob25, 
 	execprob26, execprob27, execprob28, execprob29, execprob30,
 	execprob31, execprob32, execprob33, execprob34, execprob35,
-	execprob36;
+	execprob36, execprob37, execprob38, execprob39, execprob40,
+	execprob41, execprob42, execprob43, execprob44, execprob45,
+	execprob46, execprob47, execprob48;
 float * fajust(float * pmat, int nrows, int ncols);
+int fbisect(float * pd, float * pe, int n, double a, double b, int ca, int cb, int il, int iu, float * pav, double atol);
 float fcalcmult(float * coef, int ncols, float * px);
 float fcalcpol(float * coef, int ncols, float x);
 void fchangerows(float * pmat, int rows, int ncols, int row1, int row2);
-void fcompress(float * pS, float * pU, float * pV, int nrows, int ncols, float retain, float ** ppnS, float ** ppnU, float ** ppnV, fcompressdata * pstats);
+int fcmpsing(const void * pa, const void * pb);
+void fcompress(float * pS, float * pU, float * pV, int nrows, int ncols, float retain, float ** ppnS, float ** ppnU, float ** ppnV, fcompressdata * pstats, int nsing = 0);
 float * fcriapol(float * pmat, int nrows, int ncols, int * pgrau);
+void fcvtdf(const double * psrc, float * pdst, size_t n);
 float * fderivP(float * pmat, int nrows, int ncols);
 float * fderivS(float * pmat, int nrows, int ncols, ModoDeriv modo);
 float * fderivT(float * pmat, int nrows, int ncols, int n);
 float * fdoLU(float * pB, float * pL, float * pU, int * pP, int nrows);
+void fdoLUblk(float * pB, float * pX, int nrhs, float * pL, float * pU, int * pP, int nrows);
 void felipintN(float x, float * pek, float * pfk, ModoIntegr modo, int grau, int nsteps);
 float felipx(float phi);
-float * feqcaracL(float * pmat, int nrows, int ncols);
+float * feqcaracH(float * pmat, int nrows, int ncols, float * pdet = NULL);
 float * feqcaracLF(float * pmat, int nrows, int ncols, float * pdev = NULL, float ** ppinv = NULL);
+float * fexpm(float * pmat, int nrows, int ncols);
 float fextrapR(float * pA, int nrows, int ncols);
 int ffindmax(float * pmat, int nrows, int ncols, int pos, bool colmode, int start);	
 void ffromsys(float * psys, int nrows, int ncols, float ** ppA, float ** ppB);
 float * fgemm(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB);
 float * fgemmref(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB);
 float fgenpol(float x);
-double fgetval(char ** pbuffer);
 float * fident(int rank, float val = 1);
 float findut(int n, float h, float r, float d, int formula, ModoIntegr modo, int grau, int steps);
 float findutA(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps);
@@ -238,46 +338,106 @@ float finterpS(float * pA, int nrows, int ncols);
 float finterpSH(float * pA, int nrows, int ncols);
 float * finvG(float * pmat, int rank, int ncols, float * pdet);
 float finvelipx(float phi);
+int finviterH(float * pH, int n, float * pav, int nav, float * pQ, float ** ppmav, int * piter);
+int finviterT(float * pd, float * pe, int n, float * pav, int nav, float * pQ, float ** ppmav, int * piter);
 float * finvTS(float * pmat, int rank, int ncols, bool superior);
 bool fisddom(float * pmat, int nrows, int ncols);
 bool fissym(float * pmat, int nrows, int ncols);
 bool fistris(float * pmat, int nrows, int ncols);
 f_iter fiterGS, fiterJ, fiterLU;
 int fiterate(int type, f_iter * pfn, float * pA, float * pB, float ** ppX, int * piter, float * perror, float * pL, float * pU, int * pP, int nrows);
+float * flermat(const char * fname, int size, int * pnrows, int * pncols);
 float * fmadd(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB, bool add = true);
+int fmavB(float * pd, float * pe, int n, float vl, float vu, int il, int iu, float ** ppav, int * pnav);
+int fmavDC(float * pmat, int nrows, int ncols, float ** ppav, float ** ppmav);
 int fmavJ(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppmav = NULL);
-int fmavR(float * pmat, int nrows, int ncols, float ** ppav, int * piter);
+int fmavJP(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppmav = NULL);
+int fmavL(f_oper * pop, void * pdata, int n, int nav, bool maiores, float ** ppav, float ** ppmav, int * piter, bool modulo = false);
+int fmavQR(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppavi = NULL);
+int fmavS(float * pmat, int nrows, int ncols, int nav, bool direto, float ** ppav, float ** ppmav, int * piter);
 int fmmaxavP(float * pmat, int nrows, int ncols, float * pmax, int * piter, bool direto = true);
+long long int fmat5tag(const unsigned char * p, const unsigned char * pfim, bool troca, int * ptipo, unsigned int * pnbytes, 
+	const unsigned char ** ppdados);
+int fmat5tam(int tipo);
+unsigned int fmat5u32(const unsigned char * p, bool troca);
+double fmat5val(const unsigned char * p, int tipo, size_t k, bool troca);
+void fmbabre(const char * fname, int size, fmbfile * pmb);
+bool fmbatual(const char * name, const char * src, const char * pcabec);
+void fmbconverte(const char * fname, int size, const char * name);
+void fmbcria(const char * name, int nrows, int ncols, fmbfile * pmb);
+void fmbfecha(fmbfile * pmb);
+void fmbgravapeca(fmbfile * pmb, int i0, int j0, int nr, int nc, const float * psrc);
+bool fmblecabec(fmbfile * pmb, const char * src);
+void fmblepeca(fmbfile * pmb, int i0, int j0, int nr, int nc, float * pdst);
 float * fmcopy(double * psrc, int nrows, int ncols);
+void fm2csr(float * pmat, int nrows, int ncols, fcsrmat * pcsr);
+void flrcreate(float * pS, float * pU, float * pV, int nrows, int ncols, int p, int * pord, int rank, flowrank * plr);
+float flrelem(flowrank * plr, int i, int j);
+void flrfree(flowrank * plr);
+int flrload(const char * fname, flowrank * plr);
+float * flrmatmat(flowrank * plr, float * pB, int ncolB);
+void flrmatvec(flowrank * plr, float * px, float * py, bool transp);
+void flrrows(flowrank * plr, int ini, int nr, float * pdst);
+int flrread(FILE * fp, flowrank * plr);
+int flrsave(const char * fname, flowrank * plr);
+void flrwrite(FILE * fp, flowrank * plr);
 float * fmmult(float * pA, int nrowA, int ncolA, float * pBf, int nrowB, int ncolB);
 float fmnormi(float * fmerror, int nrows, int ncols);
 float fmnorm2(float * pmat, int nrow, int ncol);
-float * fmslice(double * psrc, int nrsrc, int ncsrc, int nrdst, int ncdst, int ir, int ic);
+int fmortho(float * pmat, int nrows, int ncols);
+float * fmsliceF(float * psrc, int nrsrc, int ncsrc, int nrdst, int ncdst, int ir, int ic);
 float * fmtimes(float * pmat, int nrows, int ncols, float value);
 float * fmtrisolve(float * pmat, int nrows, int ncols, bool superior);
+f_oper fopcsr, fopLU, foplowrank;
 int fmakeLU(float * pmat, int nrows, int ncols, float * values, int * position);
+int fparesRR(int n, int round, int * pp, int * pq);
+unsigned long long int fnvhash(const char * p, long long int n);
+double foocmult(fmbfile * pmA, fmbfile * pmB, fmbfile * pmC, int nb);
 float fperiod(float * pmat, int nrows, int ncols);
-float * fpower (float * pmat, int nrows, int ncols);
+float * fpower(float * pmat, int nrows, int ncols, int pot);
+void fqrR(float * pA, int nrows, int ncols);
+float * frandn(int nrows, int ncols, unsigned int seed);
 void fqualajust(float * pval, int nrows, int ncols, float * coef, float * pr2, float * pvar, float * pmedia);
-int fsavemat(const char * fname, float * pmat, int nrows, int ncols, bool header);
+int fsavebin(const char * fname, double * pmat, int nrows, int ncols, const long long int * pchave = NULL);
+int fsavebinP(const char * fname, const void * pmat, int tipo, int nrows, int ncols, const long long int * pchave = NULL);
+void fsavebincabec(FILE * fp, int tipo, int nrows, int ncols, const long long int * pchave = NULL);
+void fsavecache(const char * fname, int size, double * pmat, int nrows, int ncols, long long int * pchave);
+int fsaveimg(const char * fname, float * pmat, int nrows, int ncols, bool pfm);
+void fsavecabec(FILE * fp, const char * fname, int nrows, int ncols);
+int fsavelinhas(FILE * fp, float * pmat, int nrows, int ncols);
+int fsavemat(const char * fname, float * pmat, int nrows, int ncols, bool header, bool binario = false);
+int fsaveval(char * p, float val);
 void fshowmat(float * pmat, int nrows, int ncols, const char * header);
+int fsturm(float * pd, float * pe, int n, double x);
+int fsvdJ(float * pG, int n, int m, float * pVt, int * psweeps);
+int * fsvdordem(float * pS, int p, float * pretain, int nlevels, fcompressdata * pstats);
+void fsvdupdate(float * pC, float * pS, float * pU, float * pV, int nrows, int ncols, int p, int * pord, int k0, int k1);
 float fsinx__y(float x, float y);
 float * fsolveChol(float * psrc, int rank, float * pdet = NULL);
 float * fsolveDG(float * psrc, int rank, float * pdet);
 float * fsolveG(float * psrc, int rank, float * pdet = NULL);
 int fsolveGS(float * psrc, int rank, float ** ppX, int * piter);
 int fsolveJ(float * psrc, int rank, float ** ppX, int * piter);
+int fsolveJA(float * psrc, int rank, float ** ppX, int * piter);
 float * fsolveLS(float * psys, int rank, int nrhs);
 int fsolveLU(float * psys, int nrows, int ncols, float ** ppX, float * pdet = NULL, int * pinter = NULL, float * perror = NULL);
+int ftql(float * pd, float * pe, int n, float * pZ, int ldz);
+int ftilecompress(float * pA, int nrows, int ncols, int tile, float retain, const char * fname, int * pranktot, long long int * pnvals);
+float * ftiledecompress(const char * fname, int * pnrows, int * pncols);
 float ftrace(float * pmat, int nrows, int ncols);
 float * ftranspose(float * psrc, int nrows, int ncols);
+int ftridiagDC(float * pd, float * pe, int n, float * pZ, int ldz);
 float * f2Chol(float * psrc, int rank, float * pdet);
 float * f2diag(float * psrc, int rank, float * pdet);
+float * f2hess(float * psrc, int nrows, int ncols, float ** ppQ = NULL);
 void f2LR(float * psrc, int rank, float ** ppL, float ** ppR);
 void f2LU(float * psrc, int rank, float ** ppL, float ** ppU, int ** ppP, float * pdet);
-int f2SVD(float * pA, int nrows, int ncols, float ** ppS , float ** ppU, float ** ppV);
+int f2SVD(float * pA, int nrows, int ncols, float ** ppS , float ** ppU, float ** ppV, bool completa = false);
+int f2SVDR(float * pA, int nrows, int ncols, int rank, float energia, int npot, float ** ppS , float ** ppU, float ** ppV, int * prank);
+int f2SVDS(const char * fname, int size, int rank, const char * fnameU, float ** ppS, float ** ppV, int * pnrows, int * pncols, int * prank);
 float * f2sys(float * psrc, float * pval, int rank);
 float * f2tri(float * psrc, int rank, int ncols, float * pdet = NULL);
+int f2tridiag(float * psrc, int nrows, int ncols, float ** ppd, float ** ppe, float ** ppQ = NULL);
 void init_fgenpol(float * pmat, int nrows, int ncols, int grau);
 void init_fdindut(float r1, float r2, float phi1, float b, float d, int nsteps);
 void ldchangerows(long double * pmat, int rows, int ncols, int row1, int row2);
@@ -289,7 +449,21 @@ long double * ldmtrisolve(long double * pmat, int nrows, int ncols, bool superio
 void ldshowmat(long double * pmat, int nrows, int ncols, const char * header);
 long double * ldsolveG(long double * psrc, int rank, long double * pdet);
 long double * ld2tri(long double * psrc, int rank, long double * pdet);
+double * lerbin(const char * fname, int size, int * pnrows, int * pncols, bool * pmapeada);
+double * lercache(const char * fname, int size, int * pnrows, int * pncols, bool renova = true);
+void lercabec(const char * fname, int size, fmatfile * pmf);
+bool lerchave(const char * name, long long int * pchave, bool hash);
+void lerfecha(fmatfile * pmf);
+float * lerimg(const char * fname, int * pnrows, int * pncols);
+int lerimgtoken(FILE * fp);
+int lerlinha(const char ** pp, const char * pfim, int ncols, fmatprec * pdst, size_t pos);
+void lerlinhas(fmatfile * pmf, int nrows, fmatprec * pdst);
+const char * lermapa(const char * name, bool copia, HANDLE * phfile, HANDLE * phmap, long long int * ptam);
 double * lermat(const char * fname, int size, int * nrows, int * ncolA);
+double * lermat5(const char * name, const char * var, bool primeira, int * pnrows, int * pncols);
+void lermatP(const char * fname, int size, int * pnrows, int * pncols, float ** ppf, double ** ppd, long double ** ppld);
+void lertexto(const char * fname, int size, int * pnrows, int * pncols, float ** ppf, double ** ppd, long double ** ppld);
+double lerval(const char ** pp, const char * pfim);
 int main(int argc, const char * argv[]);
 void ucrono(bool init, int divisor);
 void valargs(int argc, const char * argv[], int * pprobnbr, int * psize);
@@ -297,6 +471,7 @@ void valargs(int argc, const char * argv[], int * pprobnbr, int * psize);
 
 static int debuglevel_, maxiter_, prec_;
 static long long int flops_;
+#pragma omp threadprivate(flops_)	// cada thread conta as próprias operações; quem as chama em paralelo soma as contagens
 static float maxerr_;
 
 static ElipticData elipticdata_;
@@ -325,6 +500,9 @@ int main(int argc, const char * argv[]) {
 		& execprob28, & execprob29, & execprob30,
 		& execprob31, & execprob32, & execprob33,
 		& execprob34, & execprob35, & execprob36,
+		& execprob37, & execprob38, & execprob39, & execprob40,
+		& execprob41, & execprob42, & execprob43, & execprob44, & execprob45,
+		& execprob46, & execprob47, & execprob48,
 		};
 	fn[probnbr - 1](size);
 	return 0;
@@ -389,7 +567,7 @@ void valargs(int argc, const char * argv[], int * pprobnbr, int * psize) {
 		}
 	int probnbr = atoi(argv[1]);
 	int size = atoi(argv[2]);
-	if (probnbr < 1 || probnbr > 36) {
+	if (probnbr < 1 || probnbr > 48) {
 		printf("Número do problema inválido (%d)! \n", probnbr);
 		exit(2);
 		}
@@ -406,20 +584,18 @@ void valargs(int argc, const char * argv[], int * pprobnbr, int * psize) {
 // Funções despachadas
 void execprob1(int size) {
 // Executa o problema número 1 com o tamanho 'size' indicado.
-	// Lê as matrizes de entrada
+	// Lê as matrizes de entrada, de uma só vez, em diversas precisões
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("MatA", size, & nrowA, & ncolA);
-	double * pBd = lermat("MatB", size, & nrowB, & ncolB );
+	float * pAf, * pBf;
+	double * pAd, * pBd;
+	long double * pAld, * pBld;
+	lermatP("MatA", size, & nrowA, & ncolA, & pAf, & pAd, & pAld);
+	lermatP("MatB", size, & nrowB, & ncolB, & pBf, & pBd, & pBld);
 	// Verifica se podem ser multiplicadas
 	if (ncolA != nrowB) {
 		printf("As matrizes não podem ser multiplicadas, porque as dimensões são incompatíveis: (%d x %d) e (%d x %d)! \n", nrowA, ncolA, nrowB, ncolB);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
-	float * pBf = fmcopy(pBd, nrowB, ncolB);
-	long double * pAld = ldmcopy(pAd, nrowA, ncolA);
-	long double * pBld = ldmcopy(pBd, nrowB, ncolB);
 	// Multiplica as matrizes e relata o esforço computacional necessário
 	flops_ = 0;
 	float * pCf = fmmult(pAf, nrowA, ncolA, pBf, nrowB, ncolB);
@@ -434,10 +610,13 @@ void execprob1(int size) {
 	
 void execprob2(int size) {
 // Executa o problema número 2 com o tamanho 'size' indicado.
-	// Lê as matrizes de entrada
+	// Lê as matrizes de entrada, de uma só vez, em diversas precisões
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("TS", size, & nrowA, & ncolA);
-	double * pBd = lermat("TI", size, & nrowB, & ncolB );
+	float * pAf, * pBf;
+	double * pAd, * pBd;
+	long double * pAld, * pBld;
+	lermatP("TS", size, & nrowA, & ncolA, & pAf, & pAd, & pAld);
+	lermatP("TI", size, & nrowB, & ncolB, & pBf, & pBd, & pBld);
 	// Verifica se possuem as dimensões corretas
 	if (ncolA != nrowA + 1) {
 		printf("O primeiro sistema não pode ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
@@ -447,11 +626,6 @@ void execprob2(int size) {
 		printf("O segundo sistema não pode ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowB, ncolB);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
-	float * pBf = fmcopy(pBd, nrowB, ncolB);
-	long double * pAld = ldmcopy(pAd, nrowA, ncolA);
-	long double * pBld = ldmcopy(pBd, nrowB, ncolB);
 	// Resolve os sistemas e relata o esforço computacional
 	flops_ = 0;
 	float * pCf = fmtrisolve(pAf, nrowA, ncolA, true);
@@ -472,17 +646,17 @@ void execprob2(int size) {
 	
 void execprob3(int size) {
 // Executa o problema número 3 com o tamanho 'size' indicado.
-	// Lê o sistema de entrada
+	// Lê o sistema de entrada, de uma só vez, em diversas precisões
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf;
+	double * pAd;
+	long double * pAld;
+	lermatP("S", size, & nrowA, & ncolA, & pAf, & pAd, & pAld);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
-	long double * pAld = ldmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema e relata o valor do determinante e o esforço computacional necessário para solução
 	float fdet;
 	double ddet;
@@ -507,15 +681,12 @@ void execprob4(int size) {
 // Executa o problema número '4' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
-	long double * pAld = ldmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema e relata o valor do determinante e o esforço computacional necessário para solução
 	float * pCf, fdet;
 	flops_ = 0;
@@ -536,14 +707,12 @@ void execprob5(int size) {
 // Executa o problema número "5" com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("C", size, & nrowA, & ncolA);
+	float * pAf = flermat("C", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema e relata o valor do determinante e o esforço computacional necessário para solução
 	if (! fissym(pAf, nrowA, ncolA)) {
 		printf("A matriz não é simétrica! \n");
@@ -574,16 +743,13 @@ void execprob6(int size) {
 // Executa o problema número '6' com o tamanho 'size' indicado
 	// Lê as matrizes de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("MatA", size, & nrowA, & ncolA);
-	double * pBd = lermat("MatB", size, & nrowB, & ncolB );
+	float * pAf = flermat("MatA", size, & nrowA, & ncolA);
+	float * pBf = flermat("MatB", size, & nrowB, & ncolB );
 	// Verifica se podem ser multiplicadas
 	if (ncolA != nrowB) {
 		printf("As matrizes não podem ser multiplicadas, porque as dimensões são incompatíveis: (%d x %d) e (%d x %d)! \n", nrowA, ncolA, nrowB, ncolB);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
-	float * pBf = fmcopy(pBd, nrowB, ncolB);
 	// Multiplica as matrizes por meio de rotinas diversas e compara o desempenho
 	ucrono(true, 0);
 	float * pCf = fmmult(pAf, nrowA, ncolA, pBf, nrowB, ncolB);
@@ -613,14 +779,12 @@ void execprob7(int size) {
 // Executa o problema número '7' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema
 	float * pCf = fsolveLS(pAf, nrowA, 1);
 	// Calcula e relata a norma 2 dos resultados
@@ -632,14 +796,12 @@ void execprob8(int size) {
 // Executa o problema número '8' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema e relata o valor do determinante e o esforço computacional necessário para solução
 	float fdet;
 	flops_ = 0;
@@ -656,14 +818,12 @@ void execprob9(int size) {
 // Executa o problema número '9' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Inverte a matriz e relata o valor do determinante
 	float fdet;
 	flops_ = 0;
@@ -691,16 +851,19 @@ void execprob10(int size) {
 // Executa o problema número '10' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Relata a equação característica segundo os algoritmos implementados
+	float fdet, * pinv;
 	flops_ = 0;
-	float * peq = feqcaracL(pAf, nrowA, ncolA);
-	printf("Número de operações necessário para calcular a equação característica da matriz: %lld. \n", flops_);	
+	float * peq = feqcaracH(pAf, nrowA, ncolA, & fdet);
+	printf("Número de operações necessário para calcular a equação característica da matriz e o determinante: %lld. \n", flops_);	
 	fshowmat(peq, nrowA + 1, 1, "Coeficientes da equação característica da matriz:");
+	printf("Determinante: %f \n", fdet);
 	free(peq);
-	float fdet, * pinv;
+	// O método de Leverrier-Faddeev, O(n^4), é usado apenas para matrizes pequenas, para obter também a inversa
+	if (nrowA > NMAX_LF) {
+		return;
+		}
 	flops_ = 0;
 	peq = feqcaracLF(pAf, nrowA, ncolA, & fdet, & pinv);
 	printf("Número de operações necessário para calcular a equação característica da matriz, determinante e inversa: %lld. \n", flops_);	
@@ -716,14 +879,12 @@ void execprob11(int size) {
 // Executa o problema número '11' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("S", size, & nrowA, & ncolA);
+	float * pAf = flermat("S", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve o sistema por decomposição LU com refinamento
 	flops_ = 0;
 	int niter;
@@ -739,14 +900,12 @@ void execprob12(int size) {
 // Executa o problema número '12' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("D", size, & nrowA, & ncolA);
+	float * pAf = flermat("D", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve pelo método iterativo de Jacobi
 	float * pX;
 	int niter;
@@ -763,14 +922,12 @@ void execprob13(int size) {
 // Executa o problema número '13' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("D", size, & nrowA, & ncolA);
+	float * pAf = flermat("D", size, & nrowA, & ncolA);
 	// Verifica se pode ser resolvido
 	if (ncolA != nrowA + 1) {
 		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
 		exit(5);
 		}
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
 	// Resolve pelo método iterativo de Gauss-Seidel
 	float * pX;
 	int niter;
@@ -788,20 +945,22 @@ void execprob14(int size) {
 // Executa o problema número '14' com o tamanho 'size' indicado.
 	// Lê  o sistema de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("C", size, & nrowA, & ncolA);
+	float * pA = flermat("C", size, & nrowA, & ncolA);
 	// Encontra os autovalores extremos pelo método das potências e relata o esforço computacional necessário
 	float maxav, minav = 0;
 	int niter[2], flops[2];
 	flops_ = 0;
-	float * pAf = fmslice(pAd, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
 	int retcode = fmmaxavP(pAf, nrowA, nrowA, & maxav, niter, true);
 	flops[0] = flops_;
 	free(pAf);
 	flops_ = 0;
-	pAf = fmcopy(pAd, nrowA, ncolA);
+	pAf = fmsliceF(pA, nrowA, ncolA, nrowA, ncolA, 0, 0);
+	free(pA);
 	retcode = fmmaxavP(pAf, nrowA, ncolA, & minav, niter + 1, false);
 	printf("Número de operações para cálculo dos autovalores extremos: %lld e %d. Iterações: %d e %d \n", flops[1], flops[0], niter[1], niter[0]);	
 	printf("Autovalores extremos: %f e %f. Número de condição: %f \n", minav, maxav, maxav/minav);
+	free(pAf);
 	return;
 	}
 
@@ -809,9 +968,9 @@ void execprob15(int size) {
 // Executa o problema número '15' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("C", size, & nrowA, & ncolA);
+	float * pA = flermat("C", size, & nrowA, & ncolA);
 	// Encontra os autovalores e autovetores pelo método de Jacobi e relata o esforço computacional necessário
-	float * pAf = fmslice(pAd, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
 	if (! fissym(pAf, nrowA, nrowA)) {
 		printf("A matriz não é simétrica! \n");
 		exit(13);
@@ -826,7 +985,8 @@ void execprob15(int size) {
 	printf("Número de operações: %lld. Iterações: %d. \n", flops_, niter);
 	free(pAf);
 	free(pav);
-	pAf = fmslice(pAd, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
 	flops_ = 0;
 	retcode = fmavJ(pAf, nrowA, nrowA, & pav , & niter, & pmav);
 	if (debuglevel_ >= 2) {
@@ -840,18 +1000,66 @@ void execprob16(int size) {
 // Executa o problema número '16' com o tamanho 'size' indicado.
 	// Lê o sistema de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("C", size, & nrowA, & ncolA);
+	float * pA = flermat("C", size, & nrowA, & ncolA);
 	// Cria versões em diversas precisões
-	float * pAf = fmslice(pAd, nrowA, ncolA, nrowA, nrowA, 0, 0);
-	// Encontra os autovalores pelo método de Rutishauer e relata o esforço computacional necessário
-	float * pav;
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	// Encontra os autovalores pelo método QR de Francis e relata o esforço computacional necessário
+	float * pav, * pavi;
 	int niter;
 	flops_ = 0;
-	int retcode = fmavR(pAf, nrowA, ncolA, & pav , & niter);
+	int retcode = fmavQR(pAf, nrowA, nrowA, & pav , & niter, & pavi);
+	if (retcode != 0) {
+		printf("O método não convergiu! \n");
+		}
 	if (debuglevel_ >= 2) {
-		fshowmat(pav, nrowA, 1, "Autovalores");
+		fshowmat(pav, nrowA, 1, "Autovalores (parte real)");
+		fshowmat(pavi, nrowA, 1, "Autovalores (parte imaginária)");
 		}
 	printf("Número de operações para encontrar os autovalores: %lld. Iterações: %d. \n", flops_, niter);
+	// Encontra os autovetores dos autovalores reais por iteração inversa na forma de Hessenberg
+	int nreal = 0;
+	for (int i = 0; i < nrowA; ++ i) {
+		if (pavi[i] == 0) {
+			pav[nreal ++] = pav[i];
+			}
+		}
+	float * pH, * pQ, * pmav;
+	flops_ = 0;
+	pH = f2hess(pAf, nrowA, nrowA, & pQ);
+	if (fissym(pAf, nrowA, nrowA)) {
+		// Matriz simétrica: H é tridiagonal e os autovetores de autovalores próximos são reortogonalizados
+		float * pd = (float *) malloc(2 * nrowA * sizeof(float));
+		if (pd == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x 2! \n", nrowA);
+			exit(7);
+			}
+		float * pe = pd + nrowA;
+		for (int i = 0; i < nrowA; ++ i) {
+			pd[i] = pH[i * nrowA + i];
+			pe[i] = (i < nrowA - 1) ? pH[(i + 1) * nrowA + i] : 0;
+			}
+		for (int i = 1; i < nreal; ++ i) {
+			float aux = pav[i];
+			int j;
+			for (j = i - 1; j >= 0 && pav[j] > aux; -- j) {
+				pav[j + 1] = pav[j];
+				}
+			pav[j + 1] = aux;
+			}
+		retcode = finviterT(pd, pe, nrowA, pav, nreal, pQ, & pmav, & niter);
+		free(pd);
+		}
+	else {
+		retcode = finviterH(pH, nrowA, pav, nreal, pQ, & pmav, & niter);
+		}
+	if (retcode != 0) {
+		printf("A iteração inversa não convergiu para todos os autovetores! \n");
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pmav, nrowA, nreal, "Autovetores");
+		}
+	printf("Número de operações para encontrar %d autovetores: %lld. Iterações: %d. \n", nreal, flops_, niter);
 	return;
 	}
 
@@ -859,23 +1067,26 @@ void execprob17(int size) {
 // Executa o problema número '17' com o tamanho 'size' indicado.
 	// Lê a matriz de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("A", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("A", size, & nrowA, & ncolA);
 	// Decompõe a matriz na forma SVD
 	float * pS, * pU, * pV;
 	flops_ = 0;
 	int retcode = f2SVD(pAf, nrowA, ncolA, & pS , & pU, &pV);
+	if (retcode != 0) {
+		printf("Não conseguiu fazer a decomposição! \n");
+		}
+	// Decomposição reduzida: S é p x p, U é nrowA x p e V é ncolA x p
+	int p = (nrowA < ncolA) ? nrowA : ncolA;
 	if (debuglevel_ >= 2) {
 		fshowmat(pAf, nrowA, ncolA, "A");
-		fshowmat(pS, nrowA, ncolA, "S");
-		fshowmat(pU, nrowA, nrowA, "U");
-		fshowmat(pV, ncolA, ncolA, "V");		
+		fshowmat(pS, p, p, "S");
+		fshowmat(pU, nrowA, p, "U");
+		fshowmat(pV, ncolA, p, "V");		
 		}
 	printf("Número de operações para a decomposição: %lld. \n", flops_);
-	float * pA = fgemm(pU, nrowA, nrowA, pS, nrowA, ncolA);
-	float * pB = ftranspose(pV, ncolA, ncolA);
-	float * pC = fgemm(pA, nrowA, ncolA, pB, ncolA, ncolA);
+	float * pA = fgemm(pU, nrowA, p, pS, p, p);
+	float * pB = ftranspose(pV, ncolA, p);
+	float * pC = fgemm(pA, nrowA, p, pB, p, ncolA);
 	// Calcula e relata a norma 2 dos resultados
 	calcn2(pAf, NULL, NULL, nrowA, ncolA);
 	calcn2(pC, NULL, NULL, nrowA, ncolA);
@@ -886,9 +1097,7 @@ void execprob18(int size) {
 // Executa o problema número '18' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém os coeficientes do polinômio para interpolação
 	flops_ = 0;
 	float * pP = finterp(pAf, nrowA, ncolA);
@@ -903,9 +1112,7 @@ void execprob19(int size) {
 // Executa o problema número '19' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém o ponto por interpolação de Lagrange
 	flops_ = 0;
 	float y = finterpL(pAf, nrowA, ncolA);
@@ -916,9 +1123,7 @@ void execprob19(int size) {
 void execprob20(int size) {
 	// Lê a matriz de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("A", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("A", size, & nrowA, & ncolA);
 	// Decompõe a matriz na forma SVD
 	float * pS, * pU, * pV;
 	flops_ = 0;
@@ -928,80 +1133,115 @@ void execprob20(int size) {
 		printf("Não conseguiu fazer a decomposição! \n");
 		}
 	printf("Número de operações para a decomposição: %lld. \n", flops_);
-	// Comprime a matriz
-	float * pnS, * pnU, * pnV;
-	fcompressdata stats;
-	printf("Compressão da matriz para 80%% dos valores singulares... \n");
-	flops_ = 0;
-	fcompress(pS, pU, pV, nrowA, ncolA, 0.8, & pnS, & pnU, & pnV, & stats);
-	printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats . antes . rank, stats . depois . rank, stats . antes . ncond, stats . depois . ncond, stats . antes . max,stats . depois . max, stats . antes . min, stats . depois . min, stats . antes . sum, stats . depois . sum);
-	int rank = stats . depois . rank;
-	float * pA = fgemm(pnU, nrowA, rank, pnS, rank, rank);
-	float * pB = ftranspose(pnV, ncolA, rank);
-	float * pC = fgemm(pA, nrowA, rank, pB, rank, ncolA);
-	// Grava em disco
-	printf("Número de operações para a compressão: %lld. \n", flops_);
-	printf("Gravando a matriz... \n");
-	fsavemat("ra8", pC, nrowA, ncolA, false);
-	free(pnS);
-	free(pnU);
-	free(pnV);
-	free(pA);
-	free(pB);
-	free(pC);
-	printf("Compressão da matriz para 60%% dos valores singulares... \n");
-	flops_ = 0;
-	fcompress(pS, pU, pV, nrowA, ncolA, 0.6, & pnS, & pnU, & pnV, & stats);
-	printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats . antes . rank, stats . depois . rank, stats . antes . ncond, stats . depois . ncond, stats . antes . max,stats . depois . max, stats . antes . min, stats . depois . min, stats . antes . sum, stats . depois . sum);
-	rank = stats . depois . rank;
-	pA = fgemm(pnU, nrowA, rank, pnS, rank, rank);
-	pB = ftranspose(pnV, ncolA, rank);
-	pC = fgemm(pA, nrowA, rank, pB, rank, ncolA);
-	// Grava em disco
-	printf("Número de operações para a compressão: %lld. \n", flops_);
-	printf("Gravando a matriz... \n");
-	fsavemat("ra6", pC, nrowA, ncolA, false);
-	free(pnS);
-	free(pnU);
-	free(pnV);
-	free(pA);
-	free(pB);
-	free(pC);
-	printf("Compressão da matriz para 40%% dos valores singulares... \n");
-	flops_ = 0;
-	fcompress(pS, pU, pV, nrowA, ncolA, 0.4, & pnS, & pnU, & pnV, & stats);
-	printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats . antes . rank, stats . depois . rank, stats . antes . ncond, stats . depois . ncond, stats . antes . max,stats . depois . max, stats . antes . min, stats . depois . min, stats . antes . sum, stats . depois . sum);
-	rank = stats . depois . rank;
-	pA = fgemm(pnU, nrowA, rank, pnS, rank, rank);
-	pB = ftranspose(pnV, ncolA, rank);
-	pC = fgemm(pA, nrowA, rank, pB, rank, ncolA);
-	// Grava em disco
-	printf("Número de operações para a compressão: %lld. \n", flops_);
-	printf("Gravando a matriz... \n");
-	fsavemat("ra4", pC, nrowA, ncolA, false);
-	free(pnS);
-	free(pnU);
-	free(pnV);
-	free(pA);
-	free(pB);
-	free(pC);
-	printf("Compressão da matriz para 20%% dos valores singulares... \n");
+	// Ordena os valores singulares uma única vez e obtém o posto de cada nível de retenção
+	int p = (nrowA < ncolA) ? nrowA : ncolA;
+	float retain[] = {0.8, 0.6, 0.4, 0.2};
+	int nlevels = sizeof(retain) / sizeof(float);
+	fcompressdata stats[sizeof(retain) / sizeof(float)];
 	flops_ = 0;
-	fcompress(pS, pU, pV, nrowA, ncolA, 0.2, & pnS, & pnU, & pnV, & stats);
-	printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats . antes . rank, stats . depois . rank, stats . antes . ncond, stats . depois . ncond, stats . antes . max,stats . depois . max, stats . antes . min, stats . depois . min, stats . antes . sum, stats . depois . sum);
-	rank = stats . depois . rank;
-	pA = fgemm(pnU, nrowA, rank, pnS, rank, rank);
-	pB = ftranspose(pnV, ncolA, rank);
-	pC = fgemm(pA, nrowA, rank, pB, rank, ncolA);
-	// Grava em disco
-	printf("Número de operações para a compressão: %lld. \n", flops_);
-	printf("Gravando a matriz... \n");
-	fsavemat("ra2", pC, nrowA, ncolA, false);
-	free(pnS);
-	free(pnU);
-	free(pnV);
-	free(pA);
-	free(pB);
+	int * pord = fsvdordem(pS, p, retain, nlevels, stats);
+	// Reconstrói cada nível a partir do anterior, subtraindo apenas os termos descartados
+	float * pC = (float *) calloc(nrowA * ncolA, sizeof(float));
+	if (pC == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolA);
+		exit(7);
+		}
+	int rank = 0;
+	for (int l = 0; l < nlevels; ++ l) {
+		printf("Compressão da matriz para %.0f%% dos valores singulares... \n", 100 * retain[l]);
+		printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats[l] . antes . rank, stats[l] . depois . rank, stats[l] . antes . ncond, stats[l] . depois . ncond, stats[l] . antes . max,stats[l] . depois . max, stats[l] . antes . min, stats[l] . depois . min, stats[l] . antes . sum, stats[l] . depois . sum);
+		fsvdupdate(pC, pS, pU, pV, nrowA, ncolA, p, pord, rank, stats[l] . depois . rank);
+		rank = stats[l] . depois . rank;
+		printf("Número de operações para a compressão: %lld. \n", flops_);
+		// Grava em disco, em texto ou, conforme BIN_RA, no formato binário
+		char fname[16];
+		int nivel = (int) (10 * retain[l] + 0.5);
+		sprintf(fname, (BIN_RA) ? "ra%d.fmb" : "ra%d", nivel);
+		printf("Gravando a matriz... \n");
+		if (fsavemat(fname, pC, nrowA, ncolA, false, BIN_RA) != 0) {
+			printf("Não conseguiu gravar o arquivo %s! \n", fname);
+			exit(4);
+			}
+		// Grava também apenas os fatores, em formato binário
+		flowrank lr;
+		flrcreate(pS, pU, pV, nrowA, ncolA, p, pord, rank, & lr);
+		sprintf(fname, "ra%d.flr", nivel);
+		if (flrsave(fname, & lr) != 0) {
+			printf("Não conseguiu gravar o arquivo %s! \n", fname);
+			exit(4);
+			}
+		if (debuglevel_ >= 1) {
+			// Confere as operações sobre os fatores com as mesmas operações sobre a reconstrução densa
+			long long int flops0 = flops_;
+			int nb = 4;
+			float * px = frandn(1, ncolA, l + 1);
+			float * pxt = frandn(1, nrowA, l + 1);
+			float * pB = frandn(ncolA, nb, l + 1);
+			float * py = (float *) malloc(nrowA * sizeof(float));
+			float * pyt = (float *) malloc(ncolA * sizeof(float));
+			float * pdt = (float *) malloc(ncolA * sizeof(float));
+			if (py == NULL || pyt == NULL || pdt == NULL) {
+				printf("Não conseguiu alocar memória para o vetor %d! \n", nrowA + 2 * ncolA);
+				exit(7);
+				}
+			foplowrank(px, py, & lr);
+			flrmatvec(& lr, pxt, pyt, true);
+			float * pCB = flrmatmat(& lr, pB, nb);
+			float * pd = fmmult(pC, nrowA, ncolA, px, ncolA, 1);
+			float * pdB = fmmult(pC, nrowA, ncolA, pB, ncolA, nb);
+			cblas_sgemv(CblasRowMajor, CblasTrans, nrowA, ncolA, 1, pC, ncolA, pxt, 1, 0, pdt, 1);
+			float difv = 0, dift = 0, difm = 0, dife = 0;
+			for (int i = 0; i < nrowA; ++ i) {
+				float dif = fabs(py[i] - pd[i]);
+				difv = (dif > difv) ? dif : difv;
+				for (int j = 0; j < nb; ++ j) {
+					dif = fabs(pCB[i * nb + j] - pdB[i * nb + j]);
+					difm = (dif > difm) ? dif : difm;
+					}
+				for (int j = i % 7; j < ncolA; j += 7) {
+					dif = fabs(flrelem(& lr, i, j) - pC[i * ncolA + j]);
+					dife = (dif > dife) ? dif : dife;
+					}
+				}
+			for (int j = 0; j < ncolA; ++ j) {
+				float dif = fabs(pyt[j] - pdt[j]);
+				dift = (dif > dift) ? dif : dift;
+				}
+			printf("Operações sobre os fatores. Diferença máxima: %g (A x), %g (A^T x), %g (A B), %g (elementos) \n", difv, dift, difm, dife);
+			free(px);
+			free(pxt);
+			free(pB);
+			free(py);
+			free(pyt);
+			free(pdt);
+			free(pCB);
+			free(pd);
+			free(pdB);
+			flops_ = flops0;
+			}
+		flrfree(& lr);
+		if (debuglevel_ >= 1) {
+			// Confere os fatores gravados com a reconstrução incremental, percorrendo a matriz por blocos de linhas
+			float maxdif = 0;
+			float * prow = (float *) malloc(NB_LINHAS * ncolA * sizeof(float));
+			if (prow == NULL || flrload(fname, & lr) != 0) {
+				exit(4);
+				}
+			for (int i = 0; i < nrowA; i += NB_LINHAS) {
+				int nr = (nrowA - i < NB_LINHAS) ? nrowA - i : NB_LINHAS;
+				flrrows(& lr, i, nr, prow);
+				for (int j = 0; j < nr * ncolA; ++ j) {
+					float dif = fabs(prow[j] - pC[i * ncolA + j]);
+					maxdif = (dif > maxdif) ? dif : maxdif;
+					}
+				}
+			printf("Fatores gravados em %s: %d x %d, posto %d. Diferença máxima: %g \n", fname, lr . nrows, lr . ncols, lr . rank, maxdif);
+			free(prow);
+			flrfree(& lr);
+			}
+		flops_ = 0;
+		}
+	free(pord);
 	free(pC);
 	return;
 	}
@@ -1010,9 +1250,7 @@ void execprob21(int size) {
 // Executa o problema número '21' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém o ponto por interpolação de Hermite
 	flops_ = 0;
 	float y = finterpH(pAf, nrowA, ncolA);
@@ -1024,9 +1262,7 @@ void execprob22(int size) {
 // Executa o problema número '22' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém o ponto por spline cúbico
 	flops_ = 0;
 	float y = finterpS(pAf, nrowA, ncolA);
@@ -1041,9 +1277,7 @@ void execprob23(int size) {
 // Executa o problema número '23' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém o ponto por extrapolação
 	flops_ = 0;
 	float y = finterpL(pAf, nrowA, ncolA);
@@ -1061,9 +1295,7 @@ void execprob24(int size) {
 // Executa o problema número '24' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("B", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("B", size, & nrowA, & ncolA);
 	// Obtém o ponto por interpolação de Neville
 	flops_ = 0;
 	float y = finterpN(pAf, nrowA, ncolA);
@@ -1075,9 +1307,7 @@ void execprob25(int size) {
 // Executa o problema número '25' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("E", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("E", size, & nrowA, & ncolA);
 	flops_ = 0;
 	// Ajusta a curva aos dados
 	float * coef = fajust(pAf, nrowA - 1, ncolA);
@@ -1094,9 +1324,7 @@ void execprob26(int size) {
 // Executa o problema número '26' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("F", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("F", size, & nrowA, & ncolA);
 	flops_ = 0;
 	// Calcula a derivada por diversios métodos
 	float * derivada = fderivP(pAf, nrowA, ncolA);
@@ -1125,9 +1353,7 @@ void execprob27(int size) {
 // Executa o problema número '27' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA;
-	double * pAd = lermat("F", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("F", size, & nrowA, & ncolA);
 	// Calcula a integral por diversos métodos
 	float xi = pAf[0], xf = pAf[(nrowA - 1) * ncolA]; 
 	int nsteps = 100;
@@ -1153,9 +1379,7 @@ void execprob28(int size) {
 // Executa o problema número '28' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("F", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("F", size, & nrowA, & ncolA);
 	// Calcula a derivada de diversas ordens
 	flops_ = 0;
 	float * derivada = fderivT(pAf, nrowA, ncolA, 2);	
@@ -1179,9 +1403,7 @@ void execprob29(int size) {
 // Executa o problema número '29' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("H", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("H", size, & nrowA, & ncolA);
 	// Calcula as integrais
 	float ek, fk, x = pAf[0];	
 	int grau = pAf[1];
@@ -1203,9 +1425,7 @@ void execprob30(int size) {
 // Executa o problema número '30' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("G", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("G", size, & nrowA, & ncolA);
 	// Calcula a indutância por diversos métodos
 	static const char * Formula[] = {
 		"do artigo", "simplificada", "literal"
@@ -1235,9 +1455,7 @@ void execprob31(int size) {
 // Executa o problema número '31' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("E", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("E", size, & nrowA, & ncolA);
 	// Calcula o período médio
 	flops_ = 0;
 	float T = fperiod(pAf, nrowA, ncolA);	
@@ -1249,9 +1467,7 @@ void execprob32(int size) {
 // Executa o problema número '32' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("E", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("E", size, & nrowA, & ncolA);
 	// Cria novas variáveis que são potências de 'x'
 	flops_ = 0;
 	int grau;
@@ -1272,9 +1488,7 @@ void execprob33(int size) {
 // Executa o problema número '33' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("I", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("I", size, & nrowA, & ncolA);
 	// Calcula a integral dupla pelo método de Newton-Cotes
 	for (int i = 1; i < 2; ++ i) {
 		for (int j = 1; j < 2; ++ j) {
@@ -1341,9 +1555,7 @@ void execprob35(int size) {
 // Executa o problema número '35' com o tamanho 'size' indicado.
 	// Lê a especificação do capacitor coaxial
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("G", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("G", size, & nrowA, & ncolA);
 	float ri = pAf[0], re = pAf[1], Vi = pAf[2], Vf = pAf[3];
 	// Monta a tabela com os valores do potencial V(r)
 	int nrows = 101, ncols = 2;
@@ -1368,9 +1580,7 @@ void execprob36(int size) {
 // Executa o problema número '36' com o tamanho 'size' indicado.
 	// Lê a tabela de pontos de entrada
 	int nrowA, ncolA, nrowB, ncolB;
-	double * pAd = lermat("E", size, & nrowA, & ncolA);
-	// Cria versões em diversas precisões
-	float * pAf = fmcopy(pAd, nrowA, ncolA);
+	float * pAf = flermat("E", size, & nrowA, & ncolA);
 	// Calcula o valor do ponto
 	float x = pAf[(nrowA - 1) * ncolA + 1];
 	init_fgenpol(pAf, nrowA - 1, ncolA, 3);
@@ -1379,282 +1589,800 @@ void execprob36(int size) {
 	return;
 	}
 
-	
-// Funções especiais
-float findut(int n, float h, float r, float d, int formula, ModoIntegr modo, int grau, int steps) {
-// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas
-	switch (formula) {
-		case 0: // conforme o artigo
-			return findutA(n, h, r, d, modo, grau, steps);
-		case 1: // fórmula simplificada
-			return findutS(n, h, r, d, modo, grau, steps);
-		case 2: // fórmula literal
-			return findutL(n, h, r, d, modo, grau, steps);
-		default:
-			printf("Fórmula inválida para o cálculo! \n");
-			exit(17);
+void execprob37(int size) {
+// Executa o problema número '37' com o tamanho 'size' indicado.
+	// Lê o sistema de entrada
+	int nrowA, ncolA;
+	float * pAf = flermat("D", size, & nrowA, & ncolA);
+	// Verifica se pode ser resolvido
+	if (ncolA != nrowA + 1) {
+		printf("O sistema não podem ser resolvido, porque as dimensões são incompatíveis: (%d x %d)! \n", nrowA, ncolA);
+		exit(5);
 		}
-	return 0; // Nunca
-	}
-
-float findutA(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
-// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula do artigo.
-	#define MU0				(0.4 * PI)
-	#define MEIOEXP_025		(0.5 * exp(-0.25))
-	float b1b2 = d * MEIOEXP_025;
-	float step = h / n;
-	float z2 = 0.5 * step;
-	float z2_b1b2 = z2 - b1b2;
-	float z2__b1b2 = z2 - b1b2;
-	float doisr = 2 * r, doisr2 = doisr * doisr;
-	flops_ += 6 + FLOPS_DIV;
-	float sum = 0, z1 = z2, ek, fk;
-	for (int i = 0; i < n; ++ i) {
-		float b = z1 - z2__b1b2;
-		float valor = doisr / sqrt(doisr2 + b * b);
-		flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
-		felipintN(valor, & ek, & fk, modo, grau, steps);
-		// printf("felipintN(%f) = %f, %f \n", valor, ek, fk);
-		float doisinvvalor = 2 / valor;
-		float turn1 = - ((valor - doisinvvalor) * fk + (doisinvvalor * ek));
-		flops_ += 4 + FLOPS_DIV;
-		if (i == 0) {
-			sum = n * turn1;
-			++ flops_;
-			}
-		else {
-			float b = z1 - z2_b1b2;
-			float valor = doisr / sqrt(doisr2 + b * b);
-			flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
-			felipintN(valor, & ek, & fk, modo, grau, steps);
-			// printf("felipintN(%f) = %f, %f \n", valor, ek, fk);
-			float doisinvvalor = 2 / valor;
-			float turn2 = - ((valor - doisinvvalor) * fk + (doisinvvalor * ek));
-			sum += (n - i) * (turn1 + turn2);
-			flops_ += 6 + FLOPS_DIV;
+	// Resolve pelo método iterativo de Jacobi assíncrono
+	float * pX;
+	int niter;
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = fsolveJA(pAf, nrowA, & pX, & niter);
+	ucrono(false, 1);
+	printf("Número de operações necessário para resolver o sistema: %lld. Varreduras: %d. Threads: %d. \n", flops_, niter, omp_get_max_threads());	
+	if (retcode != 0) {
+		// A divergência (12) já é relatada por fsolveJA
+		if (retcode == 11) {
+			printf("O método não convergiu em %d varreduras! \n", niter);
 			}
-		z1 += step;
-		++ flops_;
+		free(pAf);
+		free(pX);
+		return;
 		}
-	++ flops_;
-	return MU0 * r * sum;
-	#undef MU0
-	#undef MEIOEXP_025
+	flops_ = 0;
+	// Calcula e relata a norma 2 dos resultados
+	calcn2(pX, NULL, NULL, nrowA, 1);
+	return;
 	}
-	
-float findutL(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
-// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula literal (integral dupla)
-	#define MU0				0.1
-	float dist = h / n;
-	flops_ += FLOPS_DIV;
-	float result = 0;
-	for (int espira1 = 0; espira1 < n; ++ espira1) {
-		for (int espira2 = 0; espira2 < n; ++ espira2) {
-			float b = (espira2 - espira1) * dist;
-			++ flops_;
-			float mutua;
-			init_fdindut(r, r, 0, b, d , steps);
-			if (modo == 0) {
-				mutua = finteg2Nf(fdindut2, 0, DOISPI, 0, DOISPI, grau, steps, grau, steps);
-				}
-			else {
-				mutua = finteg2Gf(fdindut2, 0, DOISPI, 0, DOISPI, grau, steps, grau, steps);
-				}
-			result += mutua;
-			++ flops_;
-			}
+
+void execprob38(int size) {
+// Executa o problema número '38' com o tamanho 'size' indicado.
+	// Lê o sistema de entrada
+	int nrowA, ncolA;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	// Encontra os autovalores e autovetores pelo método de Jacobi paralelo e relata o esforço computacional necessário
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	if (! fissym(pAf, nrowA, nrowA)) {
+		printf("A matriz não é simétrica! \n");
+		exit(13);
 		}
-	++ flops_;
-	return MU0 * result;
-	#undef MU0
+	float * pav, * pmav;
+	int niter;
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = fmavJP(pAf, nrowA, nrowA, & pav , & niter);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("O método não convergiu em %d varreduras! \n", niter);
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pav, nrowA, 1, "Autovalores");
+		}
+	printf("Número de operações: %lld. Varreduras: %d. Threads: %d. \n", flops_, niter, omp_get_max_threads());
+	free(pAf);
+	free(pav);
+	pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	flops_ = 0;
+	ucrono(false, 0);
+	retcode = fmavJP(pAf, nrowA, nrowA, & pav , & niter, & pmav);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("O método não convergiu em %d varreduras! \n", niter);
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pav, nrowA, 1, "Autovalores");
+		fshowmat(pmav, nrowA, nrowA, "Autovetores");
+		}
+	printf("Número de operações: %lld. Varreduras: %d. \n", flops_, niter);	
+	return;
 	}
 
-float findutS(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
-// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula simplificada (integral simples)
-	#define MU0				0.1
-	float dist = h / n;
-	flops_ += FLOPS_DIV;
-	float result = 0;
-	for (int espira1 = 0; espira1 < n; ++ espira1) {
-		for (int espira2 = 0; espira2 < n; ++ espira2) {
-			float b = (espira2 - espira1) * dist;
-			++ flops_;
-			float mutua;
-			init_fdindut(r, r, 0, b, d, steps);
-			if (modo == 0) {
-				mutua = fintegGf(fdindut1, 0, DOISPI, grau, steps);
-				}
-			else {
-				mutua = fintegNf(fdindut1, 0, DOISPI, grau, steps);
-				}
-			result += mutua;
-			++ flops_;
-			}
+void execprob39(int size) {
+// Executa o problema número '39' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada
+	int nrowA, ncolA;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	if (! fissym(pAf, nrowA, nrowA)) {
+		printf("A matriz não é simétrica! \n");
+		exit(13);
 		}
-	++ flops_;
-	return MU0 * result;
-	#undef MU0
-	}
-
-void felipintN(float x, float * pek, float * pfk, ModoIntegr modo, int grau, int nsteps) {
-// Calcula as integrais elípiticas de 0 a PI/2 para o parâmetro 'x' usando o método de Newton-Cotes
-	elipticdata_ . first = true;
-	elipticdata_ . x = x;
-	float ek, fk;
-	if (modo == NewtonCotes) {
-		ek = fintegNf(felipx, 0, PISOBRE2, grau, nsteps);
-		fk = fintegNf(finvelipx, 0, PISOBRE2, grau, nsteps);
+	// Encontra os autovalores extremos pela iteração em subespaço e relata o esforço computacional necessário
+	int nav = (NAV_DEF < nrowA) ? NAV_DEF : nrowA;
+	float * pmax, * pmin, * pvmax, * pvmin;
+	int niter[2];
+	long long int flops[2];
+	flops_ = 0;
+	int retcode = fmavS(pAf, nrowA, nrowA, nav, true, & pmax, & pvmax, niter);
+	flops[0] = flops_;
+	flops_ = 0;
+	int retcode2 = fmavS(pAf, nrowA, nrowA, nav, false, & pmin, & pvmin, niter + 1);
+	flops[1] = flops_;
+	printf("Número de operações para cálculo dos autovalores extremos: %lld e %lld. Iterações: %d e %d \n", flops[1], flops[0], niter[1], niter[0]);	
+	// Só relata os autovalores que convergiram
+	if (retcode != 0) {
+		printf("O método não convergiu para os maiores autovalores em %d iterações! \n", niter[0]);
 		}
 	else {
-		ek = fintegGf(felipx, 0, PISOBRE2, grau, nsteps);
-		fk = fintegGf(finvelipx, 0, PISOBRE2, grau, nsteps);		
-		}
-	* pek = ek;
-	* pfk = fk;
-	return;
-	}
-	
-float felipx(float phi) {
-// Calcula a função elípitica direta para o ângulo 'phi'
-	if (elipticdata_ . first) {
-		float x = elipticdata_ . x;
-		elipticdata_ . x2 = x * x;
-		elipticdata_ . phi = MAIORQUEDOISPI;
-		elipticdata_ . first = false;
-		++ flops_;
+		fshowmat(pmax, 1, nav, "Maiores autovalores:");
 		}
-	float valor;
-	if (elipticdata_ . phi != phi) {
-		float sinphi = sin(phi);
-		float sin2phi = sinphi * sinphi;
-		valor = sqrt(1 - elipticdata_ . x2 * sin2phi);
-		elipticdata_ . valor = valor;
-		elipticdata_ . phi = phi;
-		flops_ += 3 + FLOPS_SQRT + FLOPS_SIN;
+	if (retcode2 != 0) {
+		printf("O método não convergiu para os menores autovalores em %d iterações! \n", niter[1]);
 		}
 	else {
-		valor = elipticdata_ . valor;
+		fshowmat(pmin, 1, nav, "Menores autovalores:");
 		}
-	return valor;
+	if (debuglevel_ >= 2) {
+		fshowmat(pvmax, nrowA, nav, "Autovetores dominantes");
+		fshowmat(pvmin, nrowA, nav, "Autovetores dos menores autovalores");
+		}
+	if (retcode == 0 && retcode2 == 0) {
+		printf("Número de condição: %f \n", pmax[0] / pmin[0]);
+		}
+	return;
 	}
 
-float finvelipx(float phi) {
-// Calcula a função elípitica inversa para o ângulo 'phi'
-	if (elipticdata_ . first) {
-		float x = elipticdata_ . x;
-		elipticdata_ . x2 = x * x;
-		elipticdata_ . phi = MAIORQUEDOISPI;
-		elipticdata_ . first = false;
-		++ flops_;
+void execprob40(int size) {
+// Executa o problema número '40' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada e armazena-a em formato esparso
+	int nrowA, ncolA;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	if (! fissym(pAf, nrowA, nrowA)) {
+		printf("A matriz não é simétrica! \n");
+		exit(13);
 		}
-	float valor;
-	if (elipticdata_ . phi != phi) {
-		float sinphi = sin(phi);
-		float sin2phi = sinphi * sinphi;
-		valor = sqrt(1 - elipticdata_ . x2 * sin2phi);
-		elipticdata_ . valor = valor;
-		elipticdata_ . phi = phi;
-		flops_ += 3 + FLOPS_SQRT + FLOPS_SIN;
+	fcsrmat csr;
+	fm2csr(pAf, nrowA, nrowA, & csr);
+	printf("Elementos não nulos: %d de %d \n", csr.nnz, nrowA * nrowA);
+	// Encontra os autovalores extremos pelo método de Lanczos e relata o esforço computacional necessário
+	int nav = (NAV_DEF < nrowA) ? NAV_DEF : nrowA;
+	float * pmax, * pmin, * pvmax, * pvmin;
+	int nmult[2];
+	long long int flops[2];
+	flops_ = 0;
+	int retcode = fmavL(fopcsr, & csr, nrowA, nav, true, & pmax, & pvmax, nmult);
+	flops[0] = flops_;
+	// Os menores autovalores (em módulo) são os maiores de A^-1, aplicada por uma única decomposição LU (inversão espectral)
+	flops_ = 0;
+	float * psys = (float *) malloc(nrowA * (nrowA + 1) * sizeof(float));
+	if (psys == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, nrowA + 1);
+		exit(7);
+		}
+	for (int i = 0; i < nrowA; ++ i) {
+		memcpy(psys + i * (nrowA + 1), pAf + i * nrowA, nrowA * sizeof(float));
+		psys[i * (nrowA + 1) + nrowA] = 0;
+		}
+	fLUmat lu;
+	lu.n = nrowA;
+	f2LU(psys, nrowA, & lu.pL, & lu.pU, & lu.pP, NULL);
+	free(psys);
+	int retcode2 = fmavL(fopLU, & lu, nrowA, nav, true, & pmin, & pvmin, nmult + 1, true);
+	for (int i = 0; i < nav; ++ i) {
+		pmin[i] = 1 / pmin[i];
+		}
+	flops[1] = flops_;
+	printf("Número de operações para cálculo dos autovalores extremos: %lld e %lld. Produtos matriz-vetor: %d e %d \n", flops[1], flops[0], nmult[1], nmult[0]);	
+	// Só relata os autovalores que convergiram
+	if (retcode != 0) {
+		printf("O método não convergiu para os maiores autovalores após %d produtos! \n", nmult[0]);
 		}
 	else {
-		valor = elipticdata_ . valor;
+		fshowmat(pmax, 1, nav, "Maiores autovalores:");
 		}
-	flops_ += FLOPS_DIV;
-	return 1.0 / valor;
-	}
-	
-float fperiod(float * pmat, int nrows, int ncols) {
-// Calcula o período médio da função dada pela tabela
-	float firstx, lastx;
-	int nchanges = 0;
-	bool lastsignal = pmat[1] > 0;
-	for (int i = 1; i < nrows; ++ i) {
-		bool signal = pmat[i * ncols + 1] > 0;
-		if (signal != lastsignal) {
-			float x = pmat[i * ncols];
-			if (nchanges == 0) {
-				firstx = x;
-				printf("Primeiro: %f", firstx);
-				}
-			++ nchanges;
-			lastx = x;
-			lastsignal = signal;
-			printf("Último: %f", lastx);
-			}
+	if (retcode2 != 0) {
+		printf("O método não convergiu para os menores autovalores após %d produtos! \n", nmult[1]);
 		}
-	flops_ += 2 + FLOPS_DIV;
-	return 2 * (lastx - firstx) / nchanges;
+	else {
+		fshowmat(pmin, 1, nav, "Menores autovalores:");
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pvmax, nrowA, nav, "Autovetores dos maiores autovalores");
+		fshowmat(pvmin, nrowA, nav, "Autovetores dos menores autovalores");
+		}
+	free(lu.pL);
+	free(lu.pU);
+	free(lu.pP);
+	return;
 	}
 
-float fsinx__y(float x, float y) {
-// Calcula sin(x+y)
-	flops_ += 1 + FLOPS_SIN;
-	return sin(x + y);
+void execprob41(int size) {
+// Executa o problema número '41' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada
+	int nrowA, ncolA;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	if (! fissym(pAf, nrowA, nrowA)) {
+		printf("A matriz não é simétrica! \n");
+		exit(13);
+		}
+	// Encontra os autovalores e autovetores por dividir e conquistar e relata o esforço computacional necessário
+	float * pav, * pmav;
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = fmavDC(pAf, nrowA, nrowA, & pav, & pmav);
+	ucrono(false, 1);
+	printf("Número de operações: %lld. \n", flops_);
+	if (retcode != 0) {
+		printf("O método não convergiu! \n");
+		return;
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pav, nrowA, 1, "Autovalores");
+		fshowmat(pmav, nrowA, nrowA, "Autovetores");
+		}
+	printf("Menor e maior autovalor: %f e %f \n", pav[0], pav[nrowA - 1]);
+	return;
 	}
 
-void init_fdindut(float r1, float r2, float phi1, float b, float d, int nsteps) {
-// Inicializa a estrutura para o cálculo de fdindut
-	bool calcr1r2 = false;
-	if (r1 != fdindutdata_ . r1) {
-		fdindutdata_ . r1 = r1;
-		fdindutdata_ . r1r1 = r1 * r1;
-		++ flops_;
-		calcr1r2 = true;
+void execprob42(int size) {
+// Executa o problema número '42' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada e a especificação do intervalo e dos índices procurados
+	int nrowA, ncolA, nrowB, ncolB;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	double * pBd = lermat("J", 1, & nrowB, & ncolB);
+	if (nrowB * ncolB < 4) {
+		printf("A especificação deve conter o intervalo e os índices: [a b il iu]! \n");
+		exit(5);
 		}
-	if (r2 != fdindutdata_ . r2) {
-		fdindutdata_ . r2 = r2;
-		fdindutdata_ . r2r2 = r2 * r2;
-		++ flops_;
-		calcr1r2 = true;
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	if (! fissym(pAf, nrowA, nrowA)) {
+		printf("A matriz não é simétrica! \n");
+		exit(13);
 		}
-	if (calcr1r2) {
-		fdindutdata_ . r1r2 = r1 * r2;
-		++ flops_;		
+	float a = pBd[0], b = pBd[1];
+	int il = pBd[2], iu = pBd[3];
+	il = (il < 1) ? 1 : il;
+	iu = (iu > nrowA) ? nrowA : iu;
+	// Reduz à forma tridiagonal e isola os autovalores pedidos por bissecção
+	float * pd, * pe, * pQ, * pav;
+	int nav;
+	flops_ = 0;
+	f2tridiag(pAf, nrowA, nrowA, & pd, & pe, & pQ);
+	printf("Número de operações para a redução à forma tridiagonal: %lld. \n", flops_);
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = fmavB(pd, pe, nrowA, a, b, 0, -1, & pav, & nav);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("Não conseguiu isolar os autovalores do intervalo! \n");
+		return;
 		}
-	bool calcb2 = false;
-	if (b != fdindutdata_ . b) {
-		fdindutdata_ . b = b;
-		fdindutdata_ . b2 = b * b;
-		++ flops_ ;
-		calcb2 = true;
+	printf("Autovalores em [%f, %f): %d. Número de operações: %lld. \n", a, b, nav, flops_);
+	if (nav > 0) {
+		fshowmat(pav, 1, nav, "Autovalores no intervalo:");
 		}
-	if (calcb2 || calcr1r2) {
-		fdindutdata_ . r1r1__r2r2__b2 = fdindutdata_ . r1r1 + fdindutdata_ . r2r2 + fdindutdata_ . b2;
-		flops_ += 3;	
+	free(pav);
+	flops_ = 0;
+	retcode = fmavB(pd, pe, nrowA, 0, 0, il - 1, iu - 1, & pav, & nav);
+	if (retcode != 0) {
+		printf("Não conseguiu isolar os autovalores selecionados! \n");
+		return;
 		}
-	if (d != fdindutdata_ . d) {
-		fdindutdata_ . d = d;
-		float l = DOISPI * r1 / nsteps;
-		fdindutdata_ . self = l * (log(l/d) - 0.75);
-		flops_ += 3 + FLOPS_DIV + FLOPS_LOG; 
+	printf("Autovalores de índices %d a %d. Número de operações: %lld. \n", il, iu, flops_);
+	fshowmat(pav, 1, nav, "Autovalores selecionados:");
+	// Autovetores dos autovalores selecionados por iteração inversa na forma tridiagonal
+	float * pmav;
+	int niter;
+	flops_ = 0;
+	retcode = finviterT(pd, pe, nrowA, pav, nav, pQ, & pmav, & niter);
+	printf("Número de operações para encontrar os autovetores: %lld. Iterações: %d. \n", flops_, niter);
+	if (retcode != 0) {
+		printf("A iteração inversa não convergiu em %d iterações! \n", niter);
+		}
+	else if (debuglevel_ >= 2) {
+		fshowmat(pmav, nrowA, nav, "Autovetores selecionados");
 		}
-	fdindutdata_ . phi1 = phi1;
 	return;
 	}
-	
-float fdindut1(float phi2) {
-// Calcula a indutância mútua entre dois segmentos circulares de raios 'r1' e 'r2' distantes 'b' e localizados nas coordenadas polares 'phi1' e 'phi2'
-	if (phi2 == fdindutdata_ . phi1 && fdindutdata_ . b == 0) {
-		return fdindutdata_ . self;
+
+
+void execprob43(int size) {
+// Executa o problema número '43' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada e a especificação da decomposição truncada
+	int nrowA, ncolA, nrowB, ncolB;
+	float * pAf = flermat("A", size, & nrowA, & ncolA);
+	double * pBd = lermat("K", 1, & nrowB, & ncolB);
+	if (nrowB * ncolB < 3) {
+		printf("A especificação deve conter o posto, a energia e as iterações de potência: [k e q]! \n");
+		exit(5);
 		}
-	float r1r2 = fdindutdata_ . r1r2;
-	float r1r1__r2r2__b2 = fdindutdata_ . r1r1__r2r2__b2;
-	float phi1_phi2 = fdindutdata_ . phi1 - phi2;
-	++ flops_ ;
-	float cosphi1_phi2 = cos(phi1_phi2);
-	flops_ += FLOPS_SIN;
-	float r1r2cosphi1_phi2 = r1r2 * cosphi1_phi2;
-	flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
-	return r1r2cosphi1_phi2 / sqrt(r1r1__r2r2__b2 - 2 * r1r2cosphi1_phi2);
+	int rank = pBd[0], npot = pBd[2];
+	float energia = pBd[1];
+	// Decompõe a matriz na forma SVD truncada por projeção aleatória
+	float * pS, * pU, * pV;
+	int k;
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = f2SVDR(pAf, nrowA, ncolA, rank, energia, npot, & pS, & pU, & pV, & k);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("Não conseguiu fazer a decomposição! \n");
+		}
+	printf("Posto obtido: %d. Número de operações para a decomposição: %lld. \n", k, flops_);
+	if (debuglevel_ >= 2) {
+		fshowmat(pU, nrowA, k, "U");
+		fshowmat(pV, ncolA, k, "V");		
+		}
+	// Reconstrói a matriz e compara as normas
+	float * pA = fgemm(pU, nrowA, k, pS, k, k);
+	float * pB = ftranspose(pV, ncolA, k);
+	float * pC = fgemm(pA, nrowA, k, pB, k, ncolA);
+	calcn2(pAf, NULL, NULL, nrowA, ncolA);
+	calcn2(pC, NULL, NULL, nrowA, ncolA);
+	free(pA);
+	free(pB);
+	free(pC);
+	// Comprime a decomposição truncada para 80% dos valores singulares obtidos
+	float * pnS, * pnU, * pnV;
+	fcompressdata stats;
+	flops_ = 0;
+	fcompress(pS, pU, pV, nrowA, ncolA, 0.8, & pnS, & pnU, & pnV, & stats, k);
+	printf("Rank: %d -> %d. Número de condicionamento: %f -> %f. Max.: %f -> %f. Min.: %f -> %f. Sum.: %f -> %f \n", stats . antes . rank, stats . depois . rank, stats . antes . ncond, stats . depois . ncond, stats . antes . max,stats . depois . max, stats . antes . min, stats . depois . min, stats . antes . sum, stats . depois . sum);
+	free(pnS);
+	free(pnU);
+	free(pnV);
+	return;
 	}
 
-float fdindut2(float phi1, float phi2) {
-	if (phi2 == phi1 && fdindutdata_ . b == 0) {
-		return fdindutdata_ . self;
+void execprob44(int size) {
+// Executa o problema número '44' com o tamanho 'size' indicado.
+	// Decompõe a matriz na forma SVD lendo-a por blocos de linhas
+	float * pS, * pV;
+	int nrowA, ncolA, k;
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = f2SVDS("A", size, 0, "us", & pS, & pV, & nrowA, & ncolA, & k);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("Não conseguiu fazer a decomposição! \n");
 		}
-	float r1r2 = fdindutdata_ . r1r2;
-	float r1r1__r2r2__b2 = fdindutdata_ . r1r1__r2r2__b2;
-	float phi1_phi2 = phi1 - phi2;
+	printf("Matriz %d x %d, posto %d. Número de operações para a decomposição: %lld. \n", nrowA, ncolA, k, flops_);
+	float max = pS[0], min = pS[(k - 1) * k + k - 1];
+	printf("Valores singulares: max.: %f, min.: %f. Número de condicionamento: %f. \n", max, min, max / min);
+	if (debuglevel_ >= 2) {
+		fshowmat(pS, k, k, "S");
+		fshowmat(pV, ncolA, k, "V");
+		}
+	free(pS);
+	free(pV);
+	return;
+	}
+
+void execprob45(int size) {
+// Executa o problema número '45' com o tamanho 'size' indicado.
+	// Lê a imagem de entrada, PFM ou, se não houver, PGM
+	char name[FNAME_MAX_SIZE + 1], fname[FNAME_MAX_SIZE + 1];
+	sprintf(name, "im%d.pfm", size);
+	FILE * fp = fopen(name, "rb");
+	bool pfm = fp != NULL;
+	if (pfm) {
+		fclose(fp);
+		}
+	else {
+		sprintf(name, "im%d.pgm", size);
+		}
+	int nrowA, ncolA;
+	float * pAf = lerimg(name, & nrowA, & ncolA);
+	if (debuglevel_ >= 1) {
+		// Verificação: peça de posto deficiente (colunas saturadas e linhas nulas) em que o critério de parada anterior de fsvdJ,
+		// eps sqrt(m), não era atingido e a decomposição seguia com centenas de rotações por varredura até o limite de iterações
+		float * pT = (float *) malloc(NB_TILE * NB_TILE * sizeof(float));
+		if (pT == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", NB_TILE, NB_TILE);
+			exit(7);
+			}
+		for (int i = 0; i < NB_TILE; ++ i) {
+			for (int j = 0; j < NB_TILE; ++ j) {
+				pT[i * NB_TILE + j] = (j < 40 * NB_TILE / 64) ? 255 : (i < 20 * NB_TILE / 64) ? 0 : 100 + i;
+				}
+			}
+		float * pS, * pU, * pV;
+		int rc = f2SVD(pT, NB_TILE, NB_TILE, & pS, & pU, & pV);
+		printf("Verificação da decomposição de uma peça de posto deficiente: %s. \n", (rc == 0) ? "convergiu" : "NÃO CONVERGIU");
+		free(pT);
+		free(pS);
+		free(pU);
+		free(pV);
+		}
+	// Comprime por peças, mantendo 80% dos valores singulares de cada uma
+	float retain = 0.8;
+	int ranktot;
+	long long int nvals;
+	sprintf(fname, "im%d.flt", size);
+	flops_ = 0;
+	ucrono(true, 0);
+	int retcode = ftilecompress(pAf, nrowA, ncolA, NB_TILE, retain, fname, & ranktot, & nvals);
+	ucrono(false, 1);
+	if (retcode != 0) {
+		printf("Não conseguiu fazer a decomposição de todas as peças! \n");
+		}
+	printf("Imagem %d x %d em peças de %d x %d. Soma dos postos: %d. Valores gravados: %lld (%.1f%% do original). \n", nrowA, ncolA, NB_TILE, NB_TILE, 
+		ranktot, nvals, 100.0 * nvals / ((double) nrowA * ncolA));
+	printf("Número de operações para a compressão: %lld. \n", flops_);
+	// Descomprime, grava a imagem reconstruída e compara com a original
+	int nrowC, ncolC;
+	ucrono(true, 0);
+	float * pC = ftiledecompress(fname, & nrowC, & ncolC);
+	ucrono(false, 1);
+	sprintf(fname, "imr%d.%s", size, (pfm) ? "pfm" : "pgm");
+	fsaveimg(fname, pC, nrowC, ncolC, pfm);
+	float * pE = fmadd(pAf, nrowA, ncolA, pC, nrowC, ncolC, false);
+	printf("Erro relativo (norma de Frobenius): %f. \n", fmnorm2(pE, nrowA, ncolA) / fmnorm2(pAf, nrowA, ncolA));
+	free(pAf);
+	free(pC);
+	free(pE);
+	return;
+	}
+
+void execprob46(int size) {
+// Executa o problema número '46' com o tamanho 'size' indicado.
+	// Lê a matriz de entrada e a especificação da potência e do instante
+	int nrowA, ncolA, nrowB, ncolB;
+	float * pA = flermat("C", size, & nrowA, & ncolA);
+	double * pBd = lermat("P", 1, & nrowB, & ncolB);
+	if (nrowB * ncolB < 2 || pBd[0] < 0) {
+		printf("A especificação deve conter a potência (não negativa) e o instante: [p t]! \n");
+		exit(5);
+		}
+	float * pAf = fmsliceF(pA, nrowA, ncolA, nrowA, nrowA, 0, 0);
+	free(pA);
+	int pot = pBd[0];
+	float t = pBd[1];
+	// Potência inteira por quadrados sucessivos
+	flops_ = 0;
+	ucrono(true, 0);
+	float * pP = fpower(pAf, nrowA, nrowA, pot);
+	ucrono(false, 1);
+	printf("Número de operações para calcular A^%d: %lld. \n", pot, flops_);
+	calcn2(pP, NULL, NULL, nrowA, nrowA);
+	// Exponencial de t A
+	float * ptA = fmtimes(pAf, nrowA, nrowA, t);
+	flops_ = 0;
+	ucrono(true, 0);
+	float * pE = fexpm(ptA, nrowA, nrowA);
+	ucrono(false, 1);
+	printf("Número de operações para calcular e^(%f A): %lld. \n", t, flops_);
+	calcn2(pE, NULL, NULL, nrowA, nrowA);
+	free(pAf);
+	free(pP);
+	free(ptA);
+	free(pE);
+	return;
+	}
+	
+void execprob47(int size) {
+// Executa o problema número '47' com o tamanho 'size' indicado.
+	// Converte cada arquivo texto do MATLAB com esse tamanho que existir
+	static const char * nomes[] = {"A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "MatA", "MatB", "P", "S", "TI", "TS"};
+	int nconv = 0;
+	for (int i = 0; i < (int) (sizeof(nomes) / sizeof(nomes[0])); ++ i) {
+		char name[FNAME_MAX_SIZE + 1];
+		sprintf(name, "%s%d", nomes[i], size);
+		FILE * fp = fopen(name, "r");
+		if (fp == NULL) {
+			continue;
+			}
+		fclose(fp);
+		// A chave do arquivo texto, gravada no binário, permite a lerbin reconhecer uma versão desatualizada
+		long long int chave[3];
+		bool fonte = lerchave(name, chave, false);
+		int nrows, ncols;
+		double * pval;
+		lertexto(nomes[i], size, & nrows, & ncols, NULL, & pval, NULL);
+		strcat(name, ".fmb");
+		if (fsavebin(name, pval, nrows, ncols, (fonte) ? chave : NULL) != 0) {
+			printf("Não conseguiu gravar o arquivo %s! \n", name);
+			exit(4);
+			}
+		printf("Arquivo %s: %d x %d. \n", name, nrows, ncols);
+		free(pval);
+		++ nconv;
+		}
+	printf("Arquivos convertidos: %d. \n", nconv);
+	return;
+	}
+	
+void execprob48(int size) {
+// Executa o problema número '48' com o tamanho 'size' indicado.
+	// Abre os arquivos binários das matrizes de entrada, sem carregá-las
+	fmbfile mA, mB, mC;
+	fmbabre("MatA", size, & mA);
+	fmbabre("MatB", size, & mB);
+	// Verifica se podem ser multiplicadas
+	if (mA.ncols != mB.nrows || mA.nrows == 0 || mB.ncols == 0) {
+		printf("As matrizes não podem ser multiplicadas, porque as dimensões são incompatíveis: (%d x %d) e (%d x %d)! \n", mA.nrows, mA.ncols, mB.nrows, mB.ncols);
+		exit(5);
+		}
+	char name[FNAME_MAX_SIZE + 1];
+	sprintf(name, "MatC%d.fmb", size);
+	fmbcria(name, mA.nrows, mB.ncols, & mC);
+	// Peças quadradas, múltiplas de 64, tais que as seis em uso caibam em MEM_OOC
+	int nb = (int) sqrt(MEM_OOC * 1048576.0 / (6 * sizeof(float))) / 64 * 64;
+	int dmax = (mA.nrows > mA.ncols) ? mA.nrows : mA.ncols;
+	dmax = (mB.ncols > dmax) ? mB.ncols : dmax;
+	nb = (nb > dmax) ? dmax : ((nb < 64) ? 64 : nb);
+	printf("Multiplicando (%d x %d) por (%d x %d) fora da memória, por peças de %d x %d... \n", mA.nrows, mA.ncols, mB.nrows, mB.ncols, nb, nb);
+	flops_ = 0;
+	ucrono(true, 0);
+	double norma = foocmult(& mA, & mB, & mC, nb);
+	ucrono(false, 1);
+	printf("Número de operações: %lld. Norma de Frobenius do produto: %f. \n", flops_, norma);
+	fmbfecha(& mA);
+	fmbfecha(& mB);
+	fmbfecha(& mC);
+	printf("Produto gravado em %s. \n", name);
+	return;
+	}
+	
+// Funções especiais
+float findut(int n, float h, float r, float d, int formula, ModoIntegr modo, int grau, int steps) {
+// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas
+	switch (formula) {
+		case 0: // conforme o artigo
+			return findutA(n, h, r, d, modo, grau, steps);
+		case 1: // fórmula simplificada
+			return findutS(n, h, r, d, modo, grau, steps);
+		case 2: // fórmula literal
+			return findutL(n, h, r, d, modo, grau, steps);
+		default:
+			printf("Fórmula inválida para o cálculo! \n");
+			exit(17);
+		}
+	return 0; // Nunca
+	}
+
+float findutA(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
+// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula do artigo.
+	#define MU0				(0.4 * PI)
+	#define MEIOEXP_025		(0.5 * exp(-0.25))
+	float b1b2 = d * MEIOEXP_025;
+	float step = h / n;
+	float z2 = 0.5 * step;
+	float z2_b1b2 = z2 - b1b2;
+	float z2__b1b2 = z2 - b1b2;
+	float doisr = 2 * r, doisr2 = doisr * doisr;
+	flops_ += 6 + FLOPS_DIV;
+	float sum = 0, z1 = z2, ek, fk;
+	for (int i = 0; i < n; ++ i) {
+		float b = z1 - z2__b1b2;
+		float valor = doisr / sqrt(doisr2 + b * b);
+		flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
+		felipintN(valor, & ek, & fk, modo, grau, steps);
+		// printf("felipintN(%f) = %f, %f \n", valor, ek, fk);
+		float doisinvvalor = 2 / valor;
+		float turn1 = - ((valor - doisinvvalor) * fk + (doisinvvalor * ek));
+		flops_ += 4 + FLOPS_DIV;
+		if (i == 0) {
+			sum = n * turn1;
+			++ flops_;
+			}
+		else {
+			float b = z1 - z2_b1b2;
+			float valor = doisr / sqrt(doisr2 + b * b);
+			flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
+			felipintN(valor, & ek, & fk, modo, grau, steps);
+			// printf("felipintN(%f) = %f, %f \n", valor, ek, fk);
+			float doisinvvalor = 2 / valor;
+			float turn2 = - ((valor - doisinvvalor) * fk + (doisinvvalor * ek));
+			sum += (n - i) * (turn1 + turn2);
+			flops_ += 6 + FLOPS_DIV;
+			}
+		z1 += step;
+		++ flops_;
+		}
+	++ flops_;
+	return MU0 * r * sum;
+	#undef MU0
+	#undef MEIOEXP_025
+	}
+	
+float findutL(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
+// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula literal (integral dupla)
+	#define MU0				0.1
+	float dist = h / n;
+	flops_ += FLOPS_DIV;
+	float result = 0;
+	for (int espira1 = 0; espira1 < n; ++ espira1) {
+		for (int espira2 = 0; espira2 < n; ++ espira2) {
+			float b = (espira2 - espira1) * dist;
+			++ flops_;
+			float mutua;
+			init_fdindut(r, r, 0, b, d , steps);
+			if (modo == 0) {
+				mutua = finteg2Nf(fdindut2, 0, DOISPI, 0, DOISPI, grau, steps, grau, steps);
+				}
+			else {
+				mutua = finteg2Gf(fdindut2, 0, DOISPI, 0, DOISPI, grau, steps, grau, steps);
+				}
+			result += mutua;
+			++ flops_;
+			}
+		}
+	++ flops_;
+	return MU0 * result;
+	#undef MU0
+	}
+
+float findutS(int n, float h, float r, float d, ModoIntegr modo, int grau, int steps) {
+// Calcula a indutância, em microhenrys, de um solenóide de 'n' espiras, comprimento 'h', raio 'r', condutores de diâmetro 'd' pela soma das indutâncias mútuas, de acordo com a fórmula simplificada (integral simples)
+	#define MU0				0.1
+	float dist = h / n;
+	flops_ += FLOPS_DIV;
+	float result = 0;
+	for (int espira1 = 0; espira1 < n; ++ espira1) {
+		for (int espira2 = 0; espira2 < n; ++ espira2) {
+			float b = (espira2 - espira1) * dist;
+			++ flops_;
+			float mutua;
+			init_fdindut(r, r, 0, b, d, steps);
+			if (modo == 0) {
+				mutua = fintegGf(fdindut1, 0, DOISPI, grau, steps);
+				}
+			else {
+				mutua = fintegNf(fdindut1, 0, DOISPI, grau, steps);
+				}
+			result += mutua;
+			++ flops_;
+			}
+		}
+	++ flops_;
+	return MU0 * result;
+	#undef MU0
+	}
+
+void felipintN(float x, float * pek, float * pfk, ModoIntegr modo, int grau, int nsteps) {
+// Calcula as integrais elípiticas de 0 a PI/2 para o parâmetro 'x' usando o método de Newton-Cotes
+	elipticdata_ . first = true;
+	elipticdata_ . x = x;
+	float ek, fk;
+	if (modo == NewtonCotes) {
+		ek = fintegNf(felipx, 0, PISOBRE2, grau, nsteps);
+		fk = fintegNf(finvelipx, 0, PISOBRE2, grau, nsteps);
+		}
+	else {
+		ek = fintegGf(felipx, 0, PISOBRE2, grau, nsteps);
+		fk = fintegGf(finvelipx, 0, PISOBRE2, grau, nsteps);		
+		}
+	* pek = ek;
+	* pfk = fk;
+	return;
+	}
+	
+float felipx(float phi) {
+// Calcula a função elípitica direta para o ângulo 'phi'
+	if (elipticdata_ . first) {
+		float x = elipticdata_ . x;
+		elipticdata_ . x2 = x * x;
+		elipticdata_ . phi = MAIORQUEDOISPI;
+		elipticdata_ . first = false;
+		++ flops_;
+		}
+	float valor;
+	if (elipticdata_ . phi != phi) {
+		float sinphi = sin(phi);
+		float sin2phi = sinphi * sinphi;
+		valor = sqrt(1 - elipticdata_ . x2 * sin2phi);
+		elipticdata_ . valor = valor;
+		elipticdata_ . phi = phi;
+		flops_ += 3 + FLOPS_SQRT + FLOPS_SIN;
+		}
+	else {
+		valor = elipticdata_ . valor;
+		}
+	return valor;
+	}
+
+float finvelipx(float phi) {
+// Calcula a função elípitica inversa para o ângulo 'phi'
+	if (elipticdata_ . first) {
+		float x = elipticdata_ . x;
+		elipticdata_ . x2 = x * x;
+		elipticdata_ . phi = MAIORQUEDOISPI;
+		elipticdata_ . first = false;
+		++ flops_;
+		}
+	float valor;
+	if (elipticdata_ . phi != phi) {
+		float sinphi = sin(phi);
+		float sin2phi = sinphi * sinphi;
+		valor = sqrt(1 - elipticdata_ . x2 * sin2phi);
+		elipticdata_ . valor = valor;
+		elipticdata_ . phi = phi;
+		flops_ += 3 + FLOPS_SQRT + FLOPS_SIN;
+		}
+	else {
+		valor = elipticdata_ . valor;
+		}
+	flops_ += FLOPS_DIV;
+	return 1.0 / valor;
+	}
+	
+float fperiod(float * pmat, int nrows, int ncols) {
+// Calcula o período médio da função dada pela tabela
+	float firstx, lastx;
+	int nchanges = 0;
+	bool lastsignal = pmat[1] > 0;
+	for (int i = 1; i < nrows; ++ i) {
+		bool signal = pmat[i * ncols + 1] > 0;
+		if (signal != lastsignal) {
+			float x = pmat[i * ncols];
+			if (nchanges == 0) {
+				firstx = x;
+				printf("Primeiro: %f", firstx);
+				}
+			++ nchanges;
+			lastx = x;
+			lastsignal = signal;
+			printf("Último: %f", lastx);
+			}
+		}
+	flops_ += 2 + FLOPS_DIV;
+	return 2 * (lastx - firstx) / nchanges;
+	}
+
+float fsinx__y(float x, float y) {
+// Calcula sin(x+y)
+	flops_ += 1 + FLOPS_SIN;
+	return sin(x + y);
+	}
+
+void init_fdindut(float r1, float r2, float phi1, float b, float d, int nsteps) {
+// Inicializa a estrutura para o cálculo de fdindut
+	bool calcr1r2 = false;
+	if (r1 != fdindutdata_ . r1) {
+		fdindutdata_ . r1 = r1;
+		fdindutdata_ . r1r1 = r1 * r1;
+		++ flops_;
+		calcr1r2 = true;
+		}
+	if (r2 != fdindutdata_ . r2) {
+		fdindutdata_ . r2 = r2;
+		fdindutdata_ . r2r2 = r2 * r2;
+		++ flops_;
+		calcr1r2 = true;
+		}
+	if (calcr1r2) {
+		fdindutdata_ . r1r2 = r1 * r2;
+		++ flops_;		
+		}
+	bool calcb2 = false;
+	if (b != fdindutdata_ . b) {
+		fdindutdata_ . b = b;
+		fdindutdata_ . b2 = b * b;
+		++ flops_ ;
+		calcb2 = true;
+		}
+	if (calcb2 || calcr1r2) {
+		fdindutdata_ . r1r1__r2r2__b2 = fdindutdata_ . r1r1 + fdindutdata_ . r2r2 + fdindutdata_ . b2;
+		flops_ += 3;	
+		}
+	if (d != fdindutdata_ . d) {
+		fdindutdata_ . d = d;
+		float l = DOISPI * r1 / nsteps;
+		fdindutdata_ . self = l * (log(l/d) - 0.75);
+		flops_ += 3 + FLOPS_DIV + FLOPS_LOG; 
+		}
+	fdindutdata_ . phi1 = phi1;
+	return;
+	}
+	
+float fdindut1(float phi2) {
+// Calcula a indutância mútua entre dois segmentos circulares de raios 'r1' e 'r2' distantes 'b' e localizados nas coordenadas polares 'phi1' e 'phi2'
+	if (phi2 == fdindutdata_ . phi1 && fdindutdata_ . b == 0) {
+		return fdindutdata_ . self;
+		}
+	float r1r2 = fdindutdata_ . r1r2;
+	float r1r1__r2r2__b2 = fdindutdata_ . r1r1__r2r2__b2;
+	float phi1_phi2 = fdindutdata_ . phi1 - phi2;
+	++ flops_ ;
+	float cosphi1_phi2 = cos(phi1_phi2);
+	flops_ += FLOPS_SIN;
+	float r1r2cosphi1_phi2 = r1r2 * cosphi1_phi2;
+	flops_ += 3 + FLOPS_DIV + FLOPS_SQRT;
+	return r1r2cosphi1_phi2 / sqrt(r1r1__r2r2__b2 - 2 * r1r2cosphi1_phi2);
+	}
+
+float fdindut2(float phi1, float phi2) {
+	if (phi2 == phi1 && fdindutdata_ . b == 0) {
+		return fdindutdata_ . self;
+		}
+	float r1r2 = fdindutdata_ . r1r2;
+	float r1r1__r2r2__b2 = fdindutdata_ . r1r1__r2r2__b2;
+	float phi1_phi2 = phi1 - phi2;
 	++ flops_ ;
 	float cosphi1_phi2 = cos(phi1_phi2);
 	flops_ += FLOPS_SIN;
@@ -2504,370 +3232,1569 @@ float finterpSH(float * pA, int nrows, int ncols) {
     return q;	
 	}
 
-
-// Funções para cálculo de polinômios e multinômios
-float fcalcpol(float * coef, int ncols, float x) {
-// Calcula o valor de um polinômio pela fórmula a0 + x*(a1 + x*(a2 + x*(... (an-1 + x*an)
-	float soma = coef[ncols];
-	++ flops_;
-	for (int i = ncols; i > 0 ; -- i) {
-		soma = coef[i - 1] + x * soma;
-		flops_ += 2;
+
+// Funções para cálculo de polinômios e multinômios
+float fcalcpol(float * coef, int ncols, float x) {
+// Calcula o valor de um polinômio pela fórmula a0 + x*(a1 + x*(a2 + x*(... (an-1 + x*an)
+	float soma = coef[ncols];
+	++ flops_;
+	for (int i = ncols; i > 0 ; -- i) {
+		soma = coef[i - 1] + x * soma;
+		flops_ += 2;
+		}
+	if (debuglevel_ >= 3) {
+		printf(" [f(%f) = %f] ", x, soma);
+		}
+	return soma;
+	}
+	
+float fcalcmult(float * coef, int ncols, float * px) {
+// Calcula o valor de um multinômio
+	float soma = coef[ncols];
+	for (int i = ncols; i > 0; -- i) {
+		soma = coef[i - 1] * soma;
+		flops_ += 2;
+		}
+	return soma;
+	}
+	
+float fgenpol(float x) {
+// Calcula o valor correspondente a 'x' para o polinômio corrente.
+	float y = fcalcpol(genpoldata_ . coef,  genpoldata_ . grau + 1, x);
+	return y;
+	}
+
+void init_fgenpol(float * pmat, int nrows, int ncols, int grau) {
+// Inicializa a função fgenpol.
+	float * pA = (float *) malloc((nrows + 1) * ncols * sizeof(float));
+	if (pA == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %1! \n", nrows + 1);
+		exit(7);
+		}	
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			pA[i * ncols + j] = pmat[i * ncols + j];
+			}
+		}
+	pA[nrows * ncols] = grau;
+	float * ppol = fcriapol(pA, nrows + 1, ncols, & grau);
+	float * coef = fajust(ppol, nrows, grau + 1);
+	genpoldata_ . coef = coef;
+	genpoldata_ . grau = grau;
+	genpoldata_ . initialized = true;	
+	}
+
+	
+// Funções para decomposições SVD
+int fsvdJ(float * pG, int n, int m, float * pVt, int * psweeps) {
+// Ortogonaliza as 'n' linhas de G (n x m), que são as colunas da matriz original, pelo método de Jacobi unilateral (Hestenes).
+// Cada rotação combina duas linhas de G e as mesmas linhas de V^T (n x n, inicialmente a identidade); os pares de cada passo
+// seguem o torneio circular de fparesRR, são disjuntos e por isso tratados em paralelo.
+// Encerra quando todos os pares estão ortogonais, |g_p . g_q| <= tol ||g_p|| ||g_q||, com tol = m eps: as rotações são aplicadas em
+// precisão simples e um critério mais estrito (como eps sqrt(m)) pode não ser atingido. Pares com uma coluna desprezível frente à maior
+// (norma abaixo de tol vezes a maior norma) são ignorados, pois o seu produto interno é só ruído de arredondamento, como nas peças
+// de imagem de posto deficiente (ver a verificação do problema 45).
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número de varreduras.
+	int nrounds = n - 1 + (n & 1), retcode = 11, nsweeps;
+	int * pp = (int *) malloc(n * sizeof(int));
+	int * pq = (int *) malloc(n * sizeof(int));
+	if (pp == NULL || pq == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", 2 * n);
+		exit(7);
+		}
+	double tol = FLT_EPSILON * m;
+	for (nsweeps = 0; nsweeps < maxiter_; ++ nsweeps) {
+		int nrot = 0;
+		double maxnorm = 0;
+		for (int j = 0; j < n; ++ j) {
+			double norm = cblas_snrm2(m, pG + j * m, 1);
+			maxnorm = (norm > maxnorm) ? norm : maxnorm;
+			}
+		double mintol = tol * tol * maxnorm * maxnorm;
+		flops_ += (long long int) n * (2 * m + FLOPS_SQRT);
+		for (int round = 0; round < nrounds; ++ round) {
+			int npares = fparesRR(n, round, pp, pq);
+			#pragma omp parallel for reduction(+: nrot) schedule(dynamic, 1)
+			for (int k = 0; k < npares; ++ k) {
+				float * pgp = pG + pp[k] * m, * pgq = pG + pq[k] * m;
+				double alpha = 0, beta = 0, gamma = 0;
+				for (int i = 0; i < m; ++ i) {
+					alpha += (double) pgp[i] * pgp[i];
+					beta += (double) pgq[i] * pgq[i];
+					gamma += (double) pgp[i] * pgq[i];
+					}
+				if (fabs(gamma) <= tol * sqrt(alpha * beta) || gamma == 0 || alpha <= mintol || beta <= mintol) {
+					continue;
+					}
+				// Rotação que anula o produto interno das duas colunas
+				double zeta = (beta - alpha) / (2 * gamma);
+				double t = ((zeta >= 0) ? 1 : -1) / (fabs(zeta) + sqrt(1 + zeta * zeta));
+				float c = 1 / sqrt(1 + t * t), s = c * t;
+				for (int i = 0; i < m; ++ i) {
+					float gp = pgp[i], gq = pgq[i];
+					pgp[i] = c * gp - s * gq;
+					pgq[i] = s * gp + c * gq;
+					}
+				float * pvp = pVt + pp[k] * n, * pvq = pVt + pq[k] * n;
+				for (int i = 0; i < n; ++ i) {
+					float vp = pvp[i], vq = pvq[i];
+					pvp[i] = c * vp - s * vq;
+					pvq[i] = s * vp + c * vq;
+					}
+				++ nrot;
+				}
+			flops_ += (long long int) npares * (6 * m + 12 + 2 * FLOPS_SQRT + 2 * FLOPS_DIV);
+			}
+		flops_ += (long long int) nrot * 6 * (m + n);
+		if (debuglevel_ >= 1) {
+			printf("Varredura %d: %d rotações \n", nsweeps, nrot);
+			}
+		if (nrot == 0) {
+			retcode = 0;
+			break;
+			}
+		}
+	free(pp);
+	free(pq);
+	* psweeps = nsweeps;
+	return retcode;
+	}
+
+int f2SVD(float * pA, int nrows, int ncols, float ** ppS , float ** ppU, float ** ppV, bool completa) {
+// Calcula a decomposição SVD da matriz, A = U S V^T, pelo método de Jacobi unilateral aplicado diretamente às colunas de A
+// (ou de A^T, se houver mais colunas que linhas), sem formar A^T A, o que preservaria o quadrado do número de condição.
+// Por padrão, a decomposição é reduzida: com p = min(nrows, ncols), S é p x p, U é nrows x p e V é ncols x p.
+// Se 'completa', S é nrows x ncols e U e V são completadas até matrizes ortogonais quadradas.
+// Os valores singulares ficam em ordem decrescente. Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	bool transp = nrows < ncols;
+	int m = (transp) ? ncols : nrows, n = (transp) ? nrows : ncols;
+	// As linhas de G são as colunas da matriz processada (A ou A^T)
+	float * pG = (transp) ? (float *) malloc(m * n * sizeof(float)) : ftranspose(pA, nrows, ncols);
+	float * pVt = fident(n);
+	if (pG == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, m);
+		exit(7);
+		}
+	if (transp) {
+		memcpy(pG, pA, m * n * sizeof(float));
+		}
+	int nsweeps;
+	int retcode = fsvdJ(pG, n, m, pVt, & nsweeps);
+	// Valores singulares são as normas das colunas; ordena-os em ordem decrescente
+	float * psing = (float *) malloc(n * sizeof(float));
+	int * pord = (int *) malloc(n * sizeof(int));
+	if (psing == NULL || pord == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", 2 * n);
+		exit(7);
+		}
+	for (int j = 0; j < n; ++ j) {
+		psing[j] = cblas_snrm2(m, pG + j * m, 1);
+		pord[j] = j;
+		}
+	flops_ += (long long int) n * (2 * m + FLOPS_SQRT);
+	for (int i = 1; i < n; ++ i) {
+		int aux = pord[i], j;
+		for (j = i - 1; j >= 0 && psing[pord[j]] < psing[aux]; -- j) {
+			pord[j + 1] = pord[j];
+			}
+		pord[j + 1] = aux;
+		}
+	// Vetores singulares à esquerda (m x k) e à direita (n x k) da matriz processada, com k = n ou m se completa
+	int ku = (completa) ? m : n, kv = n;
+	float * pL = (float *) calloc(m * ku, sizeof(float));
+	float * pR = (float *) malloc(n * kv * sizeof(float));
+	if (pL == NULL || pR == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", m + n, ku);
+		exit(7);
+		}
+	for (int j = 0; j < n; ++ j) {
+		int col = pord[j];
+		float sing = psing[col], inv = (sing > 0) ? 1 / sing : 0;
+		for (int i = 0; i < m; ++ i) {
+			pL[i * ku + j] = pG[col * m + i] * inv;
+			}
+		for (int i = 0; i < n; ++ i) {
+			pR[i * kv + j] = pVt[col * n + i];
+			}
+		}
+	flops_ += (long long int) m * n + n * FLOPS_DIV;
+	if (completa && ku > n) {
+		// Completa a base ortonormal com as colunas da identidade que permanecem independentes
+		float * pW = (float *) calloc(m * (n + m), sizeof(float));
+		if (pW == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", m, n + m);
+			exit(7);
+			}
+		for (int i = 0; i < m; ++ i) {
+			memcpy(pW + i * (n + m), pL + i * ku, n * sizeof(float));
+			pW[i * (n + m) + n + i] = 1;
+			}
+		fmortho(pW, m, n + m);
+		for (int j = n, c = n; j < ku && c < n + m; ++ c) {
+			if (cblas_snrm2(m, pW + c, n + m) == 0) {
+				continue;
+				}
+			for (int i = 0; i < m; ++ i) {
+				pL[i * ku + j] = pW[i * (n + m) + c];
+				}
+			++ j;
+			}
+		free(pW);
+		}
+	// Matriz de valores singulares
+	int nrs = (completa) ? nrows : n, ncs = (completa) ? ncols : n;
+	float * pS = (float *) calloc(nrs * ncs, sizeof(float));
+	if (pS == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrs, ncs);
+		exit(7);
+		}
+	for (int j = 0; j < n; ++ j) {
+		pS[j * ncs + j] = psing[pord[j]];
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pS, nrs, ncs, "S");
+		}
+	free(pG);
+	free(pVt);
+	free(psing);
+	free(pord);
+	// Para A^T = L S R^T, A = R S L^T
+	* ppS = pS;
+	* ppU = (transp) ? pR : pL;
+	* ppV = (transp) ? pL : pR;
+	if (debuglevel_ >= 1) {
+		printf("Varreduras de Jacobi: %d \n", nsweeps);
+		}
+	return retcode;
+	}
+	
+int f2SVDR(float * pA, int nrows, int ncols, int rank, float energia, int npot, float ** ppS , float ** ppU, float ** ppV, int * prank) {
+// Calcula a decomposição SVD truncada, A ~ U S V^T, por projeção aleatória: a imagem de A é amostrada por A * Omega (Omega gaussiana),
+// refinada por 'npot' iterações de potência e ortonormalizada em Q; a SVD é calculada apenas para a matriz pequena B = Q^T A.
+// Se 'rank' > 0, procura os 'rank' maiores valores singulares, com NOVER_RSVD colunas a mais na amostra.
+// Caso contrário, amplia a amostra em blocos de NB_RSVD colunas até que ||B||_F^2 alcance a fração 'energia' de ||A||_F^2
+// e mantém os menores valores singulares cuja soma dos quadrados alcance essa fração (energia de Frobenius, e não a soma
+// dos valores singulares usada em fcompress).
+// O resultado é reduzido (S k x k, U nrows x k, V ncols x k) e pode ser passado diretamente a fcompress.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o posto 'k' obtido.
+	int p = (nrows < ncols) ? nrows : ncols;
+	int lmax = (rank > 0) ? ((rank + NOVER_RSVD < p) ? rank + NOVER_RSVD : p) : p;
+	int nb = (rank > 0) ? lmax : ((NB_RSVD < p) ? NB_RSVD : p);
+	double total = 0;
+	for (int i = 0; i < nrows * ncols; ++ i) {
+		total += (double) pA[i] * pA[i];
+		}
+	flops_ += 2 * nrows * ncols;
+	// Base Q (nrows x lmax) e linhas de B = Q^T A (lmax x ncols)
+	float * pQ = (float *) calloc(nrows * lmax, sizeof(float));
+	float * pB = (float *) malloc(lmax * ncols * sizeof(float));
+	float * pY = (float *) malloc(nrows * nb * sizeof(float));
+	float * pZ = (float *) malloc(ncols * nb * sizeof(float));
+	float * pC = (float *) malloc(lmax * nb * sizeof(float));
+	if (pQ == NULL || pB == NULL || pY == NULL || pZ == NULL || pC == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows + ncols, lmax);
+		exit(7);
+		}
+	int l = 0;
+	double capt = 0;
+	while (l < lmax) {
+		int b = (nb < lmax - l) ? nb : lmax - l;
+		float * pOmega = frandn(ncols, b, 1 + l);
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nrows, b, ncols, 1, pA, ncols, pOmega, b, 0, pY, b);
+		free(pOmega);
+		flops_ += 2LL * nrows * ncols * b;
+		// Iterações de potência, com ortonormalização a cada produto para não perder os valores singulares menores
+		for (int it = 0; it <= npot; ++ it) {
+			// Remove as componentes já contidas em Q, em duas passagens
+			for (int pass = 0; pass < 2 && l > 0; ++ pass) {
+				cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, l, b, nrows, 1, pQ, lmax, pY, b, 0, pC, b);
+				cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nrows, b, l, -1, pQ, lmax, pC, b, 1, pY, b);
+				flops_ += 4LL * nrows * l * b;
+				}
+			fmortho(pY, nrows, b);
+			if (it == npot) {
+				break;
+				}
+			cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, ncols, b, nrows, 1, pA, ncols, pY, b, 0, pZ, b);
+			fmortho(pZ, ncols, b);
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nrows, b, ncols, 1, pA, ncols, pZ, b, 0, pY, b);
+			flops_ += 4LL * nrows * ncols * b;
+			}
+		for (int i = 0; i < nrows; ++ i) {
+			memcpy(pQ + i * lmax + l, pY + i * b, b * sizeof(float));
+			}
+		// Novas linhas de B = Y^T A
+		cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, b, ncols, nrows, 1, pY, b, pA, ncols, 0, pB + l * ncols, ncols);
+		flops_ += 2LL * nrows * ncols * b;
+		for (int i = l * ncols; i < (l + b) * ncols; ++ i) {
+			capt += (double) pB[i] * pB[i];
+			}
+		l += b;
+		if (debuglevel_ >= 1) {
+			printf("Amostra: %d colunas, energia capturada: %f \n", l, (total > 0) ? capt / total : 1);
+			}
+		if (rank <= 0 && capt >= energia * total) {
+			break;
+			}
+		}
+	free(pY);
+	free(pZ);
+	free(pC);
+	// SVD da matriz pequena: B = Ub S V^T, U = Q Ub
+	float * pSb, * pUb, * pVb;
+	int retcode = f2SVD(pB, l, ncols, & pSb, & pUb, & pVb);
+	free(pB);
+	int k;
+	if (rank > 0) {
+		k = (rank < l) ? rank : l;
+		}
+	else {
+		double acum = 0;
+		for (k = 0; k < l && acum < energia * total; ++ k) {
+			acum += (double) pSb[k * l + k] * pSb[k * l + k];
+			}
+		k = (k > 0) ? k : 1;
+		}
+	float * pU = (float *) malloc(nrows * k * sizeof(float));
+	float * pS = (float *) calloc(k * k, sizeof(float));
+	float * pV = (float *) malloc(ncols * k * sizeof(float));
+	if (pU == NULL || pS == NULL || pV == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows + ncols + k, k);
+		exit(7);
+		}
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nrows, k, l, 1, pQ, lmax, pUb, l, 0, pU, k);
+	flops_ += 2LL * nrows * l * k;
+	for (int j = 0; j < k; ++ j) {
+		pS[j * k + j] = pSb[j * l + j];
+		}
+	for (int i = 0; i < ncols; ++ i) {
+		memcpy(pV + i * k, pVb + i * l, k * sizeof(float));
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pS, k, k, "S");
+		}
+	free(pQ);
+	free(pSb);
+	free(pUb);
+	free(pVb);
+	* ppS = pS;
+	* ppU = pU;
+	* ppV = pV;
+	* prank = k;
+	return retcode;
+	}
+	
+int f2SVDS(const char * fname, int size, int rank, const char * fnameU, float ** ppS, float ** ppV, int * pnrows, int * pncols, int * prank) {
+// Calcula a decomposição SVD, A = U S V^T, de uma matriz alta lida do arquivo 'fname''size' por blocos de linhas, sem carregá-la
+// inteira na memória. Cada bloco é empilhado sob o fator R acumulado e a pilha é reduzida de novo a R por QR (TSQR sequencial);
+// ao final, a SVD de R (ncols x ncols) fornece S e V, pois A = Q R.
+// Mantém os 'rank' maiores valores singulares (ou todos, se 'rank' <= 0), no máximo min(nrows, ncols), e descarta os que não
+// passam de eps sigma_1 max(nrows, ncols), numericamente nulos, antes de formar U: S é k x k e V é ncols x k.
+// Se 'fnameU' não for NULL, uma segunda leitura do arquivo calcula U = A V S^-1, bloco a bloco, e a grava nesse arquivo.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	fmatfile mf;
+	lercabec(fname, size, & mf);
+	int nrows = mf.nrows, ncols = mf.ncols;
+	int n = ncols, nb = (NB_LINHAS > n) ? NB_LINHAS : n;
+	// Pilha: R (n x n) seguida do bloco de linhas (nb x n), lido diretamente em precisão simples
+	float * pW = (float *) calloc((n + nb) * n, sizeof(float));
+	if (pW == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n + nb, n);
+		exit(7);
+		}
+	fmatprec dst = {pW + n * n, NULL, NULL};
+	for (int ini = 0; ini < nrows; ini += nb) {
+		int nr = (nrows - ini < nb) ? nrows - ini : nb;
+		lerlinhas(& mf, nr, & dst);
+		fqrR(pW, n + nr, n);
+		}
+	lerfecha(& mf);
+	if (debuglevel_ >= 2) {
+		fshowmat(pW, n, n, "R");
+		}
+	// SVD do fator triangular: R = Ur S V^T
+	float * pSr, * pUr, * pVr;
+	int retcode = f2SVD(pW, n, n, & pSr, & pUr, & pVr);
+	free(pW);
+	free(pUr);
+	// Numa matriz larga, R tem no máximo nrows linhas não nulas
+	int p = (nrows < n) ? nrows : n;
+	int k = (rank > 0 && rank < p) ? rank : p;
+	float tol = FLT_EPSILON * pSr[0] * ((nrows > n) ? nrows : n);
+	while (k > 1 && pSr[(k - 1) * n + k - 1] <= tol) {
+		-- k;
+		}
+	float * pS = (float *) calloc(k * k, sizeof(float));
+	float * pV = (float *) malloc(n * k * sizeof(float));
+	if (pS == NULL || pV == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", n + k, k);
+		exit(7);
+		}
+	for (int j = 0; j < k; ++ j) {
+		pS[j * k + j] = pSr[j * n + j];
+		}
+	for (int i = 0; i < n; ++ i) {
+		memcpy(pV + i * k, pVr + i * n, k * sizeof(float));
+		}
+	free(pSr);
+	free(pVr);
+	if (fnameU != NULL) {
+		// Segunda leitura: U = A V S^-1, bloco a bloco
+		lercabec(fname, size, & mf);
+		FILE * fu = fopen(fnameU, "w");
+		float * pB = (float *) malloc(nb * n * sizeof(float));
+		float * pUb = (float *) malloc(nb * k * sizeof(float));
+		if (fu == NULL) {
+			printf("Não conseguiu abrir o arquivo %s! \n", fnameU);
+			exit(4);
+			}
+		if (pB == NULL || pUb == NULL) {
+			printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nb, n + k);
+			exit(7);
+			}
+		fsavecabec(fu, fnameU, nrows, k);
+		fmatprec dstB = {pB, NULL, NULL};
+		for (int ini = 0; ini < nrows; ini += nb) {
+			int nr = (nrows - ini < nb) ? nrows - ini : nb;
+			lerlinhas(& mf, nr, & dstB);
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nr, k, n, 1, pB, n, pV, k, 0, pUb, k);
+			for (int j = 0; j < k; ++ j) {
+				float sing = pS[j * k + j], inv = (sing > 0) ? 1 / sing : 0;
+				cblas_sscal(nr, inv, pUb + j, k);
+				}
+			flops_ += 2LL * nr * n * k + (long long int) nr * k;
+			if (fsavelinhas(fu, pUb, nr, k) != 0) {
+				break;
+				}
+			}
+		if (ferror(fu) || fclose(fu) != 0) {
+			printf("Não conseguiu gravar o arquivo %s! \n", fnameU);
+			exit(4);
+			}
+		lerfecha(& mf);
+		free(pB);
+		free(pUb);
+		}
+	* ppS = pS;
+	* ppV = pV;
+	* pnrows = nrows;
+	* pncols = ncols;
+	* prank = k;
+	return retcode;
+	}
+	
+int ftilecompress(float * pA, int nrows, int ncols, int tile, float retain, const char * fname, int * pranktot, long long int * pnvals) {
+// Divide a matriz em peças de 'tile' x 'tile' (menores nas bordas) e comprime cada uma, em paralelo, por sua própria SVD, mantendo
+// os maiores valores singulares até somar a fração 'retain' do total da peça. Os fatores de cada peça são gravados no arquivo
+// binário 'fname': FLT_MAGIC, nrows, ncols e tile (int), seguidos das peças, por linhas de peças, no formato de flrwrite.
+// Informa a soma dos postos das peças e o número de valores gravados.
+// As operações de cada peça são contadas pela thread que a trata e somadas ao final.
+	int ntr = (nrows + tile - 1) / tile, ntc = (ncols + tile - 1) / tile, ntiles = ntr * ntc;
+	flowrank * ptiles = (flowrank *) malloc(ntiles * sizeof(flowrank));
+	if (ptiles == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", ntiles);
+		exit(7);
+		}
+	int retcode = 0, ranktot = 0;
+	long long int nvals = 0, flops = 0;
+	#pragma omp parallel for schedule(dynamic, 1) reduction(+: ranktot, nvals, flops) reduction(max: retcode)
+	for (int t = 0; t < ntiles; ++ t) {
+		long long int flops0 = flops_;
+		int i0 = (t / ntc) * tile, j0 = (t % ntc) * tile;
+		int tr = (nrows - i0 < tile) ? nrows - i0 : tile, tc = (ncols - j0 < tile) ? ncols - j0 : tile;
+		int p = (tr < tc) ? tr : tc;
+		float * pT = (float *) malloc(tr * tc * sizeof(float));
+		if (pT == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", tr, tc);
+			exit(7);
+			}
+		for (int i = 0; i < tr; ++ i) {
+			memcpy(pT + i * tc, pA + (i0 + i) * ncols + j0, tc * sizeof(float));
+			}
+		float * pS, * pU, * pV;
+		int rc = f2SVD(pT, tr, tc, & pS, & pU, & pV);
+		if (rc != 0) {
+			retcode = rc;
+			}
+		fcompressdata stats;
+		int * pord = fsvdordem(pS, p, & retain, 1, & stats);
+		flrcreate(pS, pU, pV, tr, tc, p, pord, stats . depois . rank, ptiles + t);
+		ranktot += stats . depois . rank;
+		nvals += (long long int) (tr + tc + 1) * stats . depois . rank;
+		free(pord);
+		free(pT);
+		free(pS);
+		free(pU);
+		free(pV);
+		flops += flops_ - flops0;
+		flops_ = flops0;
+		}
+	flops_ += flops;
+	FILE * fp = fopen(fname, "wb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
+		exit(4);
+		}
+	int dims[3] = {nrows, ncols, tile};
+	fwrite(FLT_MAGIC, 1, 4, fp);
+	fwrite(dims, sizeof(int), 3, fp);
+	for (int t = 0; t < ntiles; ++ t) {
+		flrwrite(fp, ptiles + t);
+		flrfree(ptiles + t);
+		}
+	int erro = ferror(fp);
+	if (fclose(fp) != 0 || erro) {
+		printf("Não conseguiu gravar o arquivo %s! \n", fname);
+		exit(4);
+		}
+	free(ptiles);
+	* pranktot = ranktot;
+	* pnvals = nvals;
+	return retcode;
+	}
+
+float * ftiledecompress(const char * fname, int * pnrows, int * pncols) {
+// Lê o arquivo de peças gravado por ftilecompress e reconstrói a matriz, com as peças calculadas em paralelo.
+	FILE * fp = fopen(fname, "rb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
+		exit(4);
 		}
-	if (debuglevel_ >= 3) {
-		printf(" [f(%f) = %f] ", x, soma);
+	char magic[4];
+	int dims[3];
+	if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, FLT_MAGIC, 4) != 0 || fread(dims, sizeof(int), 3, fp) != 3 
+		|| dims[0] <= 0 || dims[1] <= 0 || dims[2] <= 0) {
+		printf("O arquivo %s não contém uma matriz comprimida por peças! \n", fname);
+		fclose(fp);
+		exit(5);
 		}
-	return soma;
-	}
-	
-float fcalcmult(float * coef, int ncols, float * px) {
-// Calcula o valor de um multinômio
-	float soma = coef[ncols];
-	for (int i = ncols; i > 0; -- i) {
-		soma = coef[i - 1] * soma;
-		flops_ += 2;
+	int nrows = dims[0], ncols = dims[1], tile = dims[2];
+	int ntr = (nrows + tile - 1) / tile, ntc = (ncols + tile - 1) / tile, ntiles = ntr * ntc;
+	flowrank * ptiles = (flowrank *) malloc(ntiles * sizeof(flowrank));
+	float * pA = (float *) malloc(nrows * ncols * sizeof(float));
+	if (ptiles == NULL || pA == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
 		}
-	return soma;
+	for (int t = 0; t < ntiles; ++ t) {
+		int tr = (nrows - (t / ntc) * tile < tile) ? nrows - (t / ntc) * tile : tile;
+		int tc = (ncols - (t % ntc) * tile < tile) ? ncols - (t % ntc) * tile : tile;
+		if (flrread(fp, ptiles + t) != 0 || ptiles[t] . nrows != tr || ptiles[t] . ncols != tc) {
+			printf("O arquivo %s está incompleto! \n", fname);
+			fclose(fp);
+			exit(4);
+			}
+		}
+	fclose(fp);
+	long long int flops = 0;
+	#pragma omp parallel for schedule(dynamic, 1) reduction(+: flops)
+	for (int t = 0; t < ntiles; ++ t) {
+		long long int flops0 = flops_;
+		int i0 = (t / ntc) * tile, j0 = (t % ntc) * tile;
+		int tr = ptiles[t] . nrows, tc = ptiles[t] . ncols;
+		float * pT = (float *) malloc(tr * tc * sizeof(float));
+		if (pT == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", tr, tc);
+			exit(7);
+			}
+		flrrows(ptiles + t, 0, tr, pT);
+		for (int i = 0; i < tr; ++ i) {
+			memcpy(pA + (i0 + i) * ncols + j0, pT + i * tc, tc * sizeof(float));
+			}
+		free(pT);
+		flrfree(ptiles + t);
+		flops += flops_ - flops0;
+		flops_ = flops0;
+		}
+	flops_ += flops;
+	free(ptiles);
+	* pnrows = nrows;
+	* pncols = ncols;
+	return pA;
 	}
-	
-float fgenpol(float x) {
-// Calcula o valor correspondente a 'x' para o polinômio corrente.
-	float y = fcalcpol(genpoldata_ . coef,  genpoldata_ . grau + 1, x);
-	return y;
+
+int fcmpsing(const void * pa, const void * pb) {
+// Compara dois valores singulares para ordenação decrescente
+	float a = ((const fsingdata *) pa) -> val, b = ((const fsingdata *) pb) -> val;
+	return (a < b) ? 1 : ((a > b) ? -1 : 0);
 	}
 
-void init_fgenpol(float * pmat, int nrows, int ncols, int grau) {
-// Inicializa a função fgenpol.
-	float * pA = (float *) malloc((nrows + 1) * ncols * sizeof(float));
-	if (pA == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %1! \n", nrows + 1);
+int * fsvdordem(float * pS, int p, float * pretain, int nlevels, fcompressdata * pstats) {
+// Ordena uma única vez os 'p' valores singulares da diagonal de S (p x p) em ordem decrescente e, por somas acumuladas,
+// obtém o posto de cada um dos 'nlevels' níveis de retenção: o menor número de valores singulares cuja soma alcança a fração
+// 'pretain[i]' do total. Preenche as estatísticas de cada nível e retorna a ordem (índices) dos valores singulares.
+	fsingdata * psing = (fsingdata *) malloc(p * sizeof(fsingdata));
+	int * pord = (int *) malloc(p * sizeof(int));
+	if (psing == NULL || pord == NULL) {	
+		printf("Não conseguiu alocar memória para o vetor %d! \n", 2 * p);
+		exit(7);
+		}	
+	float sum = 0;
+	for (int i = 0; i < p; ++ i) {
+		psing[i] . val = pS[i * p + i];
+		psing[i] . pos = i;
+		sum += psing[i] . val;
+		}
+	flops_ += p;
+	qsort(psing, p, sizeof(fsingdata), fcmpsing);
+	for (int i = 0; i < p; ++ i) {
+		pord[i] = psing[i] . pos;
+		}
+	float max = psing[0] . val, min = psing[p - 1] . val;
+	for (int l = 0; l < nlevels; ++ l) {
+		float limit = pretain[l] * sum, acum = 0;
+		int rank;
+		for (rank = 0; acum < limit && rank < p; ++ rank) {
+			acum += psing[rank] . val;
+			}
+		flops_ += 1 + rank;
+		fcompressdata * pst = pstats + l;
+		pst -> antes . rank = p;
+		pst -> antes . max = max;
+		pst -> antes . min = min;
+		pst -> antes . ncond = max / min;
+		pst -> antes . sum = sum;
+		pst -> depois . rank = rank;
+		pst -> depois . max = max;
+		pst -> depois . min = (rank > 0) ? psing[rank - 1] . val : 0;
+		pst -> depois . ncond = pst -> depois . max / pst -> depois . min;
+		pst -> depois . sum = acum;
+		flops_ += 2 * FLOPS_DIV;
+		}
+	free(psing);
+	return pord;
+	}
+
+void fsvdupdate(float * pC, float * pS, float * pU, float * pV, int nrows, int ncols, int p, int * pord, int k0, int k1) {
+// Leva a reconstrução C (nrows x ncols) do posto 'k0' ao posto 'k1', somando (k1 > k0) ou subtraindo (k1 < k0) o bloco
+// de termos sigma_j u_j v_j^T correspondentes, na ordem 'pord', por um único produto de matrizes.
+	int ini = (k0 < k1) ? k0 : k1, nb = (k0 < k1) ? k1 - k0 : k0 - k1;
+	if (nb == 0) {
+		return;
+		}
+	float * pW = (float *) malloc(nrows * nb * sizeof(float));
+	float * pZ = (float *) malloc(ncols * nb * sizeof(float));
+	if (pW == NULL || pZ == NULL) {	
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows + ncols, nb);
 		exit(7);
 		}	
 	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			pA[i * ncols + j] = pmat[i * ncols + j];
+		for (int j = 0; j < nb; ++ j) {
+			int celem = pord[ini + j];
+			pW[i * nb + j] = pU[i * p + celem] * pS[celem * p + celem];
 			}
 		}
-	pA[nrows * ncols] = grau;
-	float * ppol = fcriapol(pA, nrows + 1, ncols, & grau);
-	float * coef = fajust(ppol, nrows, grau + 1);
-	genpoldata_ . coef = coef;
-	genpoldata_ . grau = grau;
-	genpoldata_ . initialized = true;	
+	for (int i = 0; i < ncols; ++ i) {
+		for (int j = 0; j < nb; ++ j) {
+			pZ[i * nb + j] = pV[i * p + pord[ini + j]];
+			}
+		}
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, nrows, ncols, nb, (k1 > k0) ? 1 : -1, pW, nb, pZ, nb, 1, pC, ncols);
+	flops_ += (long long int) nrows * nb + 2LL * nrows * ncols * nb;
+	free(pW);
+	free(pZ);
 	}
 
+void fcompress(float * pS, float * pU, float * pV, int nrows, int ncols, float retain, float ** ppnS, float ** ppnU, float ** ppnV, fcompressdata * pstats, int nsing) {
+// Mantém os maiores valores singulares da decomposição reduzida (S p x p, U nrows x p, V ncols x p, p = min(nrows, ncols),
+// ou p = 'nsing' para uma decomposição truncada) até somar a fração 'retain' do total.
+	int p = (nsing > 0) ? nsing : ((nrows < ncols) ? nrows : ncols);
+	int * pick = fsvdordem(pS, p, & retain, 1, pstats);
+	int rank = pstats -> depois . rank;
+	float * pnU = (float *) malloc(nrows * rank * sizeof(float));
+	float * pnS = (float *) calloc(rank * rank, sizeof(float));
+	float * pnV = (float *) malloc(ncols * rank * sizeof(float));
+	if (pnU == NULL || pnS == NULL || pnV == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 3 * rank);
+		exit(7);
+		}	
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			int celem = pick[j];
+			pnU[i * rank + j] = pU[i * p + celem];
+			}
+		}
+	for (int i = 0; i < ncols; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			int celem = pick[j];
+			pnV[i * rank + j] = pV[i * p + celem];
+			}
+		}
+	for (int j = 0; j < rank; ++ j) {
+		int celem = pick[j];
+		pnS[j * rank + j] = pS[celem * p + celem];
+		}
+	free(pick);
+	* ppnS = pnS;
+	* ppnU = pnU;
+	* ppnV = pnV;
+	return; 
+	}
 	
-// Funções para decomposições SVD
-int f2SVD(float * pA, int nrows, int ncols, float ** ppS , float ** ppU, float ** ppV) {
-// Calcula a decomposição SVD de uma matriz
-	float * mav = NULL;
-	float * psys = (float *) calloc(ncols * (ncols + 1), sizeof(float));
-	float * pw = (float *) malloc(nrows * sizeof(float));
-	float * pwaux = (float *) calloc(nrows, sizeof(float));
-	float * paux = (float *) malloc(ncols * sizeof(float));
-	float * pU = (float *) malloc(nrows * nrows * sizeof(float));
-	float * pS = (float *) calloc(nrows * ncols, sizeof(float));
-	if (psys == NULL || pw == NULL || pU == NULL || pS == NULL || paux == NULL) {
-		printf("Não conseguiu alocar memória para as matrizes! \n");
+	
+// Funções para cálculo de autovalores por métodos iterativos
+int ftql(float * pd, float * pe, int n, float * pZ, int ldz) {
+// Calcula autovalores e autovetores da matriz tridiagonal simétrica (diagonal 'pd', subdiagonal 'pe') pelo método QL implícito.
+// Os autovalores substituem 'pd' e os autovetores são gravados nas colunas de 'pZ', que deve conter a matriz de transformação inicial.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	float * pe2 = (float *) malloc((n + 1) * sizeof(float));
+	if (pe2 == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", n + 1);
 		exit(7);
 		}
-	float * pAt = ftranspose(pA, nrows, ncols);
-	float * pmat = fgemm(pAt, ncols, nrows, pA, nrows, ncols);
-	free(pAt);
-	// Calcula os autovalores e autovetores pelo método de Jacobi
-	int niter;
-	float * pav;
-	int retcode = fmavJ(pmat, ncols, ncols, & pav , & niter, & mav);
+	memcpy(pe2, pe, (n - 1) * sizeof(float));
+	pe2[n - 1] = 0;
+	for (int l = 0; l < n; ++ l) {
+		int m, iter = 0;
+		do {
+			for (m = l; m < n - 1; ++ m) {
+				float dd = fabs(pd[m]) + fabs(pd[m + 1]);
+				if (fabs(pe2[m]) <= FLT_EPSILON * dd) {
+					break;
+					}
+				}
+			if (m != l) {
+				if (iter ++ == 30) {
+					free(pe2);
+					return 11;
+					}
+				float g = (pd[l + 1] - pd[l]) / (2 * pe2[l]);
+				float r = sqrt(g * g + 1);
+				g = pd[m] - pd[l] + pe2[l] / (g + copysign(r, g));
+				float s = 1, c = 1, p = 0;
+				int i;
+				for (i = m - 1; i >= l; -- i) {
+					float f = s * pe2[i], b = c * pe2[i];
+					pe2[i + 1] = r = sqrt(f * f + g * g);
+					if (r == 0) {
+						pd[i + 1] -= p;
+						pe2[m] = 0;
+						break;
+						}
+					s = f / r;
+					c = g / r;
+					g = pd[i + 1] - p;
+					r = (pd[i] - g) * s + 2 * c * b;
+					pd[i + 1] = g + (p = s * r);
+					g = c * r - b;
+					for (int k = 0; k < n; ++ k) {
+						f = pZ[k * ldz + i + 1];
+						pZ[k * ldz + i + 1] = s * pZ[k * ldz + i] + c * f;
+						pZ[k * ldz + i] = c * pZ[k * ldz + i] - s * f;
+						}
+					flops_ += 6 * n + 20 + FLOPS_SQRT + 2 * FLOPS_DIV;
+					}
+				if (r == 0 && i >= l) {
+					continue;
+					}
+				pd[l] -= p;
+				pe2[l] = g;
+				pe2[m] = 0;
+				}
+			} while (m != l);
+		}
+	free(pe2);
+	return 0;
+	}
+
+int ftridiagDC(float * pd, float * pe, int n, float * pZ, int ldz) {
+// Calcula autovalores e autovetores da matriz tridiagonal simétrica pelo método de dividir e conquistar de Cuppen.
+// A matriz é separada em dois blocos mais uma correção de posto um, T = diag(T1, T2) + rho v v^T; os blocos são resolvidos
+// recursivamente (abaixo de NDC_MIN, pelo método QL) e os resultados combinados pela equação secular, resolvida em precisão dupla.
+// Os autovetores de D + rho z z^T usam o z recalculado de Gu-Eisenstat, o que mantém a ortogonalidade sem reortogonalização.
+// Os autovalores substituem 'pd', fora de ordem, e os autovetores são gravados nas colunas correspondentes de 'pZ'.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	if (n <= NDC_MIN) {
+		for (int i = 0; i < n; ++ i) {
+			for (int j = 0; j < n; ++ j) {
+				pZ[i * ldz + j] = (i == j);
+				}
+			}
+		return ftql(pd, pe, n, pZ, ldz);
+		}
+	int m = n / 2;
+	float beta = pe[m - 1], rho = fabs(beta), sgn = (beta >= 0) ? 1 : -1;
+	pd[m - 1] -= rho;
+	pd[m] -= rho;
+	for (int i = 0; i < m; ++ i) {
+		for (int j = m; j < n; ++ j) {
+			pZ[i * ldz + j] = pZ[j * ldz + i] = 0;
+			}
+		}
+	int retcode = ftridiagDC(pd, pe, m, pZ, ldz);
+	if (retcode == 0) {
+		retcode = ftridiagDC(pd + m, pe + m, n - m, pZ + m * ldz + m, ldz);
+		}
 	if (retcode != 0) {
 		return retcode;
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pav, ncols, 1, "Autovalores");
-		fshowmat(mav, ncols, ncols, "Autovetores");
-		}	
-	for (int k = 0; k < ncols; ++ k) {
-		float sing = sqrt(fabs(pav[k]));
-		flops_ += FLOPS_SQRT;
-		pS[k * ncols + k] = sing;
-		for (int j = 0; j < ncols; ++ j) {
-			paux[j] = mav[j * ncols + k];
+	// z = Q^T v: última linha de Q1 e primeira linha de Q2
+	float * pz = (float *) malloc(n * sizeof(float));
+	int * pidx = (int *) malloc(2 * n * sizeof(int));
+	if (pz == NULL || pidx == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", 3 * n);
+		exit(7);
+		}
+	int * pnd = pidx + n;
+	float dmax = rho;
+	for (int i = 0; i < n; ++ i) {
+		pz[i] = (i < m) ? pZ[(m - 1) * ldz + i] : sgn * pZ[m * ldz + i];
+		dmax = (fabs(pd[i]) > dmax) ? fabs(pd[i]) : dmax;
+		pidx[i] = i;
+		}
+	for (int i = 1; i < n; ++ i) {
+		int aux = pidx[i], j;
+		for (j = i - 1; j >= 0 && pd[pidx[j]] > pd[aux]; -- j) {
+			pidx[j + 1] = pidx[j];
+			}
+		pidx[j + 1] = aux;
+		}
+	// Deflação: componentes de z desprezíveis e autovalores muito próximos (uma rotação de Givens anula uma das componentes)
+	float tol = 8 * FLT_EPSILON * dmax;
+	int k = 0, prev = -1;
+	for (int t = 0; t < n; ++ t) {
+		int p = pidx[t];
+		if (rho * fabs(pz[p]) <= tol) {
+			continue;
 			}
-		float * pv = fgemm(pA, nrows, ncols, paux, ncols, 1);
-		for (int j = 0; j < nrows; ++ j) {
-			pU[j * nrows + k] = pv[j] / sing;
-			flops_ += FLOPS_DIV;
+		if (prev >= 0 && pd[p] - pd[prev] <= tol) {
+			float r = sqrt(pz[prev] * pz[prev] + pz[p] * pz[p]);
+			float c = pz[p] / r, s = - pz[prev] / r;
+			float dprev = pd[prev], dp = pd[p];
+			pd[prev] = c * c * dprev + s * s * dp;
+			pd[p] = s * s * dprev + c * c * dp;
+			pz[prev] = 0;
+			pz[p] = r;
+			for (int i = 0; i < n; ++ i) {
+				float qa = pZ[i * ldz + prev], qb = pZ[i * ldz + p];
+				pZ[i * ldz + prev] = c * qa + s * qb;
+				pZ[i * ldz + p] = - s * qa + c * qb;
+				}
+			flops_ += 6 * n + 12 + FLOPS_SQRT + 2 * FLOPS_DIV;
+			}
+		else if (prev >= 0) {
+			pnd[k ++] = prev;
 			}
-		free(pv);
+		prev = p;
 		}
-	free(pmat);
-	free(psys);
-	if (debuglevel_ >= 2) {
-		fshowmat(mav, ncols, ncols, "V");
-		fshowmat(pS, nrows, ncols, "S");
-		fshowmat(pU, nrows, nrows, "U");
-		}	
-	for (int k = ncols; k < nrows; ++ k) {
-		paux = (float *) calloc(nrows, sizeof(float));
-		if (paux == NULL) {
-			printf("Não conseguiu alocar memória para a matriz de %d x 1! \n", nrows);
-			exit(7);
+	if (prev >= 0) {
+		pnd[k ++] = prev;
+		}
+	if (k == 0) {
+		free(pz);
+		free(pidx);
+		return 0;
+		}
+	// Equação secular 1 + rho sum(z_j^2 / (d_j - lambda)) = 0, resolvida por bissecção em precisão dupla.
+	// Cada raiz é representada como lambda = d(org) + mu, em relação ao polo mais próximo, para que as diferenças sejam exatas.
+	double * pD = (double *) malloc(4 * k * sizeof(double));
+	int * porg = (int *) malloc(k * sizeof(int));
+	float * pU = (float *) malloc(k * k * sizeof(float));
+	float * pG = (float *) malloc(2 * n * k * sizeof(float));
+	if (pD == NULL || porg == NULL || pU == NULL || pG == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, 2 * k);
+		exit(7);
+		}
+	double * pZ2 = pD + k, * pmu = pD + 2 * k, * pzh = pD + 3 * k;
+	double zz2 = 0;
+	for (int j = 0; j < k; ++ j) {
+		pD[j] = pd[pnd[j]];
+		pZ2[j] = (double) pz[pnd[j]] * pz[pnd[j]];
+		zz2 += pZ2[j];
+		}
+	#pragma omp parallel for schedule(dynamic, 16)
+	for (int i = 0; i < k; ++ i) {
+		double lo, hi;
+		int org;
+		if (i < k - 1) {
+			double mid = 0.5 * (pD[i + 1] - pD[i]), f = 1;
+			for (int j = 0; j < k; ++ j) {
+				f += rho * pZ2[j] / ((pD[j] - pD[i]) - mid);
+				}
+			if (f >= 0) {
+				org = i;
+				lo = 0;
+				hi = mid;
+				}
+			else {
+				org = i + 1;
+				lo = - mid;
+				hi = 0;
+				}
 			}
-		paux[k] = 1;
-		for (int j = 0; j < k; ++ j) {
-			for (int i = 0; i < nrows; ++ i) {
-				pw[i] = pU[i * nrows + j];
+		else {
+			org = k - 1;
+			lo = 0;
+			hi = rho * zz2;
+			}
+		for (int iter = 0; iter < MAXITER_SEC; ++ iter) {
+			double mu = 0.5 * (lo + hi);
+			if (mu == lo || mu == hi || hi - lo <= 2 * DBL_EPSILON * ((fabs(lo) > fabs(hi)) ? fabs(lo) : fabs(hi))) {
+				break;
 				}
-			float * pesc = fgemm(paux, 1, nrows, pw, nrows, 1);
-			for (int i = 0; i < nrows; ++ i) {
-				pw[i] *= * pesc;
-				++ flops_;
+			double f = 1;
+			for (int j = 0; j < k; ++ j) {
+				f += rho * pZ2[j] / ((pD[j] - pD[org]) - mu);
 				}
-			free(pesc);
-			if (j == 0) {
-				for (int i = 0; i < nrows; ++ i) {
-					pwaux[i] = pw[i];
-					}
+			if (f > 0) {
+				hi = mu;
 				}
 			else {
-				float * psum = fmadd(pwaux, nrows, 1, pw, nrows, 1, true);
-				free(pwaux);
-				pwaux = psum;
+				lo = mu;
 				}
 			}
-		if (debuglevel_ >= 2) {
-			fshowmat(paux, nrows, 1, "v");
-			fshowmat(pwaux, nrows, 1, "aux");
-			}		
-		float * psum = fmadd(paux, nrows, 1, pwaux, nrows, 1, false);
-		float * pesc = fgemm(psum, 1, nrows, psum, nrows, 1);
-		float invesc = 1 / sqrt(* pesc);
-		flops_ += FLOPS_DIV + FLOPS_SQRT;
-		for (int i = 0; i < nrows; ++ i) {
-			psum[i] *= invesc;
-			++ flops_;
+		porg[i] = org;
+		pmu[i] = 0.5 * (lo + hi);
+		}
+	flops_ += 60LL * k * k * (3 + FLOPS_DIV);
+	// z recalculado (Gu-Eisenstat) a partir das raízes, de modo que os autovalores sejam exatos para z
+	#pragma omp parallel for
+	for (int i = 0; i < k; ++ i) {
+		double prod = ((pD[porg[k - 1]] - pD[i]) + pmu[k - 1]) / rho;
+		for (int j = 0; j < k - 1; ++ j) {
+			double delta = (pD[porg[j]] - pD[i]) + pmu[j];
+			prod *= delta / ((j < i) ? pD[j] - pD[i] : pD[j + 1] - pD[i]);
+			}
+		pzh[i] = copysign(sqrt(fabs(prod)), (double) pz[pnd[i]]);
+		}
+	// Autovetores de D + rho z z^T: u_j(i) = z_i / (d_i - lambda_j), normalizados
+	#pragma omp parallel for
+	for (int j = 0; j < k; ++ j) {
+		double norm = 0;
+		for (int i = 0; i < k; ++ i) {
+			double value = pzh[i] / ((pD[i] - pD[porg[j]]) - pmu[j]);
+			pU[i * k + j] = value;
+			norm += value * value;
+			}
+		norm = 1 / sqrt(norm);
+		for (int i = 0; i < k; ++ i) {
+			pU[i * k + j] *= norm;
+			}
+		}
+	flops_ += 2LL * k * k * (FLOPS_DIV + 4);
+	// Combinação com os autovetores dos blocos: Z(:, nd) = Z(:, nd) U
+	float * pR = pG + n * k;
+	for (int i = 0; i < n; ++ i) {
+		for (int j = 0; j < k; ++ j) {
+			pG[i * k + j] = pZ[i * ldz + pnd[j]];
 			}
-		if (debuglevel_ >= 2) {
-			fshowmat(psum, nrows, 1, "w");
-			}		
-		free(pesc);
-		for (int i = 0; i < nrows; ++ i) {
-			pU[i * nrows + k] = psum[i];
+		}
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, k, k, 1, pG, k, pU, k, 0, pR, k);
+	flops_ += 2LL * n * k * k;
+	for (int i = 0; i < n; ++ i) {
+		for (int j = 0; j < k; ++ j) {
+			pZ[i * ldz + pnd[j]] = pR[i * k + j];
 			}
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(mav, ncols, ncols, "V");
-		fshowmat(pS, ncols, nrows, "S");
-		fshowmat(pU, nrows, nrows, "U");
-		}	
-	* ppV = mav;
-	* ppS = pS;
-	* ppU = pU;
+	for (int j = 0; j < k; ++ j) {
+		pd[pnd[j]] = pD[porg[j]] + pmu[j];
+		}
+	free(pz);
+	free(pidx);
+	free(pD);
+	free(porg);
+	free(pU);
+	free(pG);
 	return 0;
 	}
-	
-void fcompress(float * pS, float * pU, float * pV, int nrows, int ncols, float retain, float ** ppnS, float ** ppnU, float ** ppnV, fcompressdata * pstats) {
-	float * pav = (float *) malloc(nrows * sizeof(float));
-	int * pick = (int *) calloc(nrows, sizeof(int));
-	if (pav == NULL || pick == NULL) {	
-		printf("Não conseguiu alocar memória para as matrizes! \n");
+
+int finviterH(float * pH, int n, float * pav, int nav, float * pQ, float ** ppmav, int * piter) {
+// Calcula os autovetores correspondentes aos 'nav' autovalores reais 'pav' da matriz de Hessenberg superior por iteração inversa.
+// Cada autovalor exige uma única decomposição LU de (H - lambda I) com pivotação parcial, que na forma de Hessenberg custa O(n^2);
+// autovalores próximos (separação menor que ORTOL_INV vezes a norma) formam grupos, tratados em paralelo entre si, e dentro de um grupo
+// cada vetor é reortogonalizado contra os anteriores a cada iteração. Autovalores repetidos são ainda ligeiramente perturbados.
+// Se a matriz não for normal, os vetores de um grupo formam uma base ortonormal do seu subespaço invariante (vetores de Schur).
+// Se 'pQ' for informada (A = Q H Q^T), os autovetores são transformados para os de A. Ficam nas colunas de uma matriz n x nav.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número máximo de iterações.
+	float * plambda = (float *) malloc(nav * sizeof(float));
+	float * pY = (float *) malloc(n * nav * sizeof(float));
+	int * pord = (int *) malloc(nav * sizeof(int));
+	int * pgrupo = (int *) malloc((nav + 1) * sizeof(int));
+	if (plambda == NULL || pY == NULL || pord == NULL || pgrupo == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, nav + 3);
 		exit(7);
-		}	
-	float max = 0, min = 1e6, sum = 0;
-	for (int i = 0; i < nrows; ++ i) {
-		float val = pS[i * nrows + i];
-		if (val > max) {
-			max = val;
+		}
+	float hnorm = 0;
+	for (int i = 0; i < n; ++ i) {
+		float sum = 0;
+		for (int j = (i > 0) ? i - 1 : 0; j < n; ++ j) {
+			sum += fabs(pH[i * n + j]);
+			}
+		hnorm = (sum > hnorm) ? sum : hnorm;
+		}
+	hnorm = (hnorm > 0) ? hnorm : 1;
+	float eps3 = FLT_EPSILON * hnorm, ortol = ORTOL_INV * hnorm;
+	// Em precisão simples, o resíduo atingível após a decomposição é da ordem de n eps ||H||
+	float tolinv = ((maxerr_ > 10 * n * FLT_EPSILON) ? maxerr_ : 10 * n * FLT_EPSILON) * hnorm;
+	for (int j = 0; j < nav; ++ j) {
+		plambda[j] = pav[j];
+		for (int k = 0; k < j; ++ k) {
+			if (fabs(plambda[j] - plambda[k]) < eps3) {
+				plambda[j] = plambda[k] + 2 * eps3;
+				k = -1;
+				}
+			}
+		}
+	// Os autovalores não estão necessariamente ordenados: os grupos de próximos são separados na ordem crescente
+	for (int j = 0; j < nav; ++ j) {
+		int aux = j, k;
+		for (k = j - 1; k >= 0 && plambda[pord[k]] > plambda[aux]; -- k) {
+			pord[k + 1] = pord[k];
 			}
-		if (val < min) {
-			min = val;
+		pord[k + 1] = aux;
+		}
+	int ngrupos = 0;
+	for (int k = 0; k < nav; ++ k) {
+		if (k == 0 || plambda[pord[k]] - plambda[pord[k - 1]] > ortol) {
+			pgrupo[ngrupos ++] = k;
 			}
-		sum += val;
-		++ flops_;
-		pav[i] = val;
 		}
-	pstats -> antes . rank = nrows;
-	pstats -> antes . max = max;
-	pstats -> antes . min = min;
-	pstats -> antes . ncond = max / min;
-	flops_ += FLOPS_DIV;
-	pstats -> antes . sum = sum;
-	float limit = retain * sum;
-	++ flops_;
-	int rank;
-	sum = 0;
-	for (rank = 0; sum < limit; ++ rank) {
-		max = 0;
-		int pos = -1;
-		for (int i = 0; i < nrows; ++ i) {
-			float val = pav[i];
-			if (val > max) {
-				max = val;
-				pos = i;
+	pgrupo[ngrupos] = nav;
+	int retcode = 0, maxit = 0;
+	long long int flops = 0;
+	#pragma omp parallel reduction(+: flops) reduction(max: maxit) reduction(max: retcode)
+		{
+		float * pLU = (float *) malloc((n * n + 2 * n) * sizeof(float));
+		bool * ptroca = (bool *) malloc(n * sizeof(bool));
+		if (pLU == NULL || ptroca == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, n + 2);
+			exit(7);
+			}
+		float * px = pLU + n * n, * pm = px + n;
+		#pragma omp for schedule(dynamic, 1)
+		for (int g = 0; g < ngrupos; ++ g) {
+			for (int kg = pgrupo[g]; kg < pgrupo[g + 1]; ++ kg) {
+				int j = pord[kg];
+				// Decomposição LU de H - lambda I: só as linhas 'k' e 'k + 1' disputam o pivô da coluna 'k'
+				for (int i = 0; i < n; ++ i) {
+					memcpy(pLU + i * n, pH + i * n, n * sizeof(float));
+					pLU[i * n + i] -= plambda[j];
+					}
+				for (int k = 0; k < n - 1; ++ k) {
+					float * prk = pLU + k * n, * prk1 = prk + n;
+					ptroca[k] = fabs(prk1[k]) > fabs(prk[k]);
+					if (ptroca[k]) {
+						for (int c = k; c < n; ++ c) {
+							float aux = prk[c];
+							prk[c] = prk1[c];
+							prk1[c] = aux;
+							}
+						}
+					if (prk[k] == 0) {
+						prk[k] = eps3;
+						}
+					float m = pm[k] = prk1[k] / prk[k];
+					for (int c = k + 1; c < n; ++ c) {
+						prk1[c] -= m * prk[c];
+						}
+					}
+				if (pLU[n * n - 1] == 0) {
+					pLU[n * n - 1] = eps3;
+					}
+				flops += (long long int) n * n + 2 * n * FLOPS_DIV;
+				// Vetor inicial pseudoaleatório e iterações (H - lambda I) y = x
+				float * prnd = frandn(1, n, j + 1);
+				memcpy(px, prnd, n * sizeof(float));
+				free(prnd);
+				int it;
+				bool conv = false;
+				for (it = 1; it <= MAXITER_INV && ! conv; ++ it) {
+					for (int k = 0; k < n - 1; ++ k) {
+						if (ptroca[k]) {
+							float aux = px[k];
+							px[k] = px[k + 1];
+							px[k + 1] = aux;
+							}
+						px[k + 1] -= pm[k] * px[k];
+						}
+					for (int i = n - 1; i >= 0; -- i) {
+						float sum = px[i];
+						for (int c = i + 1; c < n; ++ c) {
+							sum -= pLU[i * n + c] * px[c];
+							}
+						px[i] = sum / pLU[i * n + i];
+						}
+					// Reortogonaliza contra os vetores já calculados do grupo antes de medir o crescimento,
+					// de modo que 1 / ||y|| seja o resíduo na direção ainda não representada
+					for (int pass = 0; pass < 2 && kg > pgrupo[g]; ++ pass) {
+						for (int l = pgrupo[g]; l < kg; ++ l) {
+							int k = pord[l];
+							float dot = 0;
+							for (int i = 0; i < n; ++ i) {
+								dot += pY[i * nav + k] * px[i];
+								}
+							for (int i = 0; i < n; ++ i) {
+								px[i] -= dot * pY[i * nav + k];
+								}
+							}
+						}
+					float norm = cblas_snrm2(n, px, 1);
+					cblas_sscal(n, 1 / norm, px, 1);
+					flops += (long long int) n * n + 6 * n + 8LL * n * (kg - pgrupo[g]) + FLOPS_SQRT + (n + 1) * FLOPS_DIV;
+					// O resíduo do vetor normalizado é 1 / ||y||
+					conv = (1 / norm <= tolinv);
+					}
+				for (int i = 0; i < n; ++ i) {
+					pY[i * nav + j] = px[i];
+					}
+				maxit = (it - 1 > maxit) ? it - 1 : maxit;
+				if (! conv) {
+					retcode = 11;
+					}
 				}
 			}
-		pav[pos] = 0;
-		sum += max;
-		pick[rank] = pos;
+		free(pLU);
+		free(ptroca);
+		}
+	flops_ += flops;
+	free(plambda);
+	free(pord);
+	free(pgrupo);
+	if (pQ != NULL) {
+		float * pX = (float *) malloc(n * nav * sizeof(float));
+		if (pX == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, nav);
+			exit(7);
+			}
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, nav, n, 1, pQ, n, pY, nav, 0, pX, nav);
+		flops_ += 2LL * n * n * nav;
+		free(pY);
+		pY = pX;
 		}
-	pstats -> depois . rank = rank;
-	pstats -> depois . max = pstats -> antes . max;
-	pstats -> depois . min = max;
-	pstats -> depois . ncond = pstats -> depois . max / pstats -> depois . min;
-	flops_ += FLOPS_DIV;
-	pstats -> depois . sum = sum;
-	float * pnU = (float *) malloc(nrows * rank * sizeof(float));
-	float * pnS = (float *) calloc(rank * rank, sizeof(float));
-	float * pnV = (float *) malloc(ncols * rank * sizeof(float));
-	if (pnU == NULL || pnS == NULL || pnV == NULL) {
-		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 3 * rank);
+	* ppmav = pY;
+	* piter = maxit;
+	return retcode;
+	}
+
+int finviterT(float * pd, float * pe, int n, float * pav, int nav, float * pQ, float ** ppmav, int * piter) {
+// Calcula os autovetores correspondentes aos 'nav' autovalores 'pav', em ordem crescente, da matriz tridiagonal simétrica por iteração inversa.
+// Cada autovalor exige uma única decomposição LU de (T - lambda I) com pivotação parcial, de custo O(n).
+// Autovalores próximos (separação menor que ORTOL_INV vezes a norma) formam grupos, tratados em paralelo entre si; dentro de um grupo,
+// cada vetor é reortogonalizado contra os anteriores a cada iteração, pois a iteração inversa isolada não garante a ortogonalidade.
+// Se 'pQ' for informada (A = Q T Q^T), os autovetores são transformados para os de A. Ficam nas colunas de uma matriz n x nav.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número máximo de iterações.
+	float * pY = (float *) malloc(n * nav * sizeof(float));
+	float * plambda = (float *) malloc(nav * sizeof(float));
+	int * pgrupo = (int *) malloc((nav + 1) * sizeof(int));
+	if (pY == NULL || plambda == NULL || pgrupo == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, nav + 2);
 		exit(7);
-		}	
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			int celem = pick[j];
-			pnU[i * rank + j] = pU[i * nrows + celem];
+		}
+	float tnorm = 0;
+	for (int i = 0; i < n; ++ i) {
+		float sum = fabs(pd[i]) + ((i > 0) ? fabs(pe[i - 1]) : 0) + ((i < n - 1) ? fabs(pe[i]) : 0);
+		tnorm = (sum > tnorm) ? sum : tnorm;
+		}
+	tnorm = (tnorm > 0) ? tnorm : 1;
+	float eps3 = FLT_EPSILON * tnorm, ortol = ORTOL_INV * tnorm;
+	// Em precisão simples, o resíduo atingível após a decomposição é da ordem de n eps ||T||
+	float tolinv = ((maxerr_ > 10 * n * FLT_EPSILON) ? maxerr_ : 10 * n * FLT_EPSILON) * tnorm;
+	// Separa os grupos de autovalores próximos e afasta os repetidos
+	int ngrupos = 0;
+	for (int j = 0; j < nav; ++ j) {
+		plambda[j] = pav[j];
+		if (j == 0 || pav[j] - pav[j - 1] > ortol) {
+			pgrupo[ngrupos ++] = j;
+			}
+		else if (plambda[j] - plambda[j - 1] < 10 * eps3) {
+			plambda[j] = plambda[j - 1] + 10 * eps3;
+			}
+		}
+	pgrupo[ngrupos] = nav;
+	int retcode = 0, maxit = 0;
+	long long int flops = 0;
+	#pragma omp parallel reduction(+: flops) reduction(max: maxit) reduction(max: retcode)
+		{
+		float * pw = (float *) malloc(5 * n * sizeof(float));
+		bool * ptroca = (bool *) malloc(n * sizeof(bool));
+		if (pw == NULL || ptroca == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, 5);
+			exit(7);
+			}
+		float * pdl = pw, * pdd = pw + n, * pdu = pw + 2 * n, * pdu2 = pw + 3 * n, * px = pw + 4 * n;
+		#pragma omp for schedule(dynamic, 1)
+		for (int g = 0; g < ngrupos; ++ g) {
+			for (int j = pgrupo[g]; j < pgrupo[g + 1]; ++ j) {
+				// Decomposição LU de T - lambda I, com pivotação entre linhas vizinhas (segunda superdiagonal em 'pdu2')
+				for (int i = 0; i < n; ++ i) {
+					pdd[i] = pd[i] - plambda[j];
+					pdl[i] = pdu[i] = (i < n - 1) ? pe[i] : 0;
+					pdu2[i] = 0;
+					}
+				for (int i = 0; i < n - 1; ++ i) {
+					ptroca[i] = fabs(pdl[i]) > fabs(pdd[i]);
+					if (! ptroca[i]) {
+						if (pdd[i] == 0) {
+							pdd[i] = eps3;
+							}
+						float fact = pdl[i] / pdd[i];
+						pdl[i] = fact;
+						pdd[i + 1] -= fact * pdu[i];
+						}
+					else {
+						float fact = pdd[i] / pdl[i];
+						pdd[i] = pdl[i];
+						pdl[i] = fact;
+						float aux = pdu[i];
+						pdu[i] = pdd[i + 1];
+						pdd[i + 1] = aux - fact * pdd[i + 1];
+						if (i < n - 2) {
+							pdu2[i] = pdu[i + 1];
+							pdu[i + 1] = - fact * pdu[i + 1];
+							}
+						}
+					}
+				if (pdd[n - 1] == 0) {
+					pdd[n - 1] = eps3;
+					}
+				flops += 6LL * n + n * FLOPS_DIV;
+				float * prnd = frandn(1, n, j + 1);
+				memcpy(px, prnd, n * sizeof(float));
+				free(prnd);
+				int it;
+				bool conv = false;
+				for (it = 1; it <= MAXITER_INV; ++ it) {
+					for (int i = 0; i < n - 1; ++ i) {
+						if (ptroca[i]) {
+							float aux = px[i];
+							px[i] = px[i + 1];
+							px[i + 1] = aux - pdl[i] * px[i];
+							}
+						else {
+							px[i + 1] -= pdl[i] * px[i];
+							}
+						}
+					for (int i = n - 1; i >= 0; -- i) {
+						float sum = px[i];
+						if (i < n - 1) {
+							sum -= pdu[i] * px[i + 1];
+							}
+						if (i < n - 2) {
+							sum -= pdu2[i] * px[i + 2];
+							}
+						px[i] = sum / pdd[i];
+						}
+					// Reortogonaliza contra os vetores já calculados do grupo antes de medir o crescimento,
+					// de modo que 1 / ||y|| seja o resíduo na direção ainda não representada
+					for (int pass = 0; pass < 2 && j > pgrupo[g]; ++ pass) {
+						for (int k = pgrupo[g]; k < j; ++ k) {
+							float dot = 0;
+							for (int i = 0; i < n; ++ i) {
+								dot += pY[i * nav + k] * px[i];
+								}
+							for (int i = 0; i < n; ++ i) {
+								px[i] -= dot * pY[i * nav + k];
+								}
+							}
+						}
+					float norm = cblas_snrm2(n, px, 1);
+					cblas_sscal(n, 1 / norm, px, 1);
+					flops += 12LL * n + 8LL * n * (j - pgrupo[g]) + FLOPS_SQRT + (n + 1) * FLOPS_DIV;
+					// Após o critério ser atingido, faz mais uma iteração para depurar o vetor
+					if (conv) {
+						break;
+						}
+					conv = (1 / norm <= tolinv);
+					}
+				for (int i = 0; i < n; ++ i) {
+					pY[i * nav + j] = px[i];
+					}
+				it = (it <= MAXITER_INV) ? it : MAXITER_INV;
+				maxit = (it > maxit) ? it : maxit;
+				if (! conv) {
+					retcode = 11;
+					}
+				}
+			}
+		free(pw);
+		free(ptroca);
+		}
+	flops_ += flops;
+	free(plambda);
+	free(pgrupo);
+	if (pQ != NULL) {
+		float * pX = (float *) malloc(n * nav * sizeof(float));
+		if (pX == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, nav);
+			exit(7);
+			}
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, nav, n, 1, pQ, n, pY, nav, 0, pX, nav);
+		flops_ += 2LL * n * n * nav;
+		free(pY);
+		pY = pX;
+		}
+	* ppmav = pY;
+	* piter = maxit;
+	return retcode;
+	}
+
+int fsturm(float * pd, float * pe, int n, double x) {
+// Retorna o número de autovalores da matriz tridiagonal simétrica menores que 'x', pela sequência de Sturm (pivôs de T - x I = L D L^T).
+	int count = 0;
+	double q = pd[0] - x;
+	for (int i = 0; ; ++ i) {
+		if (fabs(q) < PIVMIN_STURM) {
+			q = - PIVMIN_STURM;
+			}
+		count += (q < 0);
+		if (i == n - 1) {
+			break;
+			}
+		q = (pd[i + 1] - x) - (double) pe[i] * pe[i] / q;
+		}
+	return count;
+	}
+
+int fbisect(float * pd, float * pe, int n, double a, double b, int ca, int cb, int il, int iu, float * pav, double atol) {
+// Isola por bissecção os autovalores de índices ca a cb - 1 contidos em [a, b), gravando em 'pav' os de índices il a iu.
+// Retorna o número de contagens de Sturm realizadas.
+	if (cb <= ca || cb <= il || ca > iu) {
+		return 0;
+		}
+	double width = b - a, scale = (fabs(a) > fabs(b)) ? fabs(a) : fabs(b);
+	double mid = 0.5 * (a + b);
+	if (width <= atol + FLT_EPSILON * scale || mid == a || mid == b) {
+		// Intervalo suficientemente estreito: todos os autovalores nele são iguais ao ponto médio
+		for (int k = ((ca > il) ? ca : il); k < cb && k <= iu; ++ k) {
+			pav[k - il] = mid;
+			}
+		return 0;
+		}
+	int cm = fsturm(pd, pe, n, mid);
+	return 1 + fbisect(pd, pe, n, a, mid, ca, cm, il, iu, pav, atol) + fbisect(pd, pe, n, mid, b, cm, cb, il, iu, pav, atol);
+	}
+
+int fmavB(float * pd, float * pe, int n, float vl, float vu, int il, int iu, float ** ppav, int * pnav) {
+// Calcula autovalores selecionados da matriz tridiagonal simétrica (diagonal 'pd', subdiagonal 'pe') por bissecção com a sequência de Sturm.
+// Se 'il' <= 'iu', procura os autovalores de índices 'il' a 'iu' (a partir de 0, em ordem crescente); caso contrário, os do intervalo [vl, vu).
+// O intervalo de busca é dividido em subintervalos, tratados em paralelo; cada passo de bissecção custa O(n).
+// Informa os autovalores, em ordem crescente, e a quantidade encontrada. Retorna 0 se tiver sucesso e um código de erro em caso contrário:
+// se as contagens de Sturm, afetadas pelo arredondamento, não forem monótonas, algum autovalor pedido pode não ser isolado (11).
+	// Limites de Gershgorin
+	double glo = pd[0], ghi = pd[0];
+	for (int i = 0; i < n; ++ i) {
+		double r = ((i > 0) ? fabs(pe[i - 1]) : 0) + ((i < n - 1) ? fabs(pe[i]) : 0);
+		glo = (pd[i] - r < glo) ? pd[i] - r : glo;
+		ghi = (pd[i] + r > ghi) ? pd[i] + r : ghi;
+		}
+	double gnorm = (fabs(glo) > fabs(ghi)) ? fabs(glo) : fabs(ghi);
+	double atol = DBL_EPSILON * gnorm;
+	glo -= 2 * FLT_EPSILON * gnorm + atol;
+	ghi += 2 * FLT_EPSILON * gnorm + atol;
+	double lo, hi;
+	long long int ncount = 0;
+	if (il <= iu) {
+		if (il < 0 || iu >= n) {
+			printf("Índices de autovalores fora dos limites: %d a %d (%d autovalores)! \n", il, iu, n);
+			exit(5);
+			}
+		lo = glo;
+		hi = ghi;
+		}
+	else {
+		lo = (vl > glo) ? vl : glo;
+		hi = (vu < ghi) ? vu : ghi;
+		if (lo >= hi) {
+			* ppav = NULL;
+			* pnav = 0;
+			return 0;
+			}
+		il = fsturm(pd, pe, n, lo);
+		iu = fsturm(pd, pe, n, hi) - 1;
+		ncount += 2;
+		}
+	int nav = iu - il + 1;
+	float * pav = (float *) malloc(((nav > 0) ? nav : 1) * sizeof(float));
+	int nsub = NSUB_BISEC * omp_get_max_threads();
+	int * pcnt = (int *) malloc((nsub + 1) * sizeof(int));
+	if (pav == NULL || pcnt == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", nav + nsub + 1);
+		exit(7);
+		}
+	int retcode = 0;
+	if (nav > 0) {
+		// Posições não preenchidas pela bissecção permanecem NAN
+		for (int k = 0; k < nav; ++ k) {
+			pav[k] = NAN;
+			}
+		// Contagens nos extremos dos subintervalos e bissecção independente em cada um deles
+		double h = (hi - lo) / nsub;
+		#pragma omp parallel for reduction(+: ncount)
+		for (int s = 0; s <= nsub; ++ s) {
+			pcnt[s] = (s == 0) ? fsturm(pd, pe, n, lo) : (s == nsub) ? fsturm(pd, pe, n, hi) : fsturm(pd, pe, n, lo + s * h);
+			++ ncount;
+			}
+		#pragma omp parallel for schedule(dynamic, 1) reduction(+: ncount)
+		for (int s = 0; s < nsub; ++ s) {
+			double a = lo + s * h, b = (s == nsub - 1) ? hi : lo + (s + 1) * h;
+			ncount += fbisect(pd, pe, n, a, b, pcnt[s], pcnt[s + 1], il, iu, pav, atol);
+			}
+		for (int k = 0; k < nav; ++ k) {
+			if (pav[k] != pav[k]) {
+				if (debuglevel_ >= 1) {
+					printf("O autovalor de índice %d não foi isolado! \n", il + k);
+					}
+				retcode = 11;
+				}
 			}
 		}
-	for (int i = 0; i < ncols; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			int celem = pick[j];
-			pnV[i * rank + j] = pV[i * ncols + celem];
-			}
+	flops_ += ncount * n * (4 + FLOPS_DIV);
+	free(pcnt);
+	if (retcode != 0) {
+		free(pav);
+		pav = NULL;
+		nav = 0;
 		}
-	for (int j = 0; j < rank; ++ j) {
-		int celem = pick[j];
-		pnS[j * rank + j] = pS[celem * ncols + celem];
+	* ppav = pav;
+	* pnav = (nav > 0) ? nav : 0;
+	return retcode;
+	}
+
+int fmavDC(float * pmat, int nrows, int ncols, float ** ppav, float ** ppmav) {
+// Calcula todos os autovalores e autovetores da matriz simétrica por redução à forma tridiagonal e dividir e conquistar.
+// Os autovalores são informados em ordem crescente e os autovetores, nas colunas correspondentes de uma matriz n x n.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	int n = nrows;
+	float * pd, * pe, * pQ;
+	f2tridiag(pmat, nrows, ncols, & pd, & pe, & pQ);
+	float * pZ = (float *) malloc(n * n * sizeof(float));
+	float * pmav = (float *) malloc(n * n * sizeof(float));
+	int * pord = (int *) malloc(n * sizeof(int));
+	if (pZ == NULL || pmav == NULL || pord == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, n);
+		exit(7);
 		}
-	* ppnS = pnS;
-	* ppnU = pnU;
-	* ppnV = pnV;
-	return; 
+	int retcode = ftridiagDC(pd, pe, n, pZ, n);
+	// Autovetores de A = Q Z, em ordem crescente dos autovalores
+	for (int i = 0; i < n; ++ i) {
+		pord[i] = i;
+		}
+	for (int i = 1; i < n; ++ i) {
+		int aux = pord[i], j;
+		for (j = i - 1; j >= 0 && pd[pord[j]] > pd[aux]; -- j) {
+			pord[j + 1] = pord[j];
+			}
+		pord[j + 1] = aux;
+		}
+	for (int i = 0; i < n; ++ i) {
+		pe[i] = pd[pord[i]];
+		for (int j = 0; j < n; ++ j) {
+			pmav[j * n + i] = pZ[j * n + pord[i]];
+			}
+		}
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pQ, n, pmav, n, 0, pZ, n);
+	flops_ += 2LL * n * n * n;
+	free(pd);
+	free(pQ);
+	free(pmav);
+	free(pord);
+	* ppav = pe;
+	* ppmav = pZ;
+	return retcode;
 	}
-	
-	
-// Funções para cálculo de autovalores por métodos iterativos
+
 int fmavJ(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppmav) {
-// Calcula os autovalores da matriz pelo método de Jacobi
-	float lastmax = 1e6, maxofmaxes = 0, * mav = NULL;
+// Calcula os autovalores da matriz simétrica pelo método de Jacobi cíclico com limiar.
+// Cada rotação atua diretamente sobre as linhas e colunas 'p' e 'q' de A e, se solicitados os autovetores, sobre as colunas de V, com custo O(n).
+// Encerra quando a norma dos elementos fora da diagonal fica abaixo de 'maxerr_' vezes a norma da matriz.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número de varreduras.
 	int retcode = 11, niter;
 	float * pav = (float *) malloc (nrows * sizeof(float));
 	if (pav == NULL) {
 		printf("Não conseguiu alocar memória para a matriz de autovalores %d x 1! \n", nrows);
 		exit(7);
 		}
+	float * mav = (ppmav != NULL) ? fident(nrows) : NULL;
+	float norm = 0;
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < nrows; ++ j) {
+			float value = pmat[i * ncols + j];
+			norm += value * value;
+			}
+		}
+	flops_ += 2 * nrows * nrows;
 	for (niter = 0; niter < maxiter_; ++ niter) {
-		bool trocou = false;
-		for (int i = 0; i < nrows; ++ i) {
-			float max = 0;
-			int pos = -1;
-			for (int j = 0; j < nrows; ++ j) {
-				if (i == j) {
+		// Verifica a convergência pela norma dos elementos fora da diagonal
+		float off = 0, sum = 0;
+		for (int p = 0; p < nrows - 1; ++ p) {
+			for (int q = p + 1; q < nrows; ++ q) {
+				float value = pmat[p * ncols + q];
+				off += value * value;
+				sum += fabs(value);
+				}
+			}
+		flops_ += 3 * nrows * (nrows - 1) / 2;
+		if (debuglevel_ >= 1) {
+			printf("Varredura %d: off(A) = %f \n", niter, sqrt(2 * off));
+			}
+		if (2 * off <= maxerr_ * maxerr_ * norm) {
+			retcode = 0;
+			break;
+			}
+		// Nas primeiras varreduras, só elimina os elementos acima do limiar
+		float limiar = (niter < 3) ? 0.2 * sum / (nrows * nrows) : 0;
+		for (int p = 0; p < nrows - 1; ++ p) {
+			for (int q = p + 1; q < nrows; ++ q) {
+				float apq = pmat[p * ncols + q];
+				float app = pmat[p * ncols + p];
+				float aqq = pmat[q * ncols + q];
+				float g = 100 * fabs(apq);
+				if (niter > 3 && (float) (fabs(app) + g) == (float) fabs(app) && (float) (fabs(aqq) + g) == (float) fabs(aqq)) {
+					// Elemento desprezível diante da diagonal
+					pmat[p * ncols + q] = pmat[q * ncols + p] = 0;
 					continue;
 					}
-				float value = fabs(pmat[i * ncols + j]);
-				if (value > max) {
-					max = value;
-					pos = j;
+				if (fabs(apq) <= limiar || apq == 0) {
+					continue;
 					}
-				}
-			if (pos == -1 || max <= maxerr_) {
-				continue;
-				}
-			if (max > maxofmaxes) {
-				maxofmaxes = max;
-				}
-			if (debuglevel_ >= 1) {
-				printf("Iter. %d: A(%d,%d) = %f. ", niter, i, pos, max);
-				}
-			float apq = pmat[i * ncols + pos];
-			float aqq_app;
-			if (apq == 0) {
-				printf("O método falhou na iteração %d porque A(%d,%d) = 0! \n", niter, i, pos);
-				exit(14);
-				}
-			float aqq = pmat[pos * ncols + pos];
-			float app = pmat[i * ncols + i];
-			if (debuglevel_ >= 2) {
-				printf("aqq = %f, app = %f, apq = %f, ", aqq, app, apq);
-				}
-			float doisapq = 2 * apq;
-			++ flops_;
-			float t;
-			if (aqq == app) {
-				t = 1;
-				}
-			else {
-				float phi = (aqq - app) / doisapq;
-				float root = sqrt(phi * phi + 1);
-				float divisor;
-				if (phi > 0) {
-					divisor = phi + root;
+				float h = aqq - app, t;
+				if ((float) (fabs(h) + g) == (float) fabs(h)) {
+					t = apq / h;
 					}
 				else {
-					divisor = phi - root;
+					float theta = 0.5 * h / apq;
+					t = 1 / (fabs(theta) + sqrt(1 + theta * theta));
+					if (theta < 0) {
+						t = - t;
+						}
 					}
-				t = 1 / divisor;
-				flops_ += 4 + FLOPS_SQRT + 2 * FLOPS_DIV;
-				}
-			float t2 = t * t;
-			float um_mais_t2 = 1 + t2;
-			float cos2phi = 1 / um_mais_t2;
-			float sinphicosphi = t * cos2phi;
-			float sin2phi = 1 - cos2phi;
-			flops_ += 4 + FLOPS_DIV;				
-			pmat[i * ncols + pos] = pmat[pos * ncols + i] = 0;
-			float extra = doisapq * sinphicosphi;
-			float newaii = pmat[i * ncols + i] * cos2phi + pmat[pos * ncols + pos] * sin2phi - extra ;
-			float newapospos =  pmat[i * ncols + i] * sin2phi + pmat[pos * ncols + pos] * cos2phi + extra ;
-			flops_ += 9;
-			pmat[i * ncols + i] = newaii;
-			pmat[pos * ncols + pos] = newapospos;
-			trocou = true;
-			if (debuglevel_ >= 2) {
-				printf("sin2phi = %f, cos2phi = %f, aii = %f, app = %f ", sin2phi, cos2phi, newaii, newapospos);
-				}
-			if (debuglevel_ >= 1) {
-				printf("t = %f \n", t);
-				}
-			if (debuglevel_ >= 2) {
-				fshowmat(pmat, nrows, ncols, "A");
-				}
-			if (ppmav != NULL) {
-				float cosphi = sqrt(cos2phi);
-				float sinphi = t * cosphi;
-				flops_ += 1 + FLOPS_SQRT;
-				float * pmU = fident(nrows);
-				pmU[i * nrows + i] = pmU[pos * nrows + pos] = cosphi;
-				pmU[i * nrows + pos] = sinphi;
-				pmU[pos * nrows + i] = - sinphi;				
+				float c = 1 / sqrt(1 + t * t);
+				float s = t * c;
+				float tau = s / (1 + c);
+				h = t * apq;
+				flops_ += 12 + 2 * FLOPS_SQRT + 4 * FLOPS_DIV;
 				if (debuglevel_ >= 2) {
-					fshowmat(pmU, nrows, nrows, "U");
-					}
-				if (mav == NULL) {
-					mav = pmU;
+					printf("Iter. %d: A(%d,%d) = %f, app = %f, aqq = %f, t = %f \n", niter, p, q, apq, app, aqq, t);
 					}
-				else {
-					float * paux = fgemm(mav, nrows, nrows, pmU, nrows, nrows);
-					free(mav);
-					free(pmU);
-					mav = paux;
+				pmat[p * ncols + p] = app - h;
+				pmat[q * ncols + q] = aqq + h;
+				pmat[p * ncols + q] = pmat[q * ncols + p] = 0;
+				// Gira as linhas e colunas 'p' e 'q', mantendo a simetria
+				for (int j = 0; j < nrows; ++ j) {
+					if (j == p || j == q) {
+						continue;
+						}
+					float ajp = pmat[j * ncols + p];
+					float ajq = pmat[j * ncols + q];
+					pmat[j * ncols + p] = pmat[p * ncols + j] = ajp - s * (ajq + ajp * tau);
+					pmat[j * ncols + q] = pmat[q * ncols + j] = ajq + s * (ajp - ajq * tau);
 					}
-				if (debuglevel_ >= 2) {
-					fshowmat(mav, nrows, nrows, "AV");
+				flops_ += 8 * (nrows - 2);
+				// Acumula a rotação nos autovetores
+				if (mav != NULL) {
+					for (int j = 0; j < nrows; ++ j) {
+						float vjp = mav[j * nrows + p];
+						float vjq = mav[j * nrows + q];
+						mav[j * nrows + p] = vjp - s * (vjq + vjp * tau);
+						mav[j * nrows + q] = vjq + s * (vjp - vjq * tau);
+						}
+					flops_ += 8 * nrows;
 					}
 				}
 			}
-		if (maxofmaxes <= maxerr_ || ! trocou) {
-			retcode = 0;
-			break;
-			}
-		if (maxofmaxes > lastmax) {
-			printf("O método divergiu! \n");
-			retcode = 12;
-			break;
+		if (debuglevel_ >= 2) {
+			fshowmat(pmat, nrows, ncols, "A");
 			}
-		lastmax = maxofmaxes;
-		maxofmaxes = 0;
 		}
 	* piter = niter;
 	for (int i = 0; i < nrows; ++ i) {
@@ -2875,56 +4802,376 @@ int fmavJ(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float
 		}
 	* ppav = pav;
 	if (ppmav != NULL) {
-		if (mav == NULL) {
-			mav = (float *) malloc(nrows * nrows * sizeof(float));
-			for (int i = 0; i < nrows; ++ i) {
-				mav[i * nrows + i] = 1;
-				}
+		if (debuglevel_ >= 2) {
+			fshowmat(mav, nrows, nrows, "AV");
 			}
 		* ppmav = mav;
 		}
 	return retcode;
 	}
 	
-int fmavR(float * pmat, int nrows, int ncols, float ** ppav, int * piter) {
-// Calcula os autovalores da matriz pelo método de Rutishauer
-	float lastmax = 1e6;
+int fmavJP(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppmav) {
+// Calcula os autovalores da matriz simétrica pelo método de Jacobi paralelo.
+// Cada varredura tem n - 1 passos; a cada passo, a ordenação de Brent-Luk (torneio circular) fornece n/2 pares (p, q) disjuntos,
+// cujas rotações são calculadas independentemente e aplicadas em bloco: primeiro às linhas de A, depois às colunas de A e de V.
+// Como os pares são disjuntos, o bloco 2 x 2 de cada par só é afetado pela sua própria rotação e é atualizado analiticamente.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número de varreduras.
 	int retcode = 11, niter;
+	int npares = (nrows + 1) / 2, nrounds = 2 * npares - 1;
 	float * pav = (float *) malloc (nrows * sizeof(float));
-	if (pav == NULL) {
-		printf("Não conseguiu alocar memória para a matriz de autovalores %d x 1! \n", nrows);
+	int * pp = (int *) malloc(npares * sizeof(int));
+	int * pq = (int *) malloc(npares * sizeof(int));
+	float * ps = (float *) malloc(npares * sizeof(float));
+	float * ptau = (float *) malloc(npares * sizeof(float));
+	float * pdp = (float *) malloc(npares * sizeof(float));
+	float * pdq = (float *) malloc(npares * sizeof(float));
+	if (pav == NULL || pp == NULL || pq == NULL || ps == NULL || ptau == NULL || pdp == NULL || pdq == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes de %d x 7! \n", nrows);
 		exit(7);
 		}
-	float * pA = pmat;
+	float * mav = (ppmav != NULL) ? fident(nrows) : NULL;
+	float norm = 0;
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < nrows; ++ j) {
+			float value = pmat[i * ncols + j];
+			norm += value * value;
+			}
+		}
+	flops_ += 2 * nrows * nrows;
 	for (niter = 0; niter < maxiter_; ++ niter) {
-		float * pL, * pR;
-		if (debuglevel_ >= 1) {
-			printf("Iter. %d \n", niter);
+		// Verifica a convergência pela norma dos elementos fora da diagonal
+		float off = 0;
+		#pragma omp parallel for reduction(+: off)
+		for (int p = 0; p < nrows - 1; ++ p) {
+			for (int q = p + 1; q < nrows; ++ q) {
+				float value = pmat[p * ncols + q];
+				off += value * value;
+				}
 			}
-		f2LR(pA, nrows, & pL, & pR);
-		if (debuglevel_ >= 2) {
-			fshowmat(pA, nrows, nrows, "A");
-			fshowmat(pL, nrows, nrows, "L");
-			fshowmat(pR, nrows, nrows, "R");
+		flops_ += nrows * (nrows - 1);
+		if (debuglevel_ >= 1) {
+			printf("Varredura %d: off(A) = %f \n", niter, sqrt(2 * off));
 			}
-		float * pRL = fmmult(pR, nrows, nrows , pL, nrows, nrows);
-		if (fistris(pRL, nrows, nrows)) {
+		if (2 * off <= maxerr_ * maxerr_ * norm) {
 			retcode = 0;
 			break;
 			}
-		if (pA != pmat) {
-			free(pA);
+		// Elementos abaixo do limiar não impedem a convergência e não são rotacionados
+		float limiar = maxerr_ * sqrt(norm) / nrows;
+		for (int round = 0; round < nrounds; ++ round) {
+			int n = fparesRR(nrows, round, pp, pq);
+			// Calcula as rotações do passo, todas a partir da mesma A
+			int nrot = 0;
+			#pragma omp parallel for reduction(+: nrot)
+			for (int k = 0; k < n; ++ k) {
+				int p = pp[k], q = pq[k];
+				float apq = pmat[p * ncols + q];
+				float app = pmat[p * ncols + p];
+				float aqq = pmat[q * ncols + q];
+				float h = aqq - app;
+				if (fabs(apq) <= limiar) {
+					ps[k] = ptau[k] = 0;
+					continue;
+					}
+				float theta = 0.5 * h / apq;
+				float t = 1 / (fabs(theta) + sqrt(1 + theta * theta));
+				if (theta < 0) {
+					t = - t;
+					}
+				float c = 1 / sqrt(1 + t * t);
+				ps[k] = t * c;
+				ptau[k] = ps[k] / (1 + c);
+				pdp[k] = app - t * apq;
+				pdq[k] = aqq + t * apq;
+				++ nrot;
+				}
+			flops_ += nrot * (12 + 2 * FLOPS_SQRT + 4 * FLOPS_DIV);
+			if (nrot == 0) {
+				continue;
+				}
+			// A <- J^T A: cada rotação combina duas linhas inteiras, disjuntas das demais
+			#pragma omp parallel for
+			for (int k = 0; k < n; ++ k) {
+				float s = ps[k], tau = ptau[k];
+				if (s == 0) {
+					continue;
+					}
+				float * prowp = pmat + pp[k] * ncols;
+				float * prowq = pmat + pq[k] * ncols;
+				for (int j = 0; j < nrows; ++ j) {
+					float ap = prowp[j], aq = prowq[j];
+					prowp[j] = ap - s * (aq + ap * tau);
+					prowq[j] = aq + s * (ap - aq * tau);
+					}
+				}
+			// A <- A J e V <- V J: cada linha recebe todas as rotações do passo
+			#pragma omp parallel for
+			for (int i = 0; i < nrows; ++ i) {
+				float * prow = pmat + i * ncols;
+				float * pvrow = (mav != NULL) ? mav + i * nrows : NULL;
+				for (int k = 0; k < n; ++ k) {
+					float s = ps[k], tau = ptau[k];
+					if (s == 0) {
+						continue;
+						}
+					int p = pp[k], q = pq[k];
+					float ap = prow[p], aq = prow[q];
+					prow[p] = ap - s * (aq + ap * tau);
+					prow[q] = aq + s * (ap - aq * tau);
+					if (pvrow != NULL) {
+						float vp = pvrow[p], vq = pvrow[q];
+						pvrow[p] = vp - s * (vq + vp * tau);
+						pvrow[q] = vq + s * (vp - vq * tau);
+						}
+					}
+				}
+			// Blocos 2 x 2 dos pares: diagonal analítica e elemento anulado
+			for (int k = 0; k < n; ++ k) {
+				if (ps[k] != 0) {
+					int p = pp[k], q = pq[k];
+					pmat[p * ncols + p] = pdp[k];
+					pmat[q * ncols + q] = pdq[k];
+					pmat[p * ncols + q] = pmat[q * ncols + p] = 0;
+					}
+				}
+			flops_ += (long long int) nrot * 12 * nrows * ((mav != NULL) ? 3 : 2) / 2;
+			}
+		if (debuglevel_ >= 2) {
+			fshowmat(pmat, nrows, ncols, "A");
 			}
-		pA = pRL;
 		}
+	* piter = niter;
 	for (int i = 0; i < nrows; ++ i) {
-		pav[i] = pA[i * nrows + i];
+		pav[i] = pmat[i * ncols + i];
 		}
-	* piter = niter;
+	free(pp);
+	free(pq);
+	free(ps);
+	free(ptau);
+	free(pdp);
+	free(pdq);
 	* ppav = pav;
+	if (ppmav != NULL) {
+		* ppmav = mav;
+		}
 	return retcode;
 	}
+
+int fparesRR(int n, int round, int * pp, int * pq) {
+// Preenche os pares (p, q), com p < q, do passo 'round' do torneio circular entre 'n' índices (ordenação de Brent-Luk).
+// Ao longo de n - 1 passos (n par) cada par ocorre exatamente uma vez. Para 'n' ímpar, o índice fictício n é descartado.
+// Retorna o número de pares preenchidos.
+	int m = n + (n & 1), npares = 0;
+	for (int k = 0; k < m / 2; ++ k) {
+		int a = (k == 0) ? 0 : (k - 1 + round) % (m - 1) + 1;
+		int b = (m - 2 - k + round) % (m - 1) + 1;
+		if (a >= n || b >= n) {
+			continue;
+			}
+		pp[npares] = (a < b) ? a : b;
+		pq[npares] = (a < b) ? b : a;
+		++ npares;
+		}
+	return npares;
+	}
 	
+int fmavQR(float * pmat, int nrows, int ncols, float ** ppav, int * piter, float ** ppavi) {
+// Calcula os autovalores da matriz pelo método QR de Francis com deslocamento duplo implícito.
+// A matriz é antes reduzida à forma de Hessenberg, de modo que cada iteração custa O(n^2).
+// Os autovalores convergidos são separados (deflação) assim que um elemento da subdiagonal se torna desprezível.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número total de iterações e, se solicitado, as partes imaginárias.
+// Se não convergir, os autovalores ainda não separados são aproximados pela diagonal, com parte imaginária nula.
+	float * pav = (float *) malloc (nrows * sizeof(float));
+	float * pavi = (float *) malloc (nrows * sizeof(float));
+	if (pav == NULL || pavi == NULL) {
+		printf("Não conseguiu alocar memória para a matriz de autovalores %d x 2! \n", nrows);
+		exit(7);
+		}
+	int n = nrows, retcode = 0, niter = 0;
+	float * ph = f2hess(pmat, nrows, ncols);
+	float anorm = 0;
+	for (int i = 0; i < n; ++ i) {
+		for (int j = (i > 0) ? i - 1 : 0; j < n; ++ j) {
+			anorm += fabs(ph[i * n + j]);
+			}
+		}
+	int nn = n - 1, l;
+	float t = 0, p = 0, q = 0, r = 0, x, y, z, w, s;
+	while (nn >= 0) {
+		int its = 0;
+		do {
+			// Procura um elemento desprezível na subdiagonal
+			for (l = nn; l >= 1; -- l) {
+				s = fabs(ph[(l - 1) * n + l - 1]) + fabs(ph[l * n + l]);
+				if (s == 0) {
+					s = anorm;
+					}
+				if ((float) (fabs(ph[l * n + l - 1]) + s) == s) {
+					ph[l * n + l - 1] = 0;
+					break;
+					}
+				}
+			x = ph[nn * n + nn];
+			if (l == nn) {
+				// Uma raiz separada
+				pav[nn] = x + t;
+				pavi[nn --] = 0;
+				}
+			else {
+				y = ph[(nn - 1) * n + nn - 1];
+				w = ph[nn * n + nn - 1] * ph[(nn - 1) * n + nn];
+				if (l == nn - 1) {
+					// Duas raízes separadas, reais ou complexas conjugadas
+					p = 0.5 * (y - x);
+					q = p * p + w;
+					z = sqrt(fabs(q));
+					x += t;
+					flops_ += 6 + FLOPS_SQRT;
+					if (q >= 0) {
+						z = p + ((p >= 0) ? z : - z);
+						pav[nn - 1] = pav[nn] = x + z;
+						if (z != 0) {
+							pav[nn] = x - w / z;
+							flops_ += 1 + FLOPS_DIV;
+							}
+						pavi[nn - 1] = pavi[nn] = 0;
+						}
+					else {
+						pav[nn - 1] = pav[nn] = x + p;
+						pavi[nn - 1] = - (pavi[nn] = z);
+						}
+					nn -= 2;
+					}
+				else {
+					if (its >= maxiter_) {
+						printf("O método QR não convergiu para o autovalor %d em %d iterações! \n", nn, its);
+						retcode = 11;
+						for (int i = 0; i <= nn; ++ i) {
+							pav[i] = ph[i * n + i] + t;
+							pavi[i] = 0;
+							}
+						nn = -1;
+						break;
+						}
+					if (its == 10 || its == 20) {
+						// Deslocamento excepcional
+						t += x;
+						for (int i = 0; i <= nn; ++ i) {
+							ph[i * n + i] -= x;
+							}
+						s = fabs(ph[nn * n + nn - 1]) + fabs(ph[(nn - 1) * n + nn - 2]);
+						y = x = 0.75 * s;
+						w = -0.4375 * s * s;
+						flops_ += nn + 6;
+						}
+					++ its;
+					++ niter;
+					if (debuglevel_ >= 1) {
+						printf("Iter. %d: autovalor %d, subdiagonal = %f \n", niter, nn, ph[nn * n + nn - 1]);
+						}
+					// Procura dois elementos consecutivos pequenos na subdiagonal
+					int m;
+					for (m = nn - 2; m >= l; -- m) {
+						z = ph[m * n + m];
+						r = x - z;
+						s = y - z;
+						p = (r * s - w) / ph[(m + 1) * n + m] + ph[m * n + m + 1];
+						q = ph[(m + 1) * n + m + 1] - z - r - s;
+						r = ph[(m + 2) * n + m + 1];
+						s = fabs(p) + fabs(q) + fabs(r);
+						p /= s;
+						q /= s;
+						r /= s;
+						flops_ += 14 + 4 * FLOPS_DIV;
+						if (m == l) {
+							break;
+							}
+						float u = fabs(ph[m * n + m - 1]) * (fabs(q) + fabs(r));
+						float v = fabs(p) * (fabs(ph[(m - 1) * n + m - 1]) + fabs(z) + fabs(ph[(m + 1) * n + m + 1]));
+						if ((float) (u + v) == v) {
+							break;
+							}
+						}
+					for (int i = m + 2; i <= nn; ++ i) {
+						ph[i * n + i - 2] = 0;
+						if (i != m + 2) {
+							ph[i * n + i - 3] = 0;
+							}
+						}
+					// Passo QR duplo sobre as linhas l a nn e colunas m a nn
+					for (int k = m; k <= nn - 1; ++ k) {
+						if (k != m) {
+							p = ph[k * n + k - 1];
+							q = ph[(k + 1) * n + k - 1];
+							r = 0;
+							if (k != nn - 1) {
+								r = ph[(k + 2) * n + k - 1];
+								}
+							if ((x = fabs(p) + fabs(q) + fabs(r)) != 0) {
+								p /= x;
+								q /= x;
+								r /= x;
+								flops_ += 3 * FLOPS_DIV;
+								}
+							}
+						s = sqrt(p * p + q * q + r * r);
+						if (p < 0) {
+							s = - s;
+							}
+						flops_ += 5 + FLOPS_SQRT;
+						if (s != 0) {
+							if (k == m) {
+								if (l != m) {
+									ph[k * n + k - 1] = - ph[k * n + k - 1];
+									}
+								}
+							else {
+								ph[k * n + k - 1] = - s * x;
+								}
+							p += s;
+							x = p / s;
+							y = q / s;
+							z = r / s;
+							q /= p;
+							r /= p;
+							for (int j = k; j <= nn; ++ j) {
+								p = ph[k * n + j] + q * ph[(k + 1) * n + j];
+								if (k != nn - 1) {
+									p += r * ph[(k + 2) * n + j];
+									ph[(k + 2) * n + j] -= p * z;
+									}
+								ph[(k + 1) * n + j] -= p * y;
+								ph[k * n + j] -= p * x;
+								}
+							int mmin = (nn < k + 3) ? nn : k + 3;
+							for (int i = l; i <= mmin; ++ i) {
+								p = x * ph[i * n + k] + y * ph[i * n + k + 1];
+								if (k != nn - 1) {
+									p += z * ph[i * n + k + 2];
+									ph[i * n + k + 2] -= p * r;
+									}
+								ph[i * n + k + 1] -= p * q;
+								ph[i * n + k] -= p;
+								}
+							flops_ += 2 + 5 * FLOPS_DIV + 10 * (nn - k + 1) + 10 * (mmin - l + 1);
+							}
+						}
+					}
+				}
+			} while (nn >= 0 && l < nn - 1);
+		}
+	free(ph);
+	* piter = niter;
+	* ppav = pav;
+	if (ppavi != NULL) {
+		* ppavi = pavi;
+		}
+	else {
+		free(pavi);
+		}
+	return retcode;
+	}
+
 int fmmaxavP(float * pmat, int nrows, int ncols, float * pmax, int * piter, bool direto) {
 	float * pY = (float *) malloc(nrows * sizeof(float));
 	if (pY == NULL) {
@@ -2983,6 +5230,386 @@ int fmmaxavP(float * pmat, int nrows, int ncols, float * pmax, int * piter, bool
 	}
 
 
+int fmavS(float * pmat, int nrows, int ncols, int nav, bool direto, float ** ppav, float ** ppmav, int * piter) {
+// Calcula os 'nav' maiores ('direto') ou menores autovalores e respectivos autovetores da matriz simétrica pelo método da iteração em subespaço.
+// A cada iteração, o bloco X (n x nav, ortonormal) é multiplicado por A, ou por A^-1 por meio de uma única decomposição LU reaproveitada,
+// e a projeção de Rayleigh-Ritz X^T Z é diagonalizada pelo método de Jacobi, acelerando a convergência.
+// O bloco recebe 'nav' vetores de guarda adicionais, que aceleram a convergência dos autovalores procurados e não entram no critério de parada.
+// Os autovalores são informados em ordem decrescente de módulo ('direto') ou crescente e os autovetores, nas colunas de uma matriz n x nav.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número de iterações.
+	int n = nrows, k = (2 * nav < nrows) ? 2 * nav : nrows;
+	float * pX = frandn(n, k, 1);
+	float * pZ = (float *) malloc(n * k * sizeof(float));
+	float * pY = (float *) malloc(n * k * sizeof(float));
+	float * pH = (float *) malloc(k * k * sizeof(float));
+	float * pav = (float *) malloc(k * sizeof(float));
+	int * pord = (int *) malloc(k * sizeof(int));
+	if (pZ == NULL || pY == NULL || pH == NULL || pav == NULL || pord == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", n, 2 * k);
+		exit(7);
+		}
+	float * pL, * pU;
+	int * pP;
+	if (! direto) {
+		float * psys = (float *) malloc(n * (n + 1) * sizeof(float));
+		if (psys == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, n + 1);
+			exit(7);
+			}
+		for (int i = 0; i < n; ++ i) {
+			for (int j = 0; j < n; ++ j) {
+				psys[i * (n + 1) + j] = pmat[i * ncols + j];
+				}
+			psys[i * (n + 1) + n] = 0;
+			}
+		f2LU(psys, n, & pL, & pU, & pP, NULL);
+		free(psys);
+		}
+	fmortho(pX, n, k);
+	int retcode = 11, niter, itmin = 0;
+	float minres = 1e30;
+	for (niter = 0; niter < maxiter_; ++ niter) {
+		// Z = A X ou Z = A^-1 X
+		if (direto) {
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, k, n, 1, pmat, ncols, pX, k, 0, pZ, k);
+			flops_ += 2LL * n * n * k;
+			}
+		else {
+			fdoLUblk(pX, pZ, k, pL, pU, pP, n);
+			}
+		// Projeção de Rayleigh-Ritz: H = X^T Z = W T W^T
+		cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, k, k, n, 1, pX, k, pZ, k, 0, pH, k);
+		flops_ += 2LL * k * k * n;
+		for (int i = 0; i < k; ++ i) {
+			for (int j = 0; j < i; ++ j) {
+				pH[i * k + j] = pH[j * k + i] = 0.5 * (pH[i * k + j] + pH[j * k + i]);
+				}
+			}
+		float * ptheta, * pW;
+		int nj;
+		fmavJ(pH, k, k, & ptheta, & nj, & pW);
+		// Ordena os valores de Ritz pelo módulo, decrescente
+		for (int i = 0; i < k; ++ i) {
+			pord[i] = i;
+			}
+		for (int i = 1; i < k; ++ i) {
+			int aux = pord[i], j;
+			for (j = i - 1; j >= 0 && fabs(ptheta[pord[j]]) < fabs(ptheta[aux]); -- j) {
+				pord[j + 1] = pord[j];
+				}
+			pord[j + 1] = aux;
+			}
+		for (int i = 0; i < k; ++ i) {
+			pav[i] = ptheta[pord[i]];
+			for (int j = 0; j < k; ++ j) {
+				pH[j * k + i] = pW[j * k + pord[i]];
+				}
+			}
+		free(ptheta);
+		free(pW);
+		// Vetores de Ritz Y = X W e próximo bloco Z W; o resíduo Z w - theta X w mede a convergência
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, k, k, 1, pX, k, pH, k, 0, pY, k);
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, k, k, 1, pZ, k, pH, k, 0, pX, k);
+		flops_ += 4LL * n * k * k;
+		float maxres = 0;
+		for (int j = 0; j < nav; ++ j) {
+			float res = 0;
+			for (int i = 0; i < n; ++ i) {
+				float value = pX[i * k + j] - pav[j] * pY[i * k + j];
+				res += value * value;
+				}
+			res = sqrt(res) / fabs(pav[0]);
+			maxres = (res > maxres) ? res : maxres;
+			}
+		flops_ += nav * (3 * n + FLOPS_SQRT + FLOPS_DIV);
+		if (debuglevel_ >= 1) {
+			printf("Iter. %d: theta = %f, resíduo = %f \n", niter, pav[0], maxres);
+			}
+		if (maxres <= maxerr_) {
+			retcode = 0;
+			break;
+			}
+		// Em matrizes mal condicionadas a precisão simples impede que o resíduo caia abaixo de certo patamar
+		if (maxres < minres) {
+			minres = maxres;
+			itmin = niter;
+			}
+		else if (niter - itmin >= 10) {
+			break;
+			}
+		fmortho(pX, n, k);
+		}
+	if (! direto) {
+		for (int i = 0; i < nav; ++ i) {
+			pav[i] = 1 / pav[i];
+			flops_ += FLOPS_DIV;
+			}
+		free(pL);
+		free(pU);
+		free(pP);
+		}
+	// Descarta os vetores de guarda
+	for (int i = 0; i < n; ++ i) {
+		for (int j = 0; j < nav; ++ j) {
+			pX[i * nav + j] = pY[i * k + j];
+			}
+		}
+	free(pY);
+	free(pZ);
+	free(pH);
+	free(pord);
+	* piter = niter;
+	* ppav = pav;
+	* ppmav = pX;
+	return retcode;
+	}
+
+
+int fmavL(f_oper * pop, void * pdata, int n, int nav, bool maiores, float ** ppav, float ** ppmav, int * piter, bool modulo) {
+// Calcula os 'nav' maiores ('maiores') ou menores autovalores e respectivos autovetores de um operador simétrico pelo método de Lanczos;
+// se 'modulo', os autovalores são comparados pelo módulo (como na inversão espectral, em que os maiores de A^-1 são os menores de A)
+// e a base é sempre reortogonalizada por completo.
+// O operador é acessado apenas pelo produto y = A x ('pop'), de modo que a matriz pode ser densa, esparsa ou mesmo não armazenada.
+// A ortogonalidade da base de Krylov é acompanhada pela recorrência de Simon e restaurada só quando necessário (reortogonalização parcial).
+// Quando o subespaço se esgota, são mantidos os melhores vetores de Ritz e o processo recomeça a partir deles (reinício espesso).
+// Os autovalores são informados em ordem decrescente ('maiores') ou crescente e os autovetores, nas colunas de uma matriz n x nav.
+// O critério de parada é relativo a cada valor de Ritz, |beta_m y_m| <= maxerr |theta|, para que os autovalores pequenos também
+// sejam aceitos só com erro relativo pequeno. Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+// Informa o número de produtos pelo operador.
+	int m = 2 * nav + NLANCZOS_MIN;
+	m = (m < n) ? m : n;
+	float * pV = (float *) malloc((m + 1) * n * sizeof(float));		// vetores da base, um por linha
+	float * pT = (float *) malloc(m * m * sizeof(float));
+	float * pwp = (float *) malloc(3 * (m + 1) * sizeof(float));	// estimativas de ortogonalidade, w(j-1), w(j) e w(j+1)
+	float * palpha = (float *) malloc(2 * m * sizeof(float));
+	int * pord = (int *) malloc(m * sizeof(int));
+	if (pV == NULL || pT == NULL || pwp == NULL || palpha == NULL || pord == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", m + 1, n);
+		exit(7);
+		}
+	float * pbeta = palpha + m;
+	float * pwold = pwp, * pwcur = pwp + m + 1, * pwnew = pwp + 2 * (m + 1);
+	float eps = FLT_EPSILON, limiar = sqrt(FLT_EPSILON);
+	// Vetor inicial aleatório
+	float * pv0 = frandn(1, n, 1);
+	memcpy(pV, pv0, n * sizeof(float));
+	free(pv0);
+	fmortho(pV, n, 1);
+	memset(pT, 0, m * m * sizeof(float));
+	int l = 0, nmult = 0, retcode = 11, nrest;
+	float anorm = 0, betam = 0;
+	float * ptheta = NULL, * pY = NULL;
+	for (nrest = 0; nrest < maxiter_; ++ nrest) {
+		// Após um reinício, os vetores mantidos e o vetor residual são ortogonais entre si
+		for (int k = 0; k <= l; ++ k) {
+			pwcur[k] = eps;
+			pwold[k] = 0;
+			}
+		pwcur[l] = 1;
+		bool reort = false;
+		for (int j = l; j < m; ++ j) {
+			float * pvj = pV + j * n, * pw = pV + (j + 1) * n;
+			pop(pvj, pw, pdata);
+			++ nmult;
+			float alpha = cblas_sdot(n, pvj, 1, pw, 1);
+			cblas_saxpy(n, - alpha, pvj, 1, pw, 1);
+			if (j > l) {
+				cblas_saxpy(n, - pbeta[j - 1], pvj - n, 1, pw, 1);
+				}
+			else {
+				// Acoplamento com os vetores de Ritz mantidos (primeiro passo após o reinício)
+				for (int k = 0; k < l; ++ k) {
+					cblas_saxpy(n, - pT[k * m + l], pV + k * n, 1, pw, 1);
+					}
+				}
+			flops_ += 4LL * n + 2LL * n * (j > l ? 1 : l);
+			palpha[j] = alpha;
+			pT[j * m + j] = alpha;
+			float beta = cblas_snrm2(n, pw, 1);
+			flops_ += 2 * n + FLOPS_SQRT;
+			anorm = (fabs(alpha) + beta > anorm) ? fabs(alpha) + beta : anorm;
+			// Recorrência de Simon para a perda de ortogonalidade entre o novo vetor e os anteriores
+			float wmax = 0;
+			if (beta > 0) {
+				// Os vetores mantidos no reinício acoplam-se apenas ao vetor 'l': A v(k) = theta(k) v(k) + s(k) v(l)
+				float bj1 = (j > l) ? pbeta[j - 1] : 0;
+				for (int k = 0; k < j; ++ k) {
+					float value = (palpha[k] - alpha) * pwcur[k] - bj1 * pwold[k];
+					if (k < l) {
+						value += pT[k * m + l] * pwcur[l];
+						}
+					else {
+						value += pbeta[k] * pwcur[k + 1];
+						if (k > l) {
+							value += pbeta[k - 1] * pwcur[k - 1];
+							}
+						else {
+							for (int i = 0; i < l; ++ i) {
+								value += pT[i * m + l] * pwcur[i];
+								}
+							}
+						}
+					value += ((value >= 0) ? 2 : - 2) * eps * anorm;
+					pwnew[k] = value / beta;
+					wmax = (fabs(pwnew[k]) > wmax) ? fabs(pwnew[k]) : wmax;
+					}
+				flops_ += 10LL * j;
+				}
+			pwnew[j] = eps;
+			pwnew[j + 1] = 1;
+			// Reortogonaliza contra toda a base quando a estimativa ultrapassa sqrt(eps), e também no passo seguinte;
+			// na inversão espectral o operador aplicado pela LU só é simétrico a menos do erro de arredondamento, que a
+			// recorrência não modela, e a reortogonalização é feita em todos os passos
+			if (wmax > limiar || reort || j == l || modulo) {
+				for (int pass = 0; pass < 2; ++ pass) {
+					for (int k = 0; k <= j; ++ k) {
+						float dot = cblas_sdot(n, pV + k * n, 1, pw, 1);
+						cblas_saxpy(n, - dot, pV + k * n, 1, pw, 1);
+						}
+					}
+				flops_ += 8LL * n * (j + 1);
+				beta = cblas_snrm2(n, pw, 1);
+				flops_ += 2 * n + FLOPS_SQRT;
+				for (int k = 0; k <= j; ++ k) {
+					pwnew[k] = eps;
+					}
+				reort = (wmax > limiar && ! reort);
+				}
+			// Subespaço invariante: prossegue com um vetor aleatório ortogonal à base
+			if (beta <= eps * anorm && j + 1 < m) {
+				float * prnd = frandn(1, n, nmult + 1);
+				memcpy(pw, prnd, n * sizeof(float));
+				free(prnd);
+				for (int pass = 0; pass < 2; ++ pass) {
+					for (int k = 0; k <= j; ++ k) {
+						float dot = cblas_sdot(n, pV + k * n, 1, pw, 1);
+						cblas_saxpy(n, - dot, pV + k * n, 1, pw, 1);
+						}
+					}
+				cblas_sscal(n, 1 / cblas_snrm2(n, pw, 1), pw, 1);
+				flops_ += 8LL * n * (j + 1) + 3 * n;
+				beta = 0;
+				}
+			else if (beta > 0) {
+				cblas_sscal(n, 1 / beta, pw, 1);
+				flops_ += n + FLOPS_DIV;
+				}
+			pbeta[j] = beta;
+			if (j + 1 < m) {
+				pT[j * m + j + 1] = pT[(j + 1) * m + j] = beta;
+				}
+			float * paux = pwold;
+			pwold = pwcur;
+			pwcur = pwnew;
+			pwnew = paux;
+			}
+		betam = pbeta[m - 1];
+		// Valores e vetores de Ritz da matriz projetada
+		float savederr = maxerr_;
+		maxerr_ = eps;
+		int nj;
+		fmavJ(pT, m, m, & ptheta, & nj, & pY);
+		maxerr_ = savederr;
+		for (int i = 0; i < m; ++ i) {
+			pord[i] = i;
+			}
+		for (int i = 1; i < m; ++ i) {
+			int aux = pord[i], j;
+			for (j = i - 1; j >= 0; -- j) {
+				float a = (modulo) ? fabs(ptheta[pord[j]]) : ptheta[pord[j]], b = (modulo) ? fabs(ptheta[aux]) : ptheta[aux];
+				if ((maiores) ? a >= b : a <= b) {
+					break;
+					}
+				pord[j + 1] = pord[j];
+				}
+			pord[j + 1] = aux;
+			}
+		// O resíduo de cada par de Ritz é |beta_m * y_m|, medido em relação ao próprio valor de Ritz
+		float maxres = 0;
+		for (int i = 0; i < nav; ++ i) {
+			float theta = fabs(ptheta[pord[i]]);
+			float res = fabs(betam * pY[(m - 1) * m + pord[i]]) / ((theta > eps * anorm) ? theta : eps * anorm);
+			maxres = (res > maxres) ? res : maxres;
+			}
+		flops_ += nav * (2 + FLOPS_DIV);
+		if (debuglevel_ >= 1) {
+			printf("Reinício %d: theta = %f, resíduo relativo = %f \n", nrest, ptheta[pord[0]], maxres);
+			}
+		bool convergiu = (maxres <= maxerr_ || m == n);
+		int nkeep = (convergiu) ? nav : nav + (m - nav) / 2;
+		nkeep = (nkeep < m - 1 || m == n) ? nkeep : m - 1;
+		// Vetores de Ritz mantidos, por combinação da base: V(0..nkeep-1) = Y^T V
+		float * pYk = (float *) malloc(nkeep * m * sizeof(float));
+		float * pVk = (float *) malloc(nkeep * n * sizeof(float));
+		if (pYk == NULL || pVk == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nkeep, n);
+			exit(7);
+			}
+		for (int i = 0; i < nkeep; ++ i) {
+			for (int k = 0; k < m; ++ k) {
+				pYk[i * m + k] = pY[k * m + pord[i]];
+				}
+			}
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nkeep, n, m, 1, pYk, m, pV, n, 0, pVk, n);
+		flops_ += 2LL * nkeep * n * m;
+		if (convergiu) {
+			for (int i = 0; i < nav; ++ i) {
+				palpha[i] = ptheta[pord[i]];
+				}
+			memcpy(ptheta, palpha, nav * sizeof(float));
+			retcode = 0;
+			free(pYk);
+			free(pY);
+			pY = pVk;
+			break;
+			}
+		// Reinício espesso: T passa a ser diagonal com uma linha de acoplamento ao vetor residual
+		memcpy(pV + nkeep * n, pV + m * n, n * sizeof(float));
+		memcpy(pV, pVk, nkeep * n * sizeof(float));
+		memset(pT, 0, m * m * sizeof(float));
+		for (int i = 0; i < nkeep; ++ i) {
+			pT[i * m + i] = palpha[i] = ptheta[pord[i]];
+			pT[i * m + nkeep] = pT[nkeep * m + i] = betam * pYk[i * m + m - 1];
+			}
+		l = nkeep;
+		free(pYk);
+		free(pVk);
+		free(ptheta);
+		free(pY);
+		ptheta = pY = NULL;
+		}
+	if (retcode != 0) {
+		// Não convergiu: informa a última aproximação disponível
+		free(pY);
+		pY = (float *) malloc(nav * n * sizeof(float));
+		if (pY == NULL) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nav, n);
+			exit(7);
+			}
+		memcpy(pY, pV, nav * n * sizeof(float));
+		if (ptheta == NULL) {
+			ptheta = (float *) malloc(nav * sizeof(float));
+			if (ptheta == NULL) {
+				printf("Não conseguiu alocar memória para o vetor %d! \n", nav);
+				exit(7);
+				}
+			for (int i = 0; i < nav; ++ i) {
+				ptheta[i] = palpha[i];
+				}
+			}
+		}
+	* ppmav = ftranspose(pY, nav, n);
+	* ppav = ptheta;
+	* piter = nmult;
+	free(pY);
+	free(pV);
+	free(pT);
+	free(pwp);
+	free(palpha);
+	free(pord);
+	return retcode;
+	}
+
 // Funções para solução de sistemas por métodos iterativos
 int fiterGS(float * pA, float * pB, float * pmerror, float * pcorr, float ** ppX, float * pM, float * pC, int * pim, int nrows) {
 	float * pX = * ppX;
@@ -3207,23 +5834,208 @@ int fsolveJ(float * psrc, int rank, float ** ppX, int * piter) {
 		pB = paux;
 		}
 	for (int i = 0; i < rank; ++ i) {
-		if (prec_ == 0) {
-			float coef = pA[i * rank + i];
-			coef = 1 / coef;
-			pA[i * rank + i] = coef;
-			pX[i] = pB[i] * coef;
-			flops_ += 1 + FLOPS_DIV;
+		if (prec_ == 0) {
+			float coef = pA[i * rank + i];
+			coef = 1 / coef;
+			pA[i * rank + i] = coef;
+			pX[i] = pB[i] * coef;
+			flops_ += 1 + FLOPS_DIV;
+			}
+		if (prec_ == 1) {
+			pX[i] = pB[i];
+			}
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pA, rank, rank, "A");
+		fshowmat(pB, rank, 1, "B");
+		fshowmat(pX, rank, 1, "X");
+		}
+	int retcode = fiterate(0, & fiterJ, pA, pB, & pX, piter, NULL, NULL, NULL, NULL, rank);
+	* ppX = pX;
+	return retcode;
+	}
+
+int fsolveJA(float * psrc, int rank, float ** ppX, int * piter) {
+// Resolve o sistema de equações pelo método de Jacobi assíncrono (caótico).
+// Cada thread relaxa continuamente o seu bloco de linhas, lendo os valores das demais sem travas nem barreiras.
+// A cada PERIODO_JA varreduras, verifica se o maior resíduo publicado pelas threads está abaixo do erro máximo; enquanto alguma
+// thread ainda não tiver publicado o resíduo de uma varredura completa (valor negativo), o critério não é aplicado.
+// O resíduo de uma thread que não avançou desde a verificação anterior (preemptada, com mais threads que núcleos) está
+// defasado e é ignorado; o resíduo verdadeiro é sempre conferido ao final. Varreduras repetidas sobre um bloco já convergido
+// (a thread à espera das demais) não contam para o limite de iterações nem fazem a thread parecer ativa.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário. Informa o número de varreduras contadas da thread mais lenta.
+	int ncols = rank + 1;
+	int nthreads = omp_get_max_threads();
+	float * pA = (float *) malloc(rank * rank * sizeof(float));
+	float * pB = (float *) malloc(rank * sizeof(float));
+	float * pD = (float *) malloc(rank * sizeof(float));
+	float * pX = (float *) malloc(rank * sizeof(float));
+	float * presid = (float *) malloc(nthreads * PAD_JA * sizeof(float));
+	int * psweeps = (int *) malloc(nthreads * PAD_JA * sizeof(int));
+	if (pA == NULL || pB == NULL || pD == NULL || pX == NULL || presid == NULL || psweeps == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank + 3);
+		exit(7);
+		}
+	for (int i = 0; i < rank; ++ i) {
+		float coef = psrc[i * ncols + i];
+		if (coef == 0) {
+			printf("A matriz é singular! \n");
+			exit(8);
 			}
-		if (prec_ == 1) {
-			pX[i] = pB[i];
+		for (int j = 0; j < rank; ++ j) {
+			pA[i * rank + j] = (i == j) ? 0 : psrc[i * ncols + j];
 			}
+		pB[i] = psrc[i * ncols + rank];
+		pD[i] = 1 / coef;
+		pX[i] = pB[i] * pD[i];
+		flops_ += 1 + FLOPS_DIV;
+		}
+	for (int t = 0; t < nthreads; ++ t) {
+		presid[t * PAD_JA] = -1;
+		psweeps[t * PAD_JA] = 0;
 		}
 	if (debuglevel_ >= 2) {
 		fshowmat(pA, rank, rank, "A");
 		fshowmat(pB, rank, 1, "B");
 		fshowmat(pX, rank, 1, "X");
 		}
-	int retcode = fiterate(0, & fiterJ, pA, pB, & pX, piter, NULL, NULL, NULL, NULL, rank);
+	int fim = 0, nsweeps = 0, nteam = nthreads;
+	long long int flops = 0;
+	while (fim == 0) {
+		#pragma omp parallel reduction(+: flops)
+		{
+			int tid = omp_get_thread_num(), nt = omp_get_num_threads();
+			// A equipe concedida pode ser menor que a pedida; só as suas posições de 'presid' e 'psweeps' são usadas
+			if (tid == 0) {
+				nteam = nt;
+				}
+			int ini = (long long int) rank * tid / nt, lim = (long long int) rank * (tid + 1) / nt;
+			int sweep, feitas = psweeps[tid * PAD_JA];
+			bool ocioso = false;
+			int * pvisto = (int *) malloc(nt * sizeof(int));
+			if (pvisto == NULL) {
+				printf("Não conseguiu alocar memória para o vetor %d! \n", nt);
+				exit(7);
+				}
+			for (int t = 0; t < nt; ++ t) {
+				pvisto[t] = -1;
+				}
+			// Sincroniza apenas a partida; daí em diante as threads não se esperam
+			#pragma omp barrier
+			for (sweep = psweeps[tid * PAD_JA]; ; ++ sweep) {
+				if (__atomic_load_n(& fim, __ATOMIC_RELAXED) != 0) {
+					break;
+					}
+				// Relaxa as linhas do bloco com os valores disponíveis no momento
+				float resid = 0;
+				for (int i = ini; i < lim; ++ i) {
+					float * prow = pA + i * rank;
+					float sum = 0;
+					for (int j = 0; j < rank; ++ j) {
+						float x;
+						__atomic_load(pX + j, & x, __ATOMIC_RELAXED);
+						sum += prow[j] * x;
+						}
+					float xi;
+					__atomic_load(pX + i, & xi, __ATOMIC_RELAXED);
+					float value = (pB[i] - sum) * pD[i];
+					float r = fabs((value - xi) / pD[i]);
+					if (! (r <= resid)) {
+						resid = r;
+						}
+					__atomic_store(pX + i, & value, __ATOMIC_RELAXED);
+					}
+				flops += (lim - ini) * (2LL * rank + 3 + FLOPS_DIV);
+				if (! ocioso || resid > maxerr_) {
+					++ feitas;
+					}
+				ocioso = resid <= maxerr_;
+				__atomic_store(presid + tid * PAD_JA, & resid, __ATOMIC_RELAXED);
+				__atomic_store_n(psweeps + tid * PAD_JA, feitas, __ATOMIC_RELAXED);
+				if (! (resid <= 1e30)) {
+					__atomic_store_n(& fim, 12, __ATOMIC_RELAXED);
+					break;
+					}
+				// Verifica periodicamente o critério global de parada
+				// O limite de iterações vale para a thread mais lenta; as demais continuam relaxando enquanto isso
+				if ((sweep + 1) % PERIODO_JA == 0) {
+					float max = 0;
+					int min = maxiter_;
+					bool pendente = false;
+					for (int t = 0; t < nt; ++ t) {
+						float r;
+						__atomic_load(presid + t * PAD_JA, & r, __ATOMIC_RELAXED);
+						int n = __atomic_load_n(psweeps + t * PAD_JA, __ATOMIC_RELAXED);
+						min = (n < min) ? n : min;
+						bool parada = t != tid && n == pvisto[t];
+						pvisto[t] = n;
+						pendente = pendente || r < 0;
+						if (! parada) {
+							max = (r > max) ? r : max;
+							}
+						}
+					if (debuglevel_ >= 1) {
+						printf("Thread %d, varredura %d: resíduo = %f \n", tid, sweep, max);
+						}
+					if (! pendente && max <= maxerr_) {
+						__atomic_store_n(& fim, 1, __ATOMIC_RELAXED);
+						break;
+						}
+					// Atingido o limite, a decisão também fica com o resíduo verdadeiro
+					if (min >= maxiter_) {
+						__atomic_store_n(& fim, 1, __ATOMIC_RELAXED);
+						break;
+						}
+					}
+				}
+			free(pvisto);
+		}
+		nsweeps = maxiter_;
+		for (int t = 0; t < nteam; ++ t) {
+			nsweeps = (psweeps[t * PAD_JA] < nsweeps) ? psweeps[t * PAD_JA] : nsweeps;
+			}
+		if (fim != 1) {
+			break;
+			}
+		// Os resíduos publicados podem estar defasados; confirma com o resíduo verdadeiro
+		float max = 0;
+		#pragma omp parallel for reduction(max: max)
+		for (int i = 0; i < rank; ++ i) {
+			float sum = 0;
+			for (int j = 0; j < rank; ++ j) {
+				sum += pA[i * rank + j] * pX[j];
+				}
+			float r = fabs(((pB[i] - sum) * pD[i] - pX[i]) / pD[i]);
+			max = (r > max) ? r : max;
+			}
+		flops += rank * (2LL * rank + 2 + FLOPS_DIV);
+		if (debuglevel_ >= 1) {
+			printf("Resíduo verdadeiro após %d varreduras: %f \n", nsweeps, max);
+			}
+		if (max > maxerr_) {
+			for (int t = 0; t < nteam; ++ t) {
+				presid[t * PAD_JA] = -1;
+				}
+			fim = (nsweeps < maxiter_) ? 0 : 11;
+			}
+		}
+	flops_ += flops;
+	int retcode = fim;
+	if (fim == 1) {
+		retcode = 0;
+		}
+	if (fim == 12) {
+		printf("O método divergiu! \n");
+		}
+	if (debuglevel_ >= 1) {
+		fshowmat(pX, rank, 1, "Result");
+		}
+	free(pA);
+	free(pB);
+	free(pD);
+	free(presid);
+	free(psweeps);
+	* piter = nsweeps;
 	* ppX = pX;
 	return retcode;
 	}
@@ -3241,6 +6053,92 @@ float * fgemm(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB
 	return pC;
 	}
 
+unsigned long long int fnvhash(const char * p, long long int n) {
+// Hash FNV-1a de 64 bits dos 'n' bytes em 'p', aplicado a palavras de 8 bytes (e aos bytes finais, um a um), para percorrer
+// rapidamente arquivos grandes; depois de cada palavra, os bits altos são dobrados sobre os baixos.
+	unsigned long long int h = 14695981039346656037ULL;
+	long long int i = 0;
+	for (; i + 8 <= n; i += 8) {
+		unsigned long long int w;
+		memcpy(& w, p + i, 8);
+		h = (h ^ w) * 1099511628211ULL;
+		h ^= h >> 32;
+		}
+	for (; i < n; ++ i) {
+		h = (h ^ (unsigned char) p[i]) * 1099511628211ULL;
+		}
+	return h;
+	}
+
+double foocmult(fmbfile * pmA, fmbfile * pmB, fmbfile * pmC, int nb) {
+// Multiplica, fora da memória, as matrizes dos arquivos abertos 'pmA' e 'pmB' e grava o produto no arquivo 'pmC', por peças de
+// 'nb' x 'nb': cada peça do produto acumula, com cblas_sgemm, os produtos das peças de A da sua faixa de linhas pelas de B da
+// sua faixa de colunas. Em cada passo, uma thread de E/S grava a última peça pronta do produto e lê as peças do passo seguinte,
+// enquanto a outra multiplica as já lidas com um único cblas_sgemm, paralelizado pela própria biblioteca BLAS (dividir a peça
+// entre threads do OpenMP, cada uma com o seu sgemm já paralelo, só disputaria os mesmos núcleos); por isso, cada peça tem dois
+// buffers e a memória usada fica limitada a 6 peças. Retorna a norma de Frobenius do produto.
+	int m = pmA->nrows, k = pmA->ncols, n = pmB->ncols;
+	int nbi = (m + nb - 1) / nb, nbj = (n + nb - 1) / nb, nbp = (k + nb - 1) / nb;
+	long long int npassos = (long long int) nbi * nbj * nbp;
+	size_t npeca = (size_t) nb * nb;
+	float * pbuf = (float *) malloc(6 * npeca * sizeof(float));
+	if (pbuf == NULL) {
+		printf("Não conseguiu alocar memória para 6 peças %d x %d! \n", nb, nb);
+		exit(7);
+		}
+	float * pA[2] = {pbuf, pbuf + npeca}, * pB[2] = {pbuf + 2 * npeca, pbuf + 3 * npeca}, * pC[2] = {pbuf + 4 * npeca, pbuf + 5 * npeca};
+	// Peça do produto pronta, à espera de gravação: buffer ('pend' < 0 se não houver), posição e dimensões
+	int pend = -1, gi0 = 0, gj0 = 0, gnr = 0, gnc = 0, cc = 0;
+	double soma = 0;
+	fmblepeca(pmA, 0, 0, (m < nb) ? m : nb, (k < nb) ? k : nb, pA[0]);
+	fmblepeca(pmB, 0, 0, (k < nb) ? k : nb, (n < nb) ? n : nb, pB[0]);
+	for (long long int s = 0; s < npassos; ++ s) {
+		int cur = s % 2;
+		int i0 = s / ((long long int) nbj * nbp) * nb, j0 = s / nbp % nbj * nb, p0 = s % nbp * nb;
+		int nr = (m - i0 < nb) ? m - i0 : nb, nc = (n - j0 < nb) ? n - j0 : nb, np = (k - p0 < nb) ? k - p0 : nb;
+		float * pAc = pA[cur], * pBc = pB[cur], * pCc = pC[cc];
+		#pragma omp parallel sections num_threads(2)
+			{
+			#pragma omp section
+				{
+				// E/S: grava a peça pronta do produto e lê as peças do passo seguinte
+				if (pend >= 0) {
+					fmbgravapeca(pmC, gi0, gj0, gnr, gnc, pC[pend]);
+					}
+				if (s + 1 < npassos) {
+					int ni0 = (s + 1) / ((long long int) nbj * nbp) * nb, nj0 = (s + 1) / nbp % nbj * nb, np0 = (s + 1) % nbp * nb;
+					int nnp = (k - np0 < nb) ? k - np0 : nb;
+					fmblepeca(pmA, ni0, np0, (m - ni0 < nb) ? m - ni0 : nb, nnp, pA[1 - cur]);
+					fmblepeca(pmB, np0, nj0, nnp, (n - nj0 < nb) ? n - nj0 : nb, pB[1 - cur]);
+					}
+				}
+			#pragma omp section
+				{
+				// Cálculo: C += A B
+				cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, nr, nc, np, 1, pAc, np, pBc, nc, (p0 == 0) ? 0 : 1, pCc, nc);
+				}
+			}
+		flops_ += 2LL * nr * nc * np;
+		pend = -1;
+		if (p0 + np == k) {
+			for (size_t i = 0; i < (size_t) nr * nc; ++ i) {
+				soma += (double) pCc[i] * pCc[i];
+				}
+			pend = cc;
+			gi0 = i0;
+			gj0 = j0;
+			gnr = nr;
+			gnc = nc;
+			cc = 1 - cc;
+			}
+		}
+	if (pend >= 0) {
+		fmbgravapeca(pmC, gi0, gj0, gnr, gnc, pC[pend]);
+		}
+	free(pbuf);
+	return sqrt(soma);
+	}
+
 
 // Wrappers para funções da biblioteca de referência (em Fortran)
 extern"C" { void sgemm_(char *, char *, int *, int *, int *, float *, float *, int *, float *, int *, float *, float *, int *); }
@@ -3270,197 +6168,602 @@ float * fsolveLS(float * psys, int rank, int nrhs) {
 		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
 		exit(7);
 		}
-	float * pB = (float *) malloc(rank * nrhs * sizeof(float));
-	if (pB == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, nrhs);
+	float * pB = (float *) malloc(rank * nrhs * sizeof(float));
+	if (pB == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, nrhs);
+		exit(7);
+		}
+	int ncols = rank + nrhs;
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			pA[i * rank + j] = psys[i * ncols + j];
+			}
+		for (int j = 0; j < nrhs; ++ j) {
+			pB[i * nrhs + j] = psys[i * ncols + j + rank];
+			}
+		}
+	if (debuglevel_ == 2) {
+		fshowmat(pA, rank, rank, "A");
+		fshowmat(pB, rank, nrhs, "B");
+		}
+	lapack_int retcode = LAPACKE_sgels(LAPACK_ROW_MAJOR, 'N', rank, rank, nrhs, pA, rank, pB, nrhs);
+	if (retcode != 0) {
+		printf("Função LAPACKE_sgels retornou erro no argumento %d", -retcode);
+		exit(10);
+		}
+	if (debuglevel_ == 2) {
+		fshowmat(pA, rank, nrhs, "X");
+		}
+	free(pA);
+	return pB;
+	}
+
+	
+// Funções para cópia das matrizes em diversas precisões	
+void dcvtfd(const float * psrc, double * pdst, size_t n) {
+// Converte 'n' valores de precisão simples para dupla; com SSE2, converte dois valores por instrução.
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= n; i += 4) {
+		__m128 v = _mm_loadu_ps(psrc + i);
+		_mm_storeu_pd(pdst + i, _mm_cvtps_pd(v));
+		_mm_storeu_pd(pdst + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+		}
+#endif
+	for (; i < n; ++ i) {
+		pdst[i] = psrc[i];
+		}
+	}
+
+void fcvtdf(const double * psrc, float * pdst, size_t n) {
+// Converte 'n' valores de precisão dupla para simples; com SSE2, converte dois valores por instrução.
+	size_t i = 0;
+#ifdef __SSE2__
+	for (; i + 4 <= n; i += 4) {
+		__m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(psrc + i)), hi = _mm_cvtpd_ps(_mm_loadu_pd(psrc + i + 2));
+		_mm_storeu_ps(pdst + i, _mm_movelh_ps(lo, hi));
+		}
+#endif
+	for (; i < n; ++ i) {
+		pdst[i] = psrc[i];
+		}
+	}
+
+float * fmcopy(double * psrc, int nrows, int ncols) {
+// Retorna uma cópia em precisão simples (32 bits) da matriz 'psrc'
+	size_t size = (size_t) nrows * ncols;
+	float * pdst = (float *) malloc (size * sizeof(float));
+	if (pdst == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
+		}
+	fcvtdf(psrc, pdst, size);
+	return pdst;
+	}
+	
+long double * ldmcopy(double * psrc, int nrows, int ncols) {
+// Retorna uma cópia em precisão estendida (80 bits) da matriz 'psrc'
+	long double * pdst, * result;
+	int size = nrows * ncols;
+	result = pdst = (long double *) malloc (size * sizeof(long double));
+	if (pdst == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
+		}
+	while (size -- > 0) {
+		double dvalor;
+		long double ldvalor;
+		dvalor = * psrc ++;
+		ldvalor = dvalor;
+		* pdst ++ = ldvalor;
+		}
+	return result;
+	}
+
+float * fmsliceF(float * psrc, int nrsrc, int ncsrc, int nrdst, int ncdst, int ir, int ic) {
+// Retorna uma cópia da submatriz 'nrdst' x 'ncdst' da matriz em precisão simples 'psrc' ('nrsrc' x 'ncsrc'), a partir da linha 'ir'
+// e da coluna 'ic'.
+	float * pdst = (float *) malloc (nrdst * ncdst * sizeof(float));
+	if (pdst == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrdst, ncdst);
+		exit(7);
+		}
+	for (int i = 0; i < nrdst; ++ i) {
+		memcpy(pdst + i * ncdst, psrc + (ir + i) * ncsrc + ic, ncdst * sizeof(float));
+		}
+	return pdst;
+	}
+	
+// Funções para multiplicação das matrizes em diversas precisões
+float * fmmult(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB) {
+// Retorna o resultado da multiplicação das matrizes A e B em precisão simples.
+	int sizeC = nrowA * ncolB;
+	float * pvals = (float *) calloc(sizeC, sizeof(float));
+	if (pvals == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
+		exit(7);
+		}
+	for (int i = 0; i < nrowA; ++ i) {
+		for (int j = 0; j < ncolB; ++ j) {
+			for (int k = 0; k < ncolA; ++ k) {
+				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
+				++ flops_;
+				}
+			}
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pA, nrowA, ncolA, "A x B = C (float) \n A");
+		fshowmat(pB, nrowB, ncolB, "B");
+		fshowmat(pvals, nrowA, ncolB, "C");
+		}
+	return pvals;
+	}
+
+float * fpower(float * pmat, int nrows, int ncols, int pot) {
+// Retorna o resultado da potência 'pot' da matriz, com 'pot' >= 0, por quadrados sucessivos: A^pot é o produto dos quadrados
+// A^(2^k) correspondentes aos bits de 'pot', com O(log pot) produtos de matrizes em áreas de trabalho alocadas uma só vez.
+	int n = nrows;
+	if (pot == 0) {
+		return fident(n);
+		}
+	float * pR = (float *) malloc(n * n * sizeof(float));
+	float * pB = (float *) malloc(n * n * sizeof(float));
+	float * pT = (float *) malloc(n * n * sizeof(float));
+	if (pR == NULL || pB == NULL || pT == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", n, 3 * n);
+		exit(7);
+		}
+	for (int i = 0; i < n; ++ i) {
+		memcpy(pB + i * n, pmat + i * ncols, n * sizeof(float));
+		}
+	bool primeiro = true;
+	for (int p = pot; p > 0; p >>= 1) {
+		if (p & 1) {
+			// R = R B
+			if (primeiro) {
+				memcpy(pR, pB, n * n * sizeof(float));
+				primeiro = false;
+				}
+			else {
+				cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pR, n, pB, n, 0, pT, n);
+				flops_ += 2LL * n * n * n;
+				float * paux = pR;
+				pR = pT;
+				pT = paux;
+				}
+			}
+		if (p > 1) {
+			// B = B^2
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pB, n, pB, n, 0, pT, n);
+			flops_ += 2LL * n * n * n;
+			float * paux = pB;
+			pB = pT;
+			pT = paux;
+			}
+		}
+	free(pB);
+	free(pT);
+	if (debuglevel_ >= 2) {
+		printf("A^%d", pot);
+		fshowmat(pR, n, n, "");
+		}
+	return pR;
+	}
+
+float * fexpm(float * pmat, int nrows, int ncols) {
+// Retorna a exponencial da matriz, e^A, pelo método de escalonamento e quadrados sucessivos com aproximação de Padé (PADE_EXPM, PADE_EXPM):
+// A é dividida por 2^s para que ||A / 2^s||_1 <= 1/2, e^(A / 2^s) ~ D^-1 N e o resultado é elevado ao quadrado 's' vezes.
+	int n = nrows, q = PADE_EXPM;
+	// Norma 1 (máxima soma absoluta das colunas)
+	float norm = 0;
+	for (int j = 0; j < n; ++ j) {
+		float sum = 0;
+		for (int i = 0; i < n; ++ i) {
+			sum += fabs(pmat[i * ncols + j]);
+			}
+		norm = (sum > norm) ? sum : norm;
+		}
+	flops_ += n * n;
+	int s = 0;
+	if (norm > 0.5) {
+		s = (int) ceil(log(norm / 0.5) / log(2.0));
+		flops_ += 2 * FLOPS_LOG + FLOPS_DIV;
+		}
+	float escala = ldexp(1.0, - s);
+	float * pA = (float *) malloc(n * n * sizeof(float));
+	float * pX = (float *) malloc(n * n * sizeof(float));
+	float * pT = (float *) malloc(n * n * sizeof(float));
+	float * pN = fident(n);
+	float * pD = (float *) calloc(n * (n + 1), sizeof(float));
+	if (pA == NULL || pX == NULL || pT == NULL || pD == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", n, 5 * n);
+		exit(7);
+		}
+	for (int i = 0; i < n; ++ i) {
+		for (int j = 0; j < n; ++ j) {
+			pA[i * n + j] = pmat[i * ncols + j] * escala;
+			}
+		}
+	flops_ += n * n;
+	// N = sum c_k A^k e D = sum (-1)^k c_k A^k, com D na forma de sistema (n x n + 1) para a decomposição LU
+	memcpy(pX, pA, n * n * sizeof(float));
+	double c = 1;
+	for (int k = 1; k <= q; ++ k) {
+		c = c * (q - k + 1) / (k * (2 * q - k + 1));
+		if (k > 1) {
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pA, n, pX, n, 0, pT, n);
+			flops_ += 2LL * n * n * n;
+			float * paux = pX;
+			pX = pT;
+			pT = paux;
+			}
+		float cd = (k & 1) ? - c : c;
+		for (int i = 0; i < n; ++ i) {
+			for (int j = 0; j < n; ++ j) {
+				pN[i * n + j] += c * pX[i * n + j];
+				pD[i * (n + 1) + j] += cd * pX[i * n + j];
+				}
+			}
+		flops_ += 4 * n * n + 4 + FLOPS_DIV;
+		}
+	for (int i = 0; i < n; ++ i) {
+		pD[i * (n + 1) + i] += 1;
+		}
+	// e^(A / 2^s) ~ D^-1 N
+	float * pL, * pU;
+	int * pP;
+	f2LU(pD, n, & pL, & pU, & pP, NULL);
+	fdoLUblk(pN, pX, n, pL, pU, pP, n);
+	free(pL);
+	free(pU);
+	free(pP);
+	// e^A = (e^(A / 2^s))^(2^s)
+	for (int k = 0; k < s; ++ k) {
+		cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pX, n, pX, n, 0, pT, n);
+		flops_ += 2LL * n * n * n;
+		float * paux = pX;
+		pX = pT;
+		pT = paux;
+		}
+	free(pA);
+	free(pT);
+	free(pN);
+	free(pD);
+	if (debuglevel_ >= 2) {
+		fshowmat(pX, n, n, "e^A");
+		}
+	return pX;
+	}
+	
+double * dmmult(double * pA, int nrowA, int ncolA, double * pB, int nrowB, int ncolB) {
+// Retorna o resultado da multiplicação das matrizes A e B em precisão dupla.
+	int sizeC = nrowA * ncolB;
+	double * pvals;
+	pvals = (double *) calloc(sizeC, sizeof(double));
+	if (pvals == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
+		exit(7);
+		}
+	for (int i = 0; i < nrowA; ++ i) {
+		for (int j = 0; j < ncolB; ++ j) {
+			for (int k = 0; k < ncolA; ++ k) {
+				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
+				++ flops_;				
+				}
+			}
+		}
+	if (debuglevel_ >= 2) {
+		dshowmat(pA, nrowA, ncolA, "A x B = C (double) \n A");
+		dshowmat(pB, nrowB, ncolB, "B");
+		dshowmat(pvals, nrowA, ncolB, "C");
+		}
+	return pvals;
+	}
+
+long double * ldmmult(long double * pA, int nrowA, int ncolA, long double * pB, int nrowB, int ncolB) {
+// Retorna o resultado da multiplicação das matrizes A e B em precisão estendida.
+	int sizeC = nrowA * ncolB;
+	long double * pvals;
+	pvals = (long double *) calloc(sizeC, sizeof(long double));
+	if (pvals == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
+		exit(7);
+		}
+	for (int i = 0; i < nrowA; ++ i) {
+		for (int j = 0; j < ncolB; ++ j) {
+			for (int k = 0; k < ncolA; ++ k) {
+				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
+				++ flops_;				
+				}
+			}
+		}
+	if (debuglevel_ >= 2) {
+		ldshowmat(pA, nrowA, ncolA, "A x B = C (long double) \n A");
+		ldshowmat(pB, nrowB, ncolB, "B");
+		ldshowmat(pvals, nrowA, ncolB, "C");
+		}
+	return pvals;
+	}
+
+
+// Funções para solução dos sistemas em diversas precisões
+// ... Eliminação Gaussiana com pivotação
+float * finvG(float * pmat, int rank, int ncols, float * pdet) {
+// Retorna a matriz inversa obtida por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+	int ncolsSys = 2 * rank;
+	float * pSys = (float *) calloc(rank * ncolsSys, sizeof(float));	
+	if (pSys == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncolsSys);
 		exit(7);
 		}
-	int ncols = rank + nrhs;
 	for (int i = 0; i < rank; ++ i) {
 		for (int j = 0; j < rank; ++ j) {
-			pA[i * rank + j] = psys[i * ncols + j];
-			}
-		for (int j = 0; j < nrhs; ++ j) {
-			pB[i * nrhs + j] = psys[i * ncols + j + rank];
+			pSys[i * ncolsSys + j] = pmat[i * ncols + j];
 			}
+		pSys[i * ncolsSys + rank + i] = 1;
 		}
-	if (debuglevel_ == 2) {
-		fshowmat(pA, rank, rank, "A");
-		fshowmat(pB, rank, nrhs, "B");
-		}
-	lapack_int retcode = LAPACKE_sgels(LAPACK_ROW_MAJOR, 'N', rank, rank, nrhs, pA, rank, pB, nrhs);
-	if (retcode != 0) {
-		printf("Função LAPACKE_sgels retornou erro no argumento %d", -retcode);
-		exit(10);
+	if (debuglevel_ >= 2) {
+		fshowmat(pmat, rank, ncols, "pmat");
+		fshowmat(pSys, rank, ncolsSys, "pSys");
 		}
-	if (debuglevel_ == 2) {
-		fshowmat(pA, rank, nrhs, "X");
+	float * pTS = f2tri(pSys, rank, ncolsSys, pdet);
+	if (debuglevel_ >= 2) {
+		fshowmat(pTS, rank, ncolsSys, "pTS");
 		}
-	free(pA);
-	return pB;
-	}
-
-	
-// Funções para cópia das matrizes em diversas precisões	
-float * fmcopy(double * psrc, int nrows, int ncols) {
-// Retorna uma cópia em precisão simples (32 bits) da matriz 'psrc'
-	float * pdst, * result;
-	int size = nrows * ncols;
-	result = pdst = (float *) malloc (size * sizeof(float));
-	if (pdst == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+	free(pSys);
+	pSys = (float *) calloc(rank * (rank + 1), sizeof(float));
+	if (pSys == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank + 1);
 		exit(7);
 		}
-	while (size -- > 0) {
-		* pdst ++ = * psrc ++;
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			pSys[i * (rank + 1) + j] = pTS[i * ncolsSys + j];
+			}
 		}
-	return result;
-	}
-	
-long double * ldmcopy(double * psrc, int nrows, int ncols) {
-// Retorna uma cópia em precisão estendida (80 bits) da matriz 'psrc'
-	long double * pdst, * result;
-	int size = nrows * ncols;
-	result = pdst = (long double *) malloc (size * sizeof(long double));
-	if (pdst == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+	float * pInv = (float *) malloc(rank * rank * sizeof(float));
+	if (pInv == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
 		exit(7);
 		}
-	while (size -- > 0) {
-		double dvalor;
-		long double ldvalor;
-		dvalor = * psrc ++;
-		ldvalor = dvalor;
-		* pdst ++ = ldvalor;
+	for (int j = 0; j < rank; ++ j) {
+		for (int i = 0; i < rank; ++ i) {
+			pSys[i * (rank + 1) + rank] = pTS[i * ncolsSys + rank + j];
+			}
+		if (debuglevel_ >= 2) {
+			fshowmat(pSys, rank, rank + 1, "pSys");
+			}
+		float * result = fmtrisolve(pSys, rank, rank + 1, true);
+		if (debuglevel_ >= 2) {
+			fshowmat(result, rank, 1, "Resultado");
+			}
+		for (int i = 0; i < rank; ++ i) {
+			pInv[i * rank  + j] = result[i];
+			}
+		free(result);
+		}
+	return pInv;
+	}
+
+float * fsolveG(float * psrc, int rank, float * pdet) {
+// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+	float * pTS = f2tri(psrc, rank, rank + 1, pdet);
+	float * result = fmtrisolve(pTS, rank, rank + 1, true);
+	if (debuglevel_ >= 2) {
+		fshowmat(result, rank, 1, "Resultado");
 		}
 	return result;
 	}
 
-float * fmslice(double * psrc, int nrsrc, int ncsrc, int nrdst, int ncdst, int ir, int ic) {
-	float * pdst, * result;
-	result = pdst = (float *) malloc (nrdst * ncdst * sizeof(float));
-	if (pdst == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrdst, ncdst);
+float * f2tri(float * psrc, int rank, int ncols, float * pdet) {
+// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+	float * pval = (float *) calloc(rank * ncols, sizeof(float));
+	if (pval == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < nrdst; ++ i) {
-		for (int j = 0; j < ncdst; ++ j) {
-			pdst[i * ncdst + j] = psrc[(ic + i) * ncsrc + j + ic];
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			pval[i * ncols + j] = psrc[i * ncols + j];
 			}
 		}
-	return result;
-	}
-	
-// Funções para multiplicação das matrizes em diversas precisões
-float * fmmult(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB) {
-// Retorna o resultado da multiplicação das matrizes A e B em precisão simples.
-	int sizeC = nrowA * ncolB;
-	float * pvals = (float *) calloc(sizeC, sizeof(float));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
-		exit(7);
+	if (debuglevel_ >= 2) {
+		fshowmat(pval, rank, ncols, "Inicialização");
 		}
-	for (int i = 0; i < nrowA; ++ i) {
-		for (int j = 0; j < ncolB; ++ j) {
-			for (int k = 0; k < ncolA; ++ k) {
-				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
-				++ flops_;
+	bool sinal = false;
+	float det = 1, maxval;
+	for (int j = 0; j < rank - 1; ++ j) {
+		int maxrow = ffindmax(pval, rank, ncols, j, true, j);
+		maxval = pval[maxrow * ncols + j];
+		if (maxval == 0) {
+			printf("Matriz singular! \n");
+			exit(8);
+			}
+		if (j != maxrow) {
+			sinal = ! sinal;
+			fchangerows(pval, rank, ncols, j, maxrow);
+			if (debuglevel_ >= 2) {
+				printf("Coluna %d pivoteamento\n", j);
+				fshowmat(pval, rank, ncols, "");
+				}
+			}
+		float invmaxval = 1 / maxval;
+		flops_ += FLOPS_DIV;
+		for (int i = j + 1; i < rank; ++ i) {
+			double multiplier = pval[i * ncols + j] * invmaxval;
+			++ flops_;
+			pval[i * ncols + j] = 0;
+			for (int k = j + 1; k < ncols; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;				
 				}
 			}
+		if (debuglevel_ >= 2) {
+			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
+			fshowmat(pval, rank, ncols, "");
+			}
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pA, nrowA, ncolA, "A x B = C (float) \n A");
-		fshowmat(pB, nrowB, ncolB, "B");
-		fshowmat(pvals, nrowA, ncolB, "C");
+	if (pdet != NULL) {
+		for (int i = 0; i < rank; ++ i) {
+			det *= pval[i * ncols + i];
+			++ flops_;		
+			}
+		* pdet = det * (sinal ? -1 : 1);
 		}
-	return pvals;
+	return pval;
 	}
 
-float * fpower(float * pmat, int nrows, int ncols, int pot) {
-// Retorna o resultado da potência 'pot' da matriz, com 'pot' >= 0
-	if (pot == 0) {
-		return fident(nrows);
+double * dsolveG(double * psrc, int rank, double * pdet) {
+// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
+	double * pTS = d2tri(psrc, rank, pdet);
+	double * result = (double *) malloc(rank * sizeof(double));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
+		exit(7);
 		}
-	float * pvals = (float *) malloc(nrows * nrows * sizeof(float));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, nrows);
+	result = dmtrisolve(pTS, rank, rank + 1, true);
+	if (debuglevel_ >= 2) {
+		dshowmat(result, rank, 1, "Resultado");
+		}
+	return result;
+	}
+
+double * d2tri(double * psrc, int rank, double * pdet) {
+// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
+	int ncols = rank + 1;
+	double * pval = (double *) calloc(rank * ncols, sizeof(double));
+	if (pval == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < nrows; ++ j) {
-			pvals[i * nrows + j] = pmat[i * ncols + j];
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j <= rank; ++ j) {
+			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
 			}
 		}
-	float * plast = pvals;
-	for (int i = 2; i <= pot; ++ i) {
-		float * result = fgemm(pvals, nrows, nrows, plast, nrows, nrows);
+	if (debuglevel_ >= 2) {
+		dshowmat(pval, rank, ncols, "Inicialização");
+		}
+	bool sinal = false;
+	double det = 1, maxval;
+	for (int j = 0; j < rank - 1; ++ j) {
+		int maxrow = dfindmax(pval, rank, ncols, j, true, j);
+		maxval = pval[maxrow * ncols + j];
+		if (maxval == 0) {
+			printf("Matriz singular! \n");
+			exit(8);
+			}
+		if (j != maxrow) {
+			sinal = ! sinal;
+			dchangerows(pval, rank, ncols, j, maxrow);
+			if (debuglevel_ >= 2) {
+				printf("Coluna %d pivoteamento\n", j);
+				dshowmat(pval, rank, ncols, "");
+				}
+			}
+		double invmaxval = 1 / maxval;
+		flops_ += FLOPS_DIV;
+		for (int i = j + 1; i < rank; ++ i) {
+			double multiplier = pval[i * ncols + j] * invmaxval;
+			++ flops_;			
+			pval[i * ncols + j] = 0;
+			for (int k = j + 1; k <= rank; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;				
+				}
+			}
 		if (debuglevel_ >= 2) {
-			printf("A^%d", i);
-			fshowmat(result, nrows, nrows, "");
+			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
+			dshowmat(pval, rank, ncols, "");
 			}
-		if (i > 2) {
-			free(plast);
+		}
+	if (pdet != NULL) {
+		for (int i = 0; i < rank; ++ i) {
+			det *= pval[i * ncols + i];
+			++ flops_;		
 			}
-		plast = result;
+		* pdet = det * (sinal ? -1 : 1);
 		}
-	return plast;
+	return pval;
 	}
-	
-double * dmmult(double * pA, int nrowA, int ncolA, double * pB, int nrowB, int ncolB) {
-// Retorna o resultado da multiplicação das matrizes A e B em precisão dupla.
-	int sizeC = nrowA * ncolB;
-	double * pvals;
-	pvals = (double *) calloc(sizeC, sizeof(double));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
+
+long double * ldsolveG(long double * psrc, int rank, long double * pdet) {
+// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
+	long double * pTS = ld2tri(psrc, rank, pdet);
+	long double * result = (long double *) malloc(rank * sizeof(long double));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
 		exit(7);
 		}
-	for (int i = 0; i < nrowA; ++ i) {
-		for (int j = 0; j < ncolB; ++ j) {
-			for (int k = 0; k < ncolA; ++ k) {
-				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
-				++ flops_;				
-				}
-			}
-		}
+	result = ldmtrisolve(pTS, rank, rank + 1, true);
 	if (debuglevel_ >= 2) {
-		dshowmat(pA, nrowA, ncolA, "A x B = C (double) \n A");
-		dshowmat(pB, nrowB, ncolB, "B");
-		dshowmat(pvals, nrowA, ncolB, "C");
+		ldshowmat(result, rank, 1, "Resultado");
 		}
-	return pvals;
+	return result;
 	}
 
-long double * ldmmult(long double * pA, int nrowA, int ncolA, long double * pB, int nrowB, int ncolB) {
-// Retorna o resultado da multiplicação das matrizes A e B em precisão estendida.
-	int sizeC = nrowA * ncolB;
-	long double * pvals;
-	pvals = (long double *) calloc(sizeC, sizeof(long double));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrowA, ncolB);
+long double * ld2tri(long double * psrc, int rank, long double * pdet) {
+// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão estendida.
+	int ncols = rank + 1;
+	long double * pval = (long double *) calloc(rank * ncols, sizeof(long double));
+	if (pval == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < nrowA; ++ i) {
-		for (int j = 0; j < ncolB; ++ j) {
-			for (int k = 0; k < ncolA; ++ k) {
-				pvals[i * ncolB + j] += pA[i * ncolA + k] * pB[k * ncolB + j];
-				++ flops_;				
-				}
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j <= rank; ++ j) {
+			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
 			}
 		}
 	if (debuglevel_ >= 2) {
-		ldshowmat(pA, nrowA, ncolA, "A x B = C (long double) \n A");
-		ldshowmat(pB, nrowB, ncolB, "B");
-		ldshowmat(pvals, nrowA, ncolB, "C");
+		ldshowmat(pval, rank, ncols, "Inicialização");
 		}
-	return pvals;
+	bool sinal = false;
+	long double det = 1, maxval;
+	for (int j = 0; j < rank - 1; ++ j) {
+		int maxrow = ldfindmax(pval, rank, ncols, j, true, j);
+		maxval = pval[maxrow * ncols + j];
+		if (maxval == 0) {
+			printf("Matriz singular! \n");
+			exit(8);
+			}
+		if (j != maxrow) {
+			sinal = ! sinal;
+			ldchangerows(pval, rank, ncols, j, maxrow);
+			if (debuglevel_ >= 2) {
+				printf("Coluna %d pivoteamento\n", j);
+				ldshowmat(pval, rank, ncols, "");
+				}
+			}
+		double invmaxval = 1 / maxval;
+		flops_ += FLOPS_DIV;
+		for (int i = j + 1; i < rank; ++ i) {
+			long double multiplier = pval[i * ncols + j] * invmaxval;
+			++ flops_;
+			pval[i * ncols + j] = 0;
+			for (int k = j + 1; k <= rank; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;
+				}
+			}
+		if (debuglevel_ >= 2) {
+			printf("Coluna %d eliminação. Pivô = %Lf\n", j, maxval);
+			ldshowmat(pval, rank, ncols, "");
+			}
+		}
+	if (pdet != NULL) {
+		for (int i = 0; i < rank; ++ i) {
+			det *= pval[i * ncols + i];
+			++ flops_;		
+			}
+		* pdet = det * (sinal ? -1 : 1);
+		}
+	return pval;
 	}
 
-
-// Funções para solução dos sistemas em diversas precisões
-// ... Eliminação Gaussiana com pivotação
-float * finvG(float * pmat, int rank, int ncols, float * pdet) {
-// Retorna a matriz inversa obtida por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+// ... Decomposição LU
+float * finvChol(float * pmat, int rank, int ncols, float * pdet) {
+// Retorna a matriz inversa obtida por Decomposição de Cholesky, em precisão simples.
 	int ncolsSys = 2 * rank;
 	float * pSys = (float *) calloc(rank * ncolsSys, sizeof(float));	
 	if (pSys == NULL) {
@@ -3497,6 +6800,7 @@ float * finvG(float * pmat, int rank, int ncols, float * pdet) {
 		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
 		exit(7);
 		}
+	debuglevel_ = 2;
 	for (int j = 0; j < rank; ++ j) {
 		for (int i = 0; i < rank; ++ i) {
 			pSys[i * (rank + 1) + rank] = pTS[i * ncolsSys + rank + j];
@@ -3513,30 +6817,209 @@ float * finvG(float * pmat, int rank, int ncols, float * pdet) {
 			}
 		free(result);
 		}
+	debuglevel_ = 0;
 	return pInv;
 	}
 
-float * fsolveG(float * psrc, int rank, float * pdet) {
-// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
-	float * pTS = f2tri(psrc, rank, rank + 1, pdet);
-	float * result = fmtrisolve(pTS, rank, rank + 1, true);
+int fmakeLU(float * pmat, int nrows, int ncols, float * values, int * position) {
+// Carrega as componentes L ou U da matriz com os valores 'values'.
+	for (int i = 0; i < nrows; ++ i) {
+		int pos = (position == NULL) ? i : position[i]; 
+		pmat[i * ncols + nrows] = values[pos];
+		}
 	if (debuglevel_ >= 2) {
-		fshowmat(result, rank, 1, "Resultado");
+		fshowmat(pmat, nrows, ncols, "Matriz L");
 		}
-	return result;
+	return 0;
+	}
+	
+int fsolveLU(float * psys, int nrows, int ncols, float ** ppX, float * pdet, int * piter, float * perror) {
+// Calcula a solução do sistema por decomposição LU com refinamentos sucessivos.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+// Indica a solução, o erro e o número de iterações necessário.
+	// Decomposição LU
+	float * pL, * pU;
+	int * pP;
+	f2LU(psys, nrows, & pL, & pU, & pP, pdet);
+	float * pA = (float *) malloc(nrows * nrows * sizeof(float));
+	float * pB = (float *) malloc(nrows * sizeof(float));
+	if (pA == NULL || pB == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows, nrows + 1);
+		exit(7);
+		}
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < nrows; ++ j) {
+			pA [i * nrows + j] = psys[i * ncols + j];
+			}
+		pB [i] = psys[i * ncols + nrows]; 
+		}
+	// Resolve o sistema
+	float * result = fdoLU(pB, pL, pU, pP, nrows);
+	int retcode = 0;
+	// Refina a solução, se desejado
+	if (piter != NULL && perror != NULL) {
+		retcode = fiterate(1, & fiterLU, pA, pB, & result, piter, perror, pL, pU, pP, nrows);
+		}
+	* ppX = result;
+	if (debuglevel_ >= 2) {
+		fshowmat(result, nrows, 1, "Resultado");
+		}
+	return retcode;
+	}
+	
+float * fdoLU(float * pB, float * pL, float * pU, int * pP, int nrows) {
+// Resolve um sistema já preparado por meio de decomposição LU.
+	if (debuglevel_ >= 2) {
+		fshowmat(pL, nrows, nrows + 1, "L"); 
+		fshowmat(pU, nrows, nrows + 1, "U"); 
+		fshowmat(pB, nrows, 1, "b"); 
+		}
+	fmakeLU(pL, nrows, nrows + 1, pB, pP);
+	float * pval = fmtrisolve(pL, nrows, nrows + 1, false);
+	for (int i = 0; i < nrows; ++ i) {
+		pU[(i + 1) * (nrows + 1) - 1] = pval[i]; 
+		}
+	free(pval);
+	float * paux = fmtrisolve(pU, nrows, nrows + 1, true);
+	if (debuglevel_ >= 2) {
+		fshowmat(paux, nrows, 1, "x"); 
+		}
+	return paux;
 	}
 
-float * f2tri(float * psrc, int rank, int ncols, float * pdet) {
-// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+void fdoLUblk(float * pB, float * pX, int nrhs, float * pL, float * pU, int * pP, int nrows) {
+// Resolve A X = B, com 'nrhs' colunas em B, a partir da decomposição LU já preparada por f2LU.
+// As substituições percorrem as linhas uma única vez, tratando todas as colunas juntas, e não alocam memória.
+	int ncols = nrows + 1;
+	for (int i = 0; i < nrows; ++ i) {
+		int pos = (pP == NULL) ? i : pP[i];
+		for (int j = 0; j < nrhs; ++ j) {
+			pX[i * nrhs + j] = pB[pos * nrhs + j];
+			}
+		}
+	for (int i = 1; i < nrows; ++ i) {
+		float * pxi = pX + i * nrhs;
+		for (int k = 0; k < i; ++ k) {
+			float lik = pL[i * ncols + k];
+			if (lik == 0) {
+				continue;
+				}
+			float * pxk = pX + k * nrhs;
+			for (int j = 0; j < nrhs; ++ j) {
+				pxi[j] -= lik * pxk[j];
+				}
+			}
+		}
+	for (int i = nrows - 1; i >= 0; -- i) {
+		float * pxi = pX + i * nrhs;
+		for (int k = i + 1; k < nrows; ++ k) {
+			float uik = pU[i * ncols + k];
+			if (uik == 0) {
+				continue;
+				}
+			float * pxk = pX + k * nrhs;
+			for (int j = 0; j < nrhs; ++ j) {
+				pxi[j] -= uik * pxk[j];
+				}
+			}
+		float inv = 1 / pU[i * ncols + i];
+		for (int j = 0; j < nrhs; ++ j) {
+			pxi[j] *= inv;
+			}
+		}
+	flops_ += 2LL * nrows * nrows * nrhs + nrows * (nrhs + FLOPS_DIV);
+	}
+
+int fiterLU(float * pA, float * pB, float * pmerror, float * pcorr, float ** ppX, float * pL, float * pU, int * pP, int nrows) {	
+	float * pX = * ppX;
+	float * corr = fdoLU(pmerror, pL, pU, pP, nrows);
+	if (debuglevel_ >= 2) {
+		fshowmat(corr, nrows, 1, "Correção");
+		}
+	float mcorr = fmnormi(corr, nrows, 1);
+	float mX = fmnormi(pX, nrows, 1);
+	float finc = mcorr/mX;
+	++ flops_;
+	if (debuglevel_ >= 1) {
+		printf("Correção: %f \n", finc);
+		}
+	if (finc <= maxerr_) {
+		return 12;
+		}	
+	float * result = fmadd(pX, nrows, 1, corr, nrows, 1, true);
+	free(corr);
+	* ppX = result;
+	return 0;
+	}
+
+void f2LR(float * psrc, int rank, float ** ppL, float ** ppR){
+// Calcula o resultado da decomposição LR, em precisão simples.
+	int ncols = 2 * rank;
+	float * pval = (float *) calloc(rank * ncols, sizeof(float));
+	float * pL = (float *) calloc(rank * rank, sizeof(float));
+	float * pR = (float *) calloc(rank * rank, sizeof(float));
+	if (pval == NULL || pL == NULL || pR == NULL) {	
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 4 * rank);
+		exit(7);
+		}
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			pval[i * ncols + j] = psrc[i * rank + j];
+			}
+		}
+	if (debuglevel_ >= 2) {
+		fshowmat(pval, rank, ncols, "Inicialização");
+		}
+	for (int j = 0; j < rank - 1; ++ j) {
+		float invval = 1 / pval[j * ncols + j];
+		flops_ += FLOPS_DIV;
+		for (int i = j + 1; i < rank; ++ i) {
+			double multiplier = pval[i * ncols + j] * invval;
+			++ flops_;			
+			pval[i * ncols + j] = 0;
+			pval[i * ncols + rank + j] = multiplier;
+			for (int k = j + 1; k < rank; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;				
+				}
+			}
+		if (debuglevel_ >= 2) {
+			printf("Coluna %d eliminação. \n", j);
+			fshowmat(pval, rank, ncols, "");
+			}
+		}
+	for (int i = 0; i < rank; ++ i) {
+		pval[i * ncols + rank + i] = 1;
+		}
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			pR[i * rank + j] = pval[i * ncols + j];
+			}
+		for (int j = 0; j < rank; ++ j) {
+			pL[i * rank + j] = pval[i * ncols + j + rank];
+			}
+		}
+	* ppL = pL;
+	* ppR = pR;
+	return;
+	}
+	
+void f2LU(float * psrc, int rank, float ** ppL, float ** ppU, int ** ppP, float * pdet){
+// Calcula o resultado da decomposição LU e informa o valor do determinante, em precisão simples.
+	int ncols = 2 * rank + 1;
 	float * pval = (float *) calloc(rank * ncols, sizeof(float));
-	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
+	float * pL = (float *) calloc(rank * (rank + 1), sizeof(float));
+	float * pU = (float *) calloc(rank * (rank + 1), sizeof(float));
+	int * pP = (int *) malloc(rank * sizeof(int));
+	if (pval == NULL || pL == NULL || pU == NULL || pP == NULL) {	
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 4 * rank + 3);
 		exit(7);
 		}
 	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			pval[i * ncols + j] = psrc[i * ncols + j];
+		for (int j = 0; j < rank; ++ j) {
+			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
 			}
+		pval[(i + 1) * ncols - 1] = i;
 		}
 	if (debuglevel_ >= 2) {
 		fshowmat(pval, rank, ncols, "Inicialização");
@@ -3562,9 +7045,10 @@ float * f2tri(float * psrc, int rank, int ncols, float * pdet) {
 		flops_ += FLOPS_DIV;
 		for (int i = j + 1; i < rank; ++ i) {
 			double multiplier = pval[i * ncols + j] * invmaxval;
-			++ flops_;
+			++ flops_;			
 			pval[i * ncols + j] = 0;
-			for (int k = j + 1; k < ncols; ++ k) {
+			pval[i * ncols + rank + j] = multiplier;
+			for (int k = j + 1; k < rank; ++ k) {
 				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
 				flops_ += 2;				
 				}
@@ -3574,169 +7058,253 @@ float * f2tri(float * psrc, int rank, int ncols, float * pdet) {
 			fshowmat(pval, rank, ncols, "");
 			}
 		}
-	if (pdet != NULL) {
-		for (int i = 0; i < rank; ++ i) {
+	for (int i = 0; i < rank; ++ i) {
+		if (pdet != NULL) {
 			det *= pval[i * ncols + i];
-			++ flops_;		
+			++ flops_;
 			}
+		pval[i * ncols + rank + i] = 1;
+		}
+	if (pdet != NULL) {
 		* pdet = det * (sinal ? -1 : 1);
 		}
-	return pval;
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j < rank; ++ j) {
+			pU[i * (rank + 1) + j] = pval[i * ncols + j];
+			}
+		for (int j = 0; j < rank; ++ j) {
+			pL[i * (rank + 1) + j] = pval[i * ncols + j + rank];
+			}
+		pP[i] = pval[(i + 1) * ncols - 1];
+		}
+	* ppL = pL;
+	* ppU = pU;
+	* ppP = pP;
+	return;
 	}
-
-double * dsolveG(double * psrc, int rank, double * pdet) {
-// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
-	double * pTS = d2tri(psrc, rank, pdet);
-	double * result = (double *) malloc(rank * sizeof(double));
-	if (result == NULL) {
+	
+// ... Decomposição de Cholesky
+float * fsolveChol(float * psrc, int rank, float * pdet) {
+// Retorna a solução do sistema por decomposição de Cholesky e informa o valor do determinante, em precisão simples.
+	float * pL = f2Chol(psrc, rank, pdet);
+	if (pL == NULL) {
+		return NULL;
+		}
+	float * pU = ftranspose(pL, rank, rank + 1);
+	float * pB = (float *) malloc(rank * sizeof(float));
+	if (pB == NULL) {
 		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
 		exit(7);
 		}
-	result = dmtrisolve(pTS, rank, rank + 1, true);
 	if (debuglevel_ >= 2) {
-		dshowmat(result, rank, 1, "Resultado");
+		fshowmat(pU, rank, rank + 1, "Transposta");
+		}
+	for (int i = 0; i < rank; ++ i) {
+		pB[i] = psrc[i * (rank + 1) + rank]; 
+		}
+	float * result = fdoLU(pB, pL, pU, NULL, rank);
+	if (debuglevel_ >= 2) {
+		fshowmat(result, rank, 1, "Resultado");
 		}
 	return result;
 	}
 
-double * d2tri(double * psrc, int rank, double * pdet) {
-// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
+float * f2Chol(float * psrc, int rank, float * pdet) {
+// Retorna o resultado da decomposição de Cholesky e informa o valor do determinante, em precisão simples.
 	int ncols = rank + 1;
-	double * pval = (double *) calloc(rank * ncols, sizeof(double));
+	float * pdiv = (float *) malloc(rank * sizeof(float));
+	float * pval = (float *) calloc(rank * ncols, sizeof(float));
 	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
+		printf("Não conseguiu alocar memória para a matriz estendida %d x %d! \n", rank, ncols);
 		exit(7);
 		}
+	float det = 1;
 	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j <= rank; ++ j) {
-			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
+		float sum;
+		for (int j = 0; j <= i; ++ j) {
+			sum = 0;
+            for (int k = 0; k < j; ++ k) {
+				sum += pval[i * ncols + k] * pval[j * ncols + k];
+				flops_ += 2;
+				}
+            if (i == j) {
+				float quadrado = psrc[i * (rank + 2)] - sum;
+				if (quadrado <= 0) {
+					printf("A matriz não é definida positiva!");
+					return NULL;
+					}
+				float valor = sqrt(quadrado);
+				pval[i * ncols + i] = valor;
+				pdiv[i] = 1 / valor;
+				flops_ += 1 + FLOPS_SQRT + FLOPS_DIV;
+				if (pdet != NULL) {
+					det *= valor;
+					++ flops_;
+					}
+				if (debuglevel_ >= 3) {
+					printf("L%d%d = %f \t", i, j, valor);
+					}				
+				}
+			else {
+				float valor = (psrc[i * (rank + 1) + j] - sum) * pdiv[j];
+				pval[i * ncols + j] = valor;
+				flops_ += 2;
+				if (debuglevel_ >= 3) {
+					printf("L%d%d = %f \t", i, j, valor);
+					}				
+				}
 			}
 		}
+	if (debuglevel_ >= 3) {
+		printf("\n");
+		}				
 	if (debuglevel_ >= 2) {
-		dshowmat(pval, rank, ncols, "Inicialização");
+		fshowmat(pval, rank, ncols, "Decomposição de Cholesky");
 		}
-	bool sinal = false;
-	double det = 1, maxval;
-	for (int j = 0; j < rank - 1; ++ j) {
-		int maxrow = dfindmax(pval, rank, ncols, j, true, j);
-		maxval = pval[maxrow * ncols + j];
-		if (maxval == 0) {
-			printf("Matriz singular! \n");
-			exit(8);
-			}
-		if (j != maxrow) {
-			sinal = ! sinal;
-			dchangerows(pval, rank, ncols, j, maxrow);
-			if (debuglevel_ >= 2) {
-				printf("Coluna %d pivoteamento\n", j);
-				dshowmat(pval, rank, ncols, "");
-				}
+	if (pdet != NULL) {
+		* pdet = det * det;
+		++ flops_;
+		}
+	return pval;
+	}
+	
+// ... auxiliares para vários métodos
+int ffindmax(float * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
+// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão simples.
+	float maxval = 0;
+	int i, address, maxpos = start;
+	int size = colmode ? nrows : ncols;
+	for (i = start; i < size; ++ i) {
+		if (colmode) {
+			address = i * ncols + pos;
 			}
-		double invmaxval = 1 / maxval;
-		flops_ += FLOPS_DIV;
-		for (int i = j + 1; i < rank; ++ i) {
-			double multiplier = pval[i * ncols + j] * invmaxval;
-			++ flops_;			
-			pval[i * ncols + j] = 0;
-			for (int k = j + 1; k <= rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;				
-				}
+		else {
+			address = pos * nrows + i;
 			}
-		if (debuglevel_ >= 2) {
-			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
-			dshowmat(pval, rank, ncols, "");
+		float value = fabs(pmat[address]);
+		if (maxval < value) {
+			maxval = value;
+			maxpos = i;
 			}
 		}
-	if (pdet != NULL) {
-		for (int i = 0; i < rank; ++ i) {
-			det *= pval[i * ncols + i];
-			++ flops_;		
+	return maxpos;
+	}
+	
+void fchangerows(float * pmat, int rows, int ncols, int row1, int row2) {
+// Troca duas linhas de posição, em precisão simples.
+	int row1pos = row1 * ncols;
+	int row2pos = row2 * ncols;
+	for (int j = 0; j < ncols; ++ j) {
+		float value = pmat[row1pos + j];
+		pmat[row1pos + j] = pmat[row2pos + j];
+		pmat[row2pos + j] = value;
+		}
+	}
+
+int dfindmax(double * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
+// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão dupla.
+	double maxval = 0;
+	int i, address, maxpos = start;
+	int size = colmode ? nrows : ncols;
+	for (i = start; i < size; ++ i) {
+		if (colmode) {
+			address = i * ncols + pos;
+			}
+		else {
+			address = pos * nrows + i;
+			}
+		double value = fabs(pmat[address]);
+		if (maxval < value) {
+			maxval = value;
+			maxpos = i;
 			}
-		* pdet = det * (sinal ? -1 : 1);
 		}
-	return pval;
+	return maxpos;
+	}
+	
+void dchangerows(double * pmat, int rows, int ncols, int row1, int row2) {
+// Troca duas linhas de posição, em precisão dupla.
+	int row1pos = row1 * ncols;
+	int row2pos = row2 * ncols;
+	for (int j = 0; j < ncols; ++ j) {
+		double value = pmat[row1pos + j];
+		pmat[row1pos + j] = pmat[row2pos + j];
+		pmat[row2pos + j] = value;
+		}
 	}
 
-long double * ldsolveG(long double * psrc, int rank, long double * pdet) {
-// Retorna a solução do sistema por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão dupla.
-	long double * pTS = ld2tri(psrc, rank, pdet);
-	long double * result = (long double *) malloc(rank * sizeof(long double));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
+int ldfindmax(long double * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
+// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão estendida.	
+	long double maxval = 0;
+	int i, address, maxpos = start;
+	int size = colmode ? nrows : ncols;
+	for (i = start; i < size; ++ i) {
+		if (colmode) {
+			address = i * ncols + pos;
+			}
+		else {
+			address = pos * nrows + i;
+			}
+		long double value = fabs(pmat[address]);
+		if (maxval < value) {
+			maxval = value;
+			maxpos = i;
+			}
+		}
+	return maxpos;
+	}
+	
+void ldchangerows(long double * pmat, int rows, int ncols, int row1, int row2) {
+// Troca duas linhas de posição, em precisão estendida.
+	int row1pos = row1 * ncols;
+	int row2pos = row2 * ncols;
+	for (int j = 0; j < ncols; ++ j) {
+		long double value = pmat[row1pos + j];
+		pmat[row1pos + j] = pmat[row2pos + j];
+		pmat[row2pos + j] = value;
+		}
+	}
+
+float * ftranspose(float * psrc, int nrows, int ncols) {
+// Retorna a transposta da matriz, em precisão simples.
+	float * pdst = (float *) malloc(nrows * ncols * sizeof(float));
+	if (pdst == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
 		exit(7);
 		}
-	result = ldmtrisolve(pTS, rank, rank + 1, true);
-	if (debuglevel_ >= 2) {
-		ldshowmat(result, rank, 1, "Resultado");
-		}
-	return result;
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			pdst[j * nrows + i] = psrc[i * ncols + j];
+			}
+ 		}
+	return pdst;
 	}
 
-long double * ld2tri(long double * psrc, int rank, long double * pdet) {
-// Retorna o resultado da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão estendida.
-	int ncols = rank + 1;
-	long double * pval = (long double *) calloc(rank * ncols, sizeof(long double));
-	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
+float * f2sys(float * psrc, float * pval, int rank) {
+// Monta um sistema a partir de uma matriz quadrada e um vetor de valores, em precisão simples.
+	float * pdst = (float *) malloc(rank * (rank + 1) * sizeof(float));
+	if (pdst == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank + 1);
 		exit(7);
 		}
 	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j <= rank; ++ j) {
-			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
+		for (int j = 0; j < rank; ++ j) {
+			pdst[i * (rank + 1) + j] = psrc[i * rank + j]; 
 			}
+		pdst[(i + 1) * (rank + 1) - 1] = pval[i]; 
 		}
 	if (debuglevel_ >= 2) {
-		ldshowmat(pval, rank, ncols, "Inicialização");
-		}
-	bool sinal = false;
-	long double det = 1, maxval;
-	for (int j = 0; j < rank - 1; ++ j) {
-		int maxrow = ldfindmax(pval, rank, ncols, j, true, j);
-		maxval = pval[maxrow * ncols + j];
-		if (maxval == 0) {
-			printf("Matriz singular! \n");
-			exit(8);
-			}
-		if (j != maxrow) {
-			sinal = ! sinal;
-			ldchangerows(pval, rank, ncols, j, maxrow);
-			if (debuglevel_ >= 2) {
-				printf("Coluna %d pivoteamento\n", j);
-				ldshowmat(pval, rank, ncols, "");
-				}
-			}
-		double invmaxval = 1 / maxval;
-		flops_ += FLOPS_DIV;
-		for (int i = j + 1; i < rank; ++ i) {
-			long double multiplier = pval[i * ncols + j] * invmaxval;
-			++ flops_;
-			pval[i * ncols + j] = 0;
-			for (int k = j + 1; k <= rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;
-				}
-			}
-		if (debuglevel_ >= 2) {
-			printf("Coluna %d eliminação. Pivô = %Lf\n", j, maxval);
-			ldshowmat(pval, rank, ncols, "");
-			}
-		}
-	if (pdet != NULL) {
-		for (int i = 0; i < rank; ++ i) {
-			det *= pval[i * ncols + i];
-			++ flops_;		
-			}
-		* pdet = det * (sinal ? -1 : 1);
+		fshowmat(pdst, rank, rank + 1, "Sistema");
 		}
-	return pval;
+	return pdst;
 	}
+	
 
-// ... Decomposição LU
-float * finvChol(float * pmat, int rank, int ncols, float * pdet) {
-// Retorna a matriz inversa obtida por Decomposição de Cholesky, em precisão simples.
-	int ncolsSys = 2 * rank;
-	float * pSys = (float *) calloc(rank * ncolsSys, sizeof(float));	
+// Funções para resover sistemas triangulares em diversas precisões
+float * finvTS(float * pmat, int rank, int ncols, bool superior) {
+// Retorna a matriz inversa obtida por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+	int ncolsSys = rank + 1;
+	float * pSys = (float *) malloc(rank * ncolsSys * sizeof(float));	
 	if (pSys == NULL) {
 		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncolsSys);
 		exit(7);
@@ -3745,1254 +7313,2360 @@ float * finvChol(float * pmat, int rank, int ncols, float * pdet) {
 		for (int j = 0; j < rank; ++ j) {
 			pSys[i * ncolsSys + j] = pmat[i * ncols + j];
 			}
-		pSys[i * ncolsSys + rank + i] = 1;
 		}
 	if (debuglevel_ >= 2) {
 		fshowmat(pmat, rank, ncols, "pmat");
 		fshowmat(pSys, rank, ncolsSys, "pSys");
 		}
-	float * pTS = f2tri(pSys, rank, ncolsSys, pdet);
-	if (debuglevel_ >= 2) {
-		fshowmat(pTS, rank, ncolsSys, "pTS");
-		}
-	free(pSys);
-	pSys = (float *) calloc(rank * (rank + 1), sizeof(float));
-	if (pSys == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank + 1);
-		exit(7);
-		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pSys[i * (rank + 1) + j] = pTS[i * ncolsSys + j];
-			}
-		}
 	float * pInv = (float *) malloc(rank * rank * sizeof(float));
 	if (pInv == NULL) {
 		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
 		exit(7);
 		}
-	debuglevel_ = 2;
 	for (int j = 0; j < rank; ++ j) {
 		for (int i = 0; i < rank; ++ i) {
-			pSys[i * (rank + 1) + rank] = pTS[i * ncolsSys + rank + j];
+			pSys[i * ncolsSys + rank] = (i == j) ? 1 : 0;
 			}
 		if (debuglevel_ >= 2) {
-			fshowmat(pSys, rank, rank + 1, "pSys");
+			fshowmat(pSys, rank, ncolsSys, "pSys");
 			}
-		float * result = fmtrisolve(pSys, rank, rank + 1, true);
+		float * result = fmtrisolve(pSys, rank, ncolsSys, superior);
 		if (debuglevel_ >= 2) {
 			fshowmat(result, rank, 1, "Resultado");
 			}
 		for (int i = 0; i < rank; ++ i) {
-			pInv[i * rank  + j] = result[i];
+			pInv[i * rank + j] = result[i];
 			}
 		free(result);
 		}
-	debuglevel_ = 0;
-	return pInv;
-	}
-
-int fmakeLU(float * pmat, int nrows, int ncols, float * values, int * position) {
-// Carrega as componentes L ou U da matriz com os valores 'values'.
-	for (int i = 0; i < nrows; ++ i) {
-		int pos = (position == NULL) ? i : position[i]; 
-		pmat[i * ncols + nrows] = values[pos];
-		}
 	if (debuglevel_ >= 2) {
-		fshowmat(pmat, nrows, ncols, "Matriz L");
+		fshowmat(pInv, rank, rank, "Inversa");
 		}
-	return 0;
+	return pInv;
 	}
-	
-int fsolveLU(float * psys, int nrows, int ncols, float ** ppX, float * pdet, int * piter, float * perror) {
-// Calcula a solução do sistema por decomposição LU com refinamentos sucessivos.
-// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
-// Indica a solução, o erro e o número de iterações necessário.
-	// Decomposição LU
-	float * pL, * pU;
-	int * pP;
-	f2LU(psys, nrows, & pL, & pU, & pP, pdet);
-	float * pA = (float *) malloc(nrows * nrows * sizeof(float));
-	float * pB = (float *) malloc(nrows * sizeof(float));
-	if (pA == NULL || pB == NULL) {
-		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows, nrows + 1);
+
+float * fmtrisolve(float * pmat, int nrows, int ncols, bool superior) {
+	float * result;
+	result = (float *) malloc(nrows * sizeof(float));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < nrows; ++ j) {
-			pA [i * nrows + j] = psys[i * ncols + j];
+	if (superior) {
+		for (int i = nrows - 1; i >= 0; -- i) {
+			float divisor = pmat[i * ncols + i];
+			if (divisor == 0) {
+				printf("O sistema é singular! %d \n");
+				exit(8);
+				}
+			float invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			float sum = 0;
+			for (int j = i + 1; j < nrows; ++ j) {
+				float coef = pmat[i * ncols + j];
+				float x = result[j];
+				sum += coef * x;
+				flops_ += 2;				
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
+					}
+				}
+			float parm = pmat[i * ncols + nrows];
+			float valor = (parm - sum) * invdivisor;
+			++ flops_;			
+			result[i] = valor;
+			if (debuglevel_ >= 2) {
+				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+				}
 			}
-		pB [i] = psys[i * ncols + nrows]; 
-		}
-	// Resolve o sistema
-	float * result = fdoLU(pB, pL, pU, pP, nrows);
-	int retcode = 0;
-	// Refina a solução, se desejado
-	if (piter != NULL && perror != NULL) {
-		retcode = fiterate(1, & fiterLU, pA, pB, & result, piter, perror, pL, pU, pP, nrows);
-		}
-	* ppX = result;
-	if (debuglevel_ >= 2) {
-		fshowmat(result, nrows, 1, "Resultado");
-		}
-	return retcode;
-	}
-	
-float * fdoLU(float * pB, float * pL, float * pU, int * pP, int nrows) {
-// Resolve um sistema já preparado por meio de decomposição LU.
-	if (debuglevel_ >= 2) {
-		fshowmat(pL, nrows, nrows + 1, "L"); 
-		fshowmat(pU, nrows, nrows + 1, "U"); 
-		fshowmat(pB, nrows, 1, "b"); 
-		}
-	fmakeLU(pL, nrows, nrows + 1, pB, pP);
-	float * pval = fmtrisolve(pL, nrows, nrows + 1, false);
-	for (int i = 0; i < nrows; ++ i) {
-		pU[(i + 1) * (nrows + 1) - 1] = pval[i]; 
-		}
-	free(pval);
-	float * paux = fmtrisolve(pU, nrows, nrows + 1, true);
-	if (debuglevel_ >= 2) {
-		fshowmat(paux, nrows, 1, "x"); 
-		}
-	return paux;
-	}
-
-int fiterLU(float * pA, float * pB, float * pmerror, float * pcorr, float ** ppX, float * pL, float * pU, int * pP, int nrows) {	
-	float * pX = * ppX;
-	float * corr = fdoLU(pmerror, pL, pU, pP, nrows);
-	if (debuglevel_ >= 2) {
-		fshowmat(corr, nrows, 1, "Correção");
 		}
-	float mcorr = fmnormi(corr, nrows, 1);
-	float mX = fmnormi(pX, nrows, 1);
-	float finc = mcorr/mX;
-	++ flops_;
-	if (debuglevel_ >= 1) {
-		printf("Correção: %f \n", finc);
-		}
-	if (finc <= maxerr_) {
-		return 12;
-		}	
-	float * result = fmadd(pX, nrows, 1, corr, nrows, 1, true);
-	free(corr);
-	* ppX = result;
-	return 0;
+	else {
+		for (int i = 0; i < nrows; ++ i) {
+			float divisor = pmat[i * ncols + i];
+			if (divisor == 0) {
+				printf("O sistema é singular! \n");
+				exit(8);
+				}
+			float invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			float sum = 0;
+			for (int j = 0; j < i; ++ j) {
+				float coef = pmat[i * ncols + j];
+				float x = result[j];
+				sum += coef * x;
+				flops_ += 2;
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
+					}
+				}
+			float parm = pmat[i * ncols + nrows];
+			float valor = (parm - sum) * invdivisor;
+			++ flops_;			
+			result[i] = valor;
+			if (debuglevel_ >= 2) {
+				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+				}
+			}
+		}
+	return result;
 	}
 
-void f2LR(float * psrc, int rank, float ** ppL, float ** ppR){
-// Calcula o resultado da decomposição LR, em precisão simples.
-	int ncols = 2 * rank;
-	float * pval = (float *) calloc(rank * ncols, sizeof(float));
-	float * pL = (float *) calloc(rank * rank, sizeof(float));
-	float * pR = (float *) calloc(rank * rank, sizeof(float));
-	if (pval == NULL || pL == NULL || pR == NULL) {	
-		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 4 * rank);
+double * dmtrisolve(double * pmat, int nrows, int ncols, bool superior) {
+	double * result;
+	result = (double *) malloc(nrows * sizeof(double));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pval[i * ncols + j] = psrc[i * rank + j];
-			}
-		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pval, rank, ncols, "Inicialização");
-		}
-	for (int j = 0; j < rank - 1; ++ j) {
-		float invval = 1 / pval[j * ncols + j];
-		flops_ += FLOPS_DIV;
-		for (int i = j + 1; i < rank; ++ i) {
-			double multiplier = pval[i * ncols + j] * invval;
+	if (superior) {
+		for (int i = nrows - 1; i >= 0; -- i) {
+			double divisor = pmat[i * (ncols + 1)];
+			if (divisor == 0) {
+				printf("O sistema é singular! \n");
+				exit(8);
+				}
+			double invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			double sum = 0;
+			for (int j = i + 1; j < nrows; ++ j) {
+				double coef = pmat[i * ncols + j];
+				double x = result[j];
+				sum += coef * x;
+				flops_ += 2;
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
+					}
+				}
+			double parm = pmat[(i + 1) * ncols - 1];
+			double valor = (parm - sum) * invdivisor;
 			++ flops_;			
-			pval[i * ncols + j] = 0;
-			pval[i * ncols + rank + j] = multiplier;
-			for (int k = j + 1; k < rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;				
+			result[i] = valor;
+			if (debuglevel_ >= 2) {
+				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
 				}
 			}
-		if (debuglevel_ >= 2) {
-			printf("Coluna %d eliminação. \n", j);
-			fshowmat(pval, rank, ncols, "");
-			}
-		}
-	for (int i = 0; i < rank; ++ i) {
-		pval[i * ncols + rank + i] = 1;
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pR[i * rank + j] = pval[i * ncols + j];
-			}
-		for (int j = 0; j < rank; ++ j) {
-			pL[i * rank + j] = pval[i * ncols + j + rank];
+	else {
+		for (int i = 0; i < nrows; ++ i) {
+			double divisor = pmat[i * (ncols + 1)];
+			if (divisor == 0) {
+				printf("O sistema é singular! \n");
+				exit(8);
+				}
+			float invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			double sum = 0;
+			for (int j = 0; j < i; ++ j) {
+				double coef = pmat[i * ncols + j];
+				double x = result[j];
+				sum += coef * x;
+				flops_ += 2;
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
+					}
+				}
+			double parm = pmat[(i + 1) * ncols - 1];
+			double valor = (parm - sum) * invdivisor;
+			++ flops_;			
+			result[i] = valor;
+			if (debuglevel_ >= 2) {
+				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+				}
 			}
 		}
-	* ppL = pL;
-	* ppR = pR;
-	return;
+	return result;
 	}
 	
-void f2LU(float * psrc, int rank, float ** ppL, float ** ppU, int ** ppP, float * pdet){
-// Calcula o resultado da decomposição LU e informa o valor do determinante, em precisão simples.
-	int ncols = 2 * rank + 1;
-	float * pval = (float *) calloc(rank * ncols, sizeof(float));
-	float * pL = (float *) calloc(rank * (rank + 1), sizeof(float));
-	float * pU = (float *) calloc(rank * (rank + 1), sizeof(float));
-	int * pP = (int *) malloc(rank * sizeof(int));
-	if (pval == NULL || pL == NULL || pU == NULL || pP == NULL) {	
-		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", rank, 4 * rank + 3);
+long double * ldmtrisolve(long double * pmat, int nrows, int ncols, bool superior) {
+	long double * result;
+	result = (long double *) malloc(nrows * sizeof(long double));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
 		exit(7);
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
-			}
-		pval[(i + 1) * ncols - 1] = i;
-		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pval, rank, ncols, "Inicialização");
-		}
-	bool sinal = false;
-	float det = 1, maxval;
-	for (int j = 0; j < rank - 1; ++ j) {
-		int maxrow = ffindmax(pval, rank, ncols, j, true, j);
-		maxval = pval[maxrow * ncols + j];
-		if (maxval == 0) {
-			printf("Matriz singular! \n");
-			exit(8);
-			}
-		if (j != maxrow) {
-			sinal = ! sinal;
-			fchangerows(pval, rank, ncols, j, maxrow);
+	if (superior) {
+		for (int i = nrows - 1; i >= 0; -- i) {
+			long double divisor = pmat[i * (ncols + 1)];
+			if (divisor == 0) {
+				printf("O sistema é singular! \n");
+				exit(8);
+				}
+			long double invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			long double sum = 0;
+			for (int j = i + 1; j < nrows; ++ j) {
+				long double coef = pmat[i * ncols + j];
+				long double x = result[j];
+				sum += coef * x;
+				flops_ += 2;
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %Lf = %Lf * %Lf \n", j, sum, coef, x);
+					}
+				}
+			long double parm = pmat[(i + 1) * ncols - 1];
+			long double valor = (parm - sum) * invdivisor;
+			++ flops_;			
+			result[i] = valor;
 			if (debuglevel_ >= 2) {
-				printf("Coluna %d pivoteamento\n", j);
-				fshowmat(pval, rank, ncols, "");
+				printf("Linha %d: %Lf = (%Lf - %Lf) / %Lf \n", i, valor, parm, sum, divisor);
 				}
 			}
-		float invmaxval = 1 / maxval;
-		flops_ += FLOPS_DIV;
-		for (int i = j + 1; i < rank; ++ i) {
-			double multiplier = pval[i * ncols + j] * invmaxval;
+		}
+	else {
+		for (int i = 0; i < nrows; ++ i) {
+			long double divisor = pmat[i * (ncols + 1)];
+			if (divisor == 0) {
+				printf("O sistema é singular! \n");
+				exit(8);
+				}
+			long double invdivisor = 1 / divisor;
+			flops_ += FLOPS_DIV;
+			long double sum = 0;
+			for (int j = 0; j < i; ++ j) {
+				long double coef = pmat[i * ncols + j];
+				long double x = result[j];
+				flops_ += 2;
+				sum += coef * x;
+				if (debuglevel_ >= 3) {
+					printf("Coluna %d: %Lf = %Lf * %Lf \n", j, sum, coef, x);
+					}
+				}
+			long double parm = pmat[(i + 1) * ncols - 1];
+			long double valor = (parm - sum) * invdivisor;
 			++ flops_;			
-			pval[i * ncols + j] = 0;
-			pval[i * ncols + rank + j] = multiplier;
-			for (int k = j + 1; k < rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;				
+			result[i] = valor;
+			if (debuglevel_ >= 2) {
+				printf("Linha %d: %Lf = (%Lf - %Lf) / %Lf \n", i, valor, parm, sum, divisor);
 				}
 			}
-		if (debuglevel_ >= 2) {
-			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
-			fshowmat(pval, rank, ncols, "");
-			}
 		}
-	for (int i = 0; i < rank; ++ i) {
-		if (pdet != NULL) {
-			det *= pval[i * ncols + i];
-			++ flops_;
+	return result;
+	}
+
+	
+// Funções para cálculo das normas das matrizes em diversas precisões
+float fmnormi(float * pmat, int nrow, int ncol) {
+	if (pmat == NULL) {
+		return 0;
+		}
+	int size = nrow * ncol;
+	float max = 0;
+	while (size -- > 0) {
+		float valor = fabs(* pmat ++);
+		max = (valor > max) ? valor : max;
+		}
+	return max;
+	}
+
+float fmnorm2(float * pmat, int nrow, int ncol) {
+	if (pmat == NULL) {
+		return 0;
+		}
+	int size = nrow * ncol;
+	float sum = 0;
+	while (size -- > 0) {
+		float valor = * pmat ++;
+		sum += valor * valor;
+		flops_ += 2;
+		}
+	return sqrt(sum);
+	}
+
+double dmnorm2(double * pmat, int nrow, int ncol) {
+	if (pmat == NULL) {
+		return 0;
+		}
+	int size = nrow * ncol;
+	double sum = 0;
+	while (size -- > 0) {
+		double valor = * pmat ++;
+		sum += valor * valor;
+		flops_ += 2;		
+		}
+	return sqrt(sum);
+	}
+
+long double ldmnorm2(long double * pmat, int nrow, int ncol) {
+	if (pmat == NULL) {
+		return 0;
+		}
+	int size = nrow * ncol;
+	long double sum = 0;
+	while (size -- > 0) {
+		long double valor = * pmat ++;
+		sum += valor * valor;
+		flops_ += 2;		
+		}
+	return sqrt(sum);
+	}
+
+// Funções para exibição de matrizes em diversas precisões
+void fshowmat(float * pmat, int nrows, int ncols, const char * header) {
+	if (header != NULL && strlen(header) > 0) {
+		printf("%s \n", header);
+		}
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			printf(" %f ", pmat[i * ncols + j]);
 			}
-		pval[i * ncols + rank + i] = 1;
+		printf("\n");
 		}
-	if (pdet != NULL) {
-		* pdet = det * (sinal ? -1 : 1);
+	}
+
+void dshowmat(double * pmat, int nrows, int ncols, const char * header) {
+	if (header != NULL && strlen(header) > 0) {
+		printf("%s \n", header);
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pU[i * (rank + 1) + j] = pval[i * ncols + j];
-			}
-		for (int j = 0; j < rank; ++ j) {
-			pL[i * (rank + 1) + j] = pval[i * ncols + j + rank];
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			printf(" %f ", pmat[i * ncols + j]);
 			}
-		pP[i] = pval[(i + 1) * ncols - 1];
+		printf("\n");
 		}
-	* ppL = pL;
-	* ppU = pU;
-	* ppP = pP;
-	return;
 	}
-	
-// ... Decomposição de Cholesky
-float * fsolveChol(float * psrc, int rank, float * pdet) {
-// Retorna a solução do sistema por decomposição de Cholesky e informa o valor do determinante, em precisão simples.
-	float * pL = f2Chol(psrc, rank, pdet);
-	if (pL == NULL) {
-		return NULL;
+
+void ldshowmat(long double * pmat, int nrows, int ncols, const char * header) {
+	if (header != NULL && strlen(header) > 0) {
+		printf("%s \n", header);
 		}
-	float * pU = ftranspose(pL, rank, rank + 1);
-	float * pB = (float *) malloc(rank * sizeof(float));
-	if (pB == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
-		exit(7);
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			printf(" %f ", pmat[i * ncols + j]);
+			}
+		printf("\n");
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pU, rank, rank + 1, "Transposta");
+	}
+	
+
+// Outras funções úteis
+void ucrono(bool init, int divisor) {
+// Marca os tempos transcorridos entre chamadas
+	static double wstart, wend;
+    static HANDLE hProcess;
+    static FILETIME ftCreation, ftExit, ftKernel, ftUser1, ftUser2;
+    static SYSTEMTIME stUser1,stUser2;
+	if (init) {
+		// Inicializa as variáveis
+		hProcess = GetCurrentProcess();
 		}
-	for (int i = 0; i < rank; ++ i) {
-		pB[i] = psrc[i * (rank + 1) + rank]; 
+	if (divisor == 0) {
+		// Começa a contagem
+		GetProcessTimes(hProcess, &ftCreation, &ftExit, &ftKernel, &ftUser1);
+		wstart = omp_get_wtime();
 		}
-	float * result = fdoLU(pB, pL, pU, NULL, rank);
-	if (debuglevel_ >= 2) {
-		fshowmat(result, rank, 1, "Resultado");
+	else {
+		// Encerra a contagem e imprime o resultado
+		GetProcessTimes(hProcess, &ftCreation, &ftExit, &ftKernel, &ftUser2);	
+		wend = omp_get_wtime();
+		FileTimeToSystemTime(& ftUser1, & stUser1);
+		FileTimeToSystemTime(& ftUser2, & stUser2);
+		double twall = (1000.0 * (wend - wstart)) / divisor;
+		double tuser = (1000.0 * (stUser2.wSecond - stUser1.wSecond) + stUser2.wMilliseconds - stUser1.wMilliseconds) / divisor;
+		printf("Tempo gasto = %f ms, user time = %f ms \n", twall, tuser);
 		}
-	return result;
+	return;
 	}
 
-float * f2Chol(float * psrc, int rank, float * pdet) {
-// Retorna o resultado da decomposição de Cholesky e informa o valor do determinante, em precisão simples.
-	int ncols = rank + 1;
-	float * pdiv = (float *) malloc(rank * sizeof(float));
-	float * pval = (float *) calloc(rank * ncols, sizeof(float));
-	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz estendida %d x %d! \n", rank, ncols);
+float * feqcaracH(float * pmat, int nrows, int ncols, float * pdet) {
+// Retorna os coeficientes do polinômio característico da matriz 'pmat', na mesma convenção de feqcaracLF, reduzindo-a à forma de
+// Hessenberg e aplicando a recorrência de La Budde (Hyman) aos polinômios característicos das submatrizes principais, em O(n^3).
+// Também calcula o determinante, que é o termo independente do polinômio.
+	int n = nrows;
+	float * ph = f2hess(pmat, nrows, ncols);
+	// p_k (grau k) é o polinômio característico det(x I - H_k) da submatriz principal k x k; seus coeficientes ficam na linha k,
+	// do termo independente (coluna 0) ao de grau k
+	double * pp = (double *) calloc((n + 1) * (n + 1), sizeof(double));
+	float * coef = (float *) malloc((n + 1) * sizeof(float));
+	if (pp == NULL || coef == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n + 1, n + 2);
 		exit(7);
 		}
-	float det = 1;
-	for (int i = 0; i < rank; ++ i) {
-		float sum;
-		for (int j = 0; j <= i; ++ j) {
-			sum = 0;
-            for (int k = 0; k < j; ++ k) {
-				sum += pval[i * ncols + k] * pval[j * ncols + k];
-				flops_ += 2;
-				}
-            if (i == j) {
-				float quadrado = psrc[i * (rank + 2)] - sum;
-				if (quadrado <= 0) {
-					printf("A matriz não é definida positiva!");
-					return NULL;
-					}
-				float valor = sqrt(quadrado);
-				pval[i * ncols + i] = valor;
-				pdiv[i] = 1 / valor;
-				flops_ += 1 + FLOPS_SQRT + FLOPS_DIV;
-				if (pdet != NULL) {
-					det *= valor;
-					++ flops_;
-					}
-				if (debuglevel_ >= 3) {
-					printf("L%d%d = %f \t", i, j, valor);
-					}				
+	pp[0] = 1;
+	for (int k = 1; k <= n; ++ k) {
+		double * pk = pp + k * (n + 1), * pk1 = pk - (n + 1);
+		double hkk = ph[(k - 1) * n + k - 1];
+		// (x - h_kk) p_{k-1}
+		for (int j = 0; j < k; ++ j) {
+			pk[j + 1] += pk1[j];
+			pk[j] -= hkk * pk1[j];
+			}
+		// - sum_i h_ik (h_{i+1,i} ... h_{k,k-1}) p_{i-1}, com i de k - 1 a 1
+		double prod = 1;
+		for (int i = k - 1; i >= 1; -- i) {
+			prod *= ph[i * n + i - 1];
+			double f = ph[(i - 1) * n + k - 1] * prod;
+			if (f == 0) {
+				continue;
 				}
-			else {
-				float valor = (psrc[i * (rank + 1) + j] - sum) * pdiv[j];
-				pval[i * ncols + j] = valor;
-				flops_ += 2;
-				if (debuglevel_ >= 3) {
-					printf("L%d%d = %f \t", i, j, valor);
-					}				
+			double * pi = pp + (i - 1) * (n + 1);
+			for (int j = 0; j < i; ++ j) {
+				pk[j] -= f * pi[j];
 				}
+			flops_ += 2 * i;
 			}
+		flops_ += 3 * k + 2 * (k - 1);
 		}
-	if (debuglevel_ >= 3) {
-		printf("\n");
-		}				
-	if (debuglevel_ >= 2) {
-		fshowmat(pval, rank, ncols, "Decomposição de Cholesky");
+	// Converte para a convenção de feqcaracLF: x^n - q_1 x^(n-1) - ... - q_n, com q_i = - c_{n-i}
+	double * pn = pp + n * (n + 1);
+	for (int i = 1; i <= n; ++ i) {
+		coef[i] = - pn[n - i];
 		}
+	coef[0] = ((n + 1) & 1) ? -1 : 1;
 	if (pdet != NULL) {
-		* pdet = det * det;
-		++ flops_;
+		* pdet = (n & 1) ? - pn[0] : pn[0];
 		}
-	return pval;
+	free(pp);
+	free(ph);
+	return coef;
 	}
-	
-// ... auxiliares para vários métodos
-int ffindmax(float * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
-// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão simples.
-	float maxval = 0;
-	int i, address, maxpos = start;
-	int size = colmode ? nrows : ncols;
-	for (i = start; i < size; ++ i) {
-		if (colmode) {
-			address = i * ncols + pos;
+
+float * feqcaracLF(float * pmat, int nrows, int ncols, float * pdet, float ** ppinv) {
+// Retorna os coeficientes do polinômio característico da matriz 'pmat' usando algoritmo de Leverrier-Faddeev. Também calcula o determinante e a matriz inversa.
+// Cada passo, A_i = A (A_(i-1) - q_(i-1) I), é um único produto de matrizes em áreas de trabalho alocadas uma só vez.
+	int n = nrows, rank = nrows + 1;
+	float * coef = (float *) malloc(rank * sizeof(float));
+	float * pwork = (float *) malloc(2 * n * n * sizeof(float));
+	if (coef == NULL || pwork == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, 2 * n);
+		exit(7);
+		}
+	// plast guarda A_i e pdiff, B_(i-1) = A_(i-1) - q_(i-1) I
+	float * plast = pwork, * pdiff = pwork + n * n;
+	for (int i = 0; i < n; ++ i) {
+		memcpy(plast + i * n, pmat + i * ncols, n * sizeof(float));
+		}
+	for (int i = 0; i < n * n; i += n + 1) {
+		pdiff[i] = 1;
+		}
+	for (int i = 1 ; i < rank; ++ i) {
+		if (debuglevel_ >= 3) {
+			printf("Coef. %d: ", i);
 			}
-		else {
-			address = pos * nrows + i;
+		if (i > 1) {
+			memcpy(pdiff, plast, n * n * sizeof(float));
+			for (int k = 0; k < n * n; k += n + 1) {
+				pdiff[k] -= coef[i - 1];
+				}
+			cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, n, n, n, 1, pmat, ncols, pdiff, n, 0, plast, n);
+			flops_ += 2LL * n * n * n + n;
+			if (debuglevel_ >= 2) {
+				printf("A%d \n", i);
+				fshowmat(plast, n, n, "");
+				}
 			}
-		float value = fabs(pmat[address]);
-		if (maxval < value) {
-			maxval = value;
-			maxpos = i;
+		coef[i] = ftrace(plast, n, n) / i;
+		flops_ += n + FLOPS_DIV;			
+		if (debuglevel_ >= 3) {
+			printf("q = %f: ", coef[i]);
 			}
 		}
-	return maxpos;
-	}
-	
-void fchangerows(float * pmat, int rows, int ncols, int row1, int row2) {
-// Troca duas linhas de posição, em precisão simples.
-	int row1pos = row1 * ncols;
-	int row2pos = row2 * ncols;
-	for (int j = 0; j < ncols; ++ j) {
-		float value = pmat[row1pos + j];
-		pmat[row1pos + j] = pmat[row2pos + j];
-		pmat[row2pos + j] = value;
+	// A_n = q_n I, det(A) = (-1)^(n-1) q_n e A^-1 = B_(n-1) / q_n
+	float qn = coef[n];
+	bool impar = rank & 1;
+	float fdet = impar ? - qn : qn;
+	if (pdet != NULL) {
+		* pdet = fdet;
+		}
+	if (ppinv != NULL) {
+		* ppinv = (fdet != 0) ? fmtimes(pdiff, n, n, 1 / qn) : NULL;
 		}
+	free(pwork);
+	coef[0] = impar ? -1 : 1;
+	return coef;
 	}
 
-int dfindmax(double * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
-// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão dupla.
-	double maxval = 0;
-	int i, address, maxpos = start;
-	int size = colmode ? nrows : ncols;
-	for (i = start; i < size; ++ i) {
-		if (colmode) {
-			address = i * ncols + pos;
-			}
-		else {
-			address = pos * nrows + i;
-			}
-		double value = fabs(pmat[address]);
-		if (maxval < value) {
-			maxval = value;
-			maxpos = i;
+void ffromsys(float * psys, int nrows, int ncols, float ** ppA, float ** ppB) {
+	int nrows2 = nrows * nrows;
+	float * pmat = (float *) malloc(nrows2 * sizeof(float));
+	float * pvals = (float *) malloc(nrows * sizeof(float));
+	if (pmat == NULL || pvals == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, nrows + 1);
+		exit(7);
+		}
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < nrows; ++ j) {
+			pmat[i * nrows + j] = psys[i * ncols + j];
 			}
+		pvals[i] = psys[i * ncols + nrows];
 		}
-	return maxpos;
+	* ppA = pmat;
+	* ppB = pvals;
+	return;
 	}
 	
-void dchangerows(double * pmat, int rows, int ncols, int row1, int row2) {
-// Troca duas linhas de posição, em precisão dupla.
-	int row1pos = row1 * ncols;
-	int row2pos = row2 * ncols;
+float * fident(int rank, float val) {
+// Retorna uma matriz identidade com o 'rank' indicado
+	float * result = (float *) calloc(rank * rank, sizeof(float));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
+		exit(7);
+		}
+	for (int i = 0; i < rank; ++ i) {
+		result[i * (rank + 1)] = val;
+		}
+	return result;
+	}
+
+int fmortho(float * pmat, int nrows, int ncols) {
+// Ortonormaliza as colunas da matriz, no próprio local, por Gram-Schmidt modificado com reortogonalização.
+// Colunas linearmente dependentes das anteriores são zeradas. Retorna o número de colunas independentes.
+	int rank = 0;
 	for (int j = 0; j < ncols; ++ j) {
-		double value = pmat[row1pos + j];
-		pmat[row1pos + j] = pmat[row2pos + j];
-		pmat[row2pos + j] = value;
+		float norm0 = 0;
+		for (int i = 0; i < nrows; ++ i) {
+			norm0 += pmat[i * ncols + j] * pmat[i * ncols + j];
+			}
+		for (int pass = 0; pass < 2; ++ pass) {
+			for (int k = 0; k < j; ++ k) {
+				float dot = 0;
+				for (int i = 0; i < nrows; ++ i) {
+					dot += pmat[i * ncols + k] * pmat[i * ncols + j];
+					}
+				for (int i = 0; i < nrows; ++ i) {
+					pmat[i * ncols + j] -= dot * pmat[i * ncols + k];
+					}
+				}
+			}
+		float norm = 0;
+		for (int i = 0; i < nrows; ++ i) {
+			norm += pmat[i * ncols + j] * pmat[i * ncols + j];
+			}
+		flops_ += 8LL * nrows * j + 4 * nrows;
+		float inv = (norm > 1e-10 * norm0 && norm > 0) ? 1 / sqrt(norm) : 0;
+		flops_ += FLOPS_SQRT + FLOPS_DIV + nrows;
+		for (int i = 0; i < nrows; ++ i) {
+			pmat[i * ncols + j] *= inv;
+			}
+		if (inv != 0) {
+			++ rank;
+			}
 		}
+	return rank;
 	}
 
-int ldfindmax(long double * pmat, int nrows, int ncols, int pos, bool colmode, int start) {
-// Retorna o número da linha que possui o maior valor absoluto na posição indicada, em precisão estendida.	
-	long double maxval = 0;
-	int i, address, maxpos = start;
-	int size = colmode ? nrows : ncols;
-	for (i = start; i < size; ++ i) {
-		if (colmode) {
-			address = i * ncols + pos;
+void fqrR(float * pA, int nrows, int ncols) {
+// Reduz a matriz (nrows x ncols, nrows >= ncols), no próprio local, à forma triangular superior R da decomposição QR
+// por reflexões de Householder. Q não é formada; os elementos abaixo da diagonal são zerados.
+	float * pv = (float *) malloc(nrows * sizeof(float));
+	if (pv == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", nrows);
+		exit(7);
+		}
+	for (int j = 0; j < ncols && j < nrows - 1; ++ j) {
+		double norm = 0;
+		for (int i = j; i < nrows; ++ i) {
+			pv[i] = pA[i * ncols + j];
+			norm += (double) pv[i] * pv[i];
 			}
-		else {
-			address = pos * nrows + i;
+		norm = sqrt(norm);
+		if (norm == 0) {
+			continue;
 			}
-		long double value = fabs(pmat[address]);
-		if (maxval < value) {
-			maxval = value;
-			maxpos = i;
+		float alpha = (pv[j] > 0) ? - norm : norm, x0 = pv[j];
+		pv[j] -= alpha;
+		double vnorm2 = norm * norm - (double) x0 * x0 + (double) pv[j] * pv[j];
+		#pragma omp parallel for if ((nrows - j) * (ncols - j) > 10000)
+		for (int c = j + 1; c < ncols; ++ c) {
+			double w = 0;
+			for (int i = j; i < nrows; ++ i) {
+				w += (double) pv[i] * pA[i * ncols + c];
+				}
+			float f = 2 * w / vnorm2;
+			for (int i = j; i < nrows; ++ i) {
+				pA[i * ncols + c] -= f * pv[i];
+				}
+			}
+		pA[j * ncols + j] = alpha;
+		for (int i = j + 1; i < nrows; ++ i) {
+			pA[i * ncols + j] = 0;
 			}
+		flops_ += 4LL * (nrows - j) * (ncols - j) + 2 * (nrows - j) + FLOPS_SQRT + (ncols - j) * FLOPS_DIV;
 		}
-	return maxpos;
+	free(pv);
 	}
-	
-void ldchangerows(long double * pmat, int rows, int ncols, int row1, int row2) {
-// Troca duas linhas de posição, em precisão estendida.
-	int row1pos = row1 * ncols;
-	int row2pos = row2 * ncols;
-	for (int j = 0; j < ncols; ++ j) {
-		long double value = pmat[row1pos + j];
-		pmat[row1pos + j] = pmat[row2pos + j];
-		pmat[row2pos + j] = value;
+
+float * frandn(int nrows, int ncols, unsigned int seed) {
+// Retorna uma matriz com elementos pseudoaleatórios de distribuição normal padrão (Box-Muller), reprodutível a partir de 'seed'.
+	int size = nrows * ncols;
+	float * result = (float *) malloc(size * sizeof(float));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
+		}
+	unsigned int state = seed * 2654435761u + 1;
+	for (int i = 0; i < size; i += 2) {
+		state = state * 1103515245u + 12345u;
+		float u1 = ((state >> 8) + 1.0) / 16777217.0;
+		state = state * 1103515245u + 12345u;
+		float u2 = (state >> 8) / 16777216.0;
+		float r = sqrt(-2 * log(u1));
+		result[i] = r * cos(DOISPI * u2);
+		if (i + 1 < size) {
+			result[i + 1] = r * sin(DOISPI * u2);
+			}
 		}
+	return result;
 	}
 
-float * ftranspose(float * psrc, int nrows, int ncols) {
-// Retorna a transposta da matriz, em precisão simples.
-	float * pdst = (float *) malloc(nrows * ncols * sizeof(float));
-	if (pdst == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+void fm2csr(float * pmat, int nrows, int ncols, fcsrmat * pcsr) {
+// Converte a matriz densa para o formato esparso CSR (linhas comprimidas), descartando os elementos nulos.
+	int nnz = 0;
+	for (int i = 0; i < nrows * ncols; ++ i) {
+		nnz += (pmat[i] != 0);
+		}
+	pcsr->prow = (int *) malloc((nrows + 1) * sizeof(int));
+	pcsr->pcol = (int *) malloc(nnz * sizeof(int));
+	pcsr->pval = (float *) malloc(nnz * sizeof(float));
+	if (pcsr->prow == NULL || pcsr->pcol == NULL || pcsr->pval == NULL) {
+		printf("Não conseguiu alocar memória para a matriz esparsa com %d elementos! \n", nnz);
 		exit(7);
 		}
+	pcsr->nrows = nrows;
+	pcsr->ncols = ncols;
+	pcsr->nnz = nnz;
+	int pos = 0;
 	for (int i = 0; i < nrows; ++ i) {
+		pcsr->prow[i] = pos;
 		for (int j = 0; j < ncols; ++ j) {
-			pdst[j * nrows + i] = psrc[i * ncols + j];
+			if (pmat[i * ncols + j] != 0) {
+				pcsr->pcol[pos] = j;
+				pcsr->pval[pos ++] = pmat[i * ncols + j];
+				}
 			}
- 		}
-	return pdst;
+		}
+	pcsr->prow[nrows] = pos;
 	}
 
-float * f2sys(float * psrc, float * pval, int rank) {
-// Monta um sistema a partir de uma matriz quadrada e um vetor de valores, em precisão simples.
-	float * pdst = (float *) malloc(rank * (rank + 1) * sizeof(float));
-	if (pdst == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank + 1);
+void fopcsr(float * px, float * py, void * pdata) {
+// Operador y = A x para matriz esparsa em formato CSR.
+	fcsrmat * pcsr = (fcsrmat *) pdata;
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int i = 0; i < pcsr->nrows; ++ i) {
+		float sum = 0;
+		for (int k = pcsr->prow[i]; k < pcsr->prow[i + 1]; ++ k) {
+			sum += pcsr->pval[k] * px[pcsr->pcol[k]];
+			}
+		py[i] = sum;
+		}
+	flops_ += 2LL * pcsr->nnz;
+	}
+
+void fopLU(float * px, float * py, void * pdata) {
+// Operador y = A^-1 x, pela decomposição LU de A já preparada por f2LU (inversão espectral).
+	fLUmat * plu = (fLUmat *) pdata;
+	fdoLUblk(px, py, 1, plu->pL, plu->pU, plu->pP, plu->n);
+	}
+
+void foplowrank(float * px, float * py, void * pdata) {
+// Operador y = A x para matriz de posto baixo, A = U S V^T.
+	flrmatvec((flowrank *) pdata, px, py, false);
+	}
+
+void flrcreate(float * pS, float * pU, float * pV, int nrows, int ncols, int p, int * pord, int rank, flowrank * plr) {
+// Cria a matriz de posto baixo A = U S V^T com os 'rank' primeiros termos da decomposição reduzida (S p x p, U nrows x p, V ncols x p),
+// na ordem 'pord' (ou na ordem original, se NULL). Os fatores são copiados; apenas O((nrows + ncols) rank) de memória é usado.
+	plr -> nrows = nrows;
+	plr -> ncols = ncols;
+	plr -> rank = rank;
+	plr -> pS = (float *) malloc(rank * sizeof(float));
+	plr -> pU = (float *) malloc(nrows * rank * sizeof(float));
+	plr -> pV = (float *) malloc(ncols * rank * sizeof(float));
+	plr -> pwork = (float *) malloc(rank * sizeof(float));
+	if ((plr -> pS == NULL || plr -> pU == NULL || plr -> pV == NULL || plr -> pwork == NULL) && rank > 0) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows + ncols + 2, rank);
 		exit(7);
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pdst[i * (rank + 1) + j] = psrc[i * rank + j]; 
+	for (int j = 0; j < rank; ++ j) {
+		int celem = (pord == NULL) ? j : pord[j];
+		plr -> pS[j] = pS[celem * p + celem];
+		for (int i = 0; i < nrows; ++ i) {
+			plr -> pU[i * rank + j] = pU[i * p + celem];
+			}
+		for (int i = 0; i < ncols; ++ i) {
+			plr -> pV[i * rank + j] = pV[i * p + celem];
 			}
-		pdst[(i + 1) * (rank + 1) - 1] = pval[i]; 
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pdst, rank, rank + 1, "Sistema");
+	}
+
+float flrelem(flowrank * plr, int i, int j) {
+// Retorna o elemento (i, j) da matriz de posto baixo, em O(rank).
+	int k = plr -> rank;
+	float * pu = plr -> pU + i * k, * pv = plr -> pV + j * k;
+	float sum = 0;
+	for (int l = 0; l < k; ++ l) {
+		sum += pu[l] * plr -> pS[l] * pv[l];
 		}
-	return pdst;
+	flops_ += 3 * k;
+	return sum;
 	}
-	
 
-// Funções para resover sistemas triangulares em diversas precisões
-float * finvTS(float * pmat, int rank, int ncols, bool superior) {
-// Retorna a matriz inversa obtida por Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
-	int ncolsSys = rank + 1;
-	float * pSys = (float *) malloc(rank * ncolsSys * sizeof(float));	
-	if (pSys == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncolsSys);
+void flrfree(flowrank * plr) {
+// Libera os fatores da matriz de posto baixo.
+	free(plr -> pS);
+	free(plr -> pU);
+	free(plr -> pV);
+	free(plr -> pwork);
+	plr -> pS = plr -> pU = plr -> pV = plr -> pwork = NULL;
+	}
+
+int flrload(const char * fname, flowrank * plr) {
+// Lê uma matriz de posto baixo gravada por flrsave. Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	FILE * fp = fopen(fname, "rb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
+		return 4;
+		}
+	char magic[4];
+	int retcode = (fread(magic, 1, 4, fp) != 4 || memcmp(magic, FLR_MAGIC, 4) != 0) ? 5 : flrread(fp, plr);
+	if (retcode != 0) {
+		printf("O arquivo %s não contém uma matriz de posto baixo válida! \n", fname);
+		}
+	fclose(fp);
+	return retcode;
+	}
+
+float * flrmatmat(flowrank * plr, float * pB, int ncolB) {
+// Calcula o produto da matriz de posto baixo pela matriz B (ncols x ncolB) como U (S (V^T B)), sem formar U S V^T.
+	int k = plr -> rank;
+	float * pW = (float *) malloc(k * ncolB * sizeof(float));
+	float * pC = (float *) malloc(plr -> nrows * ncolB * sizeof(float));
+	if (pW == NULL || pC == NULL) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", plr -> nrows + k, ncolB);
 		exit(7);
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j < rank; ++ j) {
-			pSys[i * ncolsSys + j] = pmat[i * ncols + j];
-			}
+	cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, k, ncolB, plr -> ncols, 1, plr -> pV, k, pB, ncolB, 0, pW, ncolB);
+	for (int l = 0; l < k; ++ l) {
+		cblas_sscal(ncolB, plr -> pS[l], pW + l * ncolB, 1);
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pmat, rank, ncols, "pmat");
-		fshowmat(pSys, rank, ncolsSys, "pSys");
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, plr -> nrows, ncolB, k, 1, plr -> pU, k, pW, ncolB, 0, pC, ncolB);
+	flops_ += 2LL * (plr -> nrows + plr -> ncols) * k * ncolB + k * ncolB;
+	free(pW);
+	return pC;
+	}
+
+void flrmatvec(flowrank * plr, float * px, float * py, bool transp) {
+// Calcula y = A x = U (S (V^T x)) ou, se 'transp', y = A^T x = V (S (U^T x)), em O((nrows + ncols) rank).
+	int k = plr -> rank;
+	float * pL = (transp) ? plr -> pV : plr -> pU, * pR = (transp) ? plr -> pU : plr -> pV;
+	int nl = (transp) ? plr -> ncols : plr -> nrows, nr = (transp) ? plr -> nrows : plr -> ncols;
+	cblas_sgemv(CblasRowMajor, CblasTrans, nr, k, 1, pR, k, px, 1, 0, plr -> pwork, 1);
+	for (int l = 0; l < k; ++ l) {
+		plr -> pwork[l] *= plr -> pS[l];
 		}
-	float * pInv = (float *) malloc(rank * rank * sizeof(float));
-	if (pInv == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
+	cblas_sgemv(CblasRowMajor, CblasNoTrans, nl, k, 1, pL, k, plr -> pwork, 1, 0, py, 1);
+	flops_ += 2LL * (nl + nr) * k + k;
+	}
+
+void flrrows(flowrank * plr, int ini, int nr, float * pdst) {
+// Reconstrói as linhas 'ini' a 'ini + nr - 1' da matriz de posto baixo em 'pdst' (nr x ncols), permitindo percorrer a matriz
+// em blocos de linhas sem formá-la por inteiro.
+	int k = plr -> rank;
+	if (k == 0) {
+		memset(pdst, 0, nr * plr -> ncols * sizeof(float));
+		return;
+		}
+	float * pW = (float *) malloc(nr * k * sizeof(float));
+	if (pW == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nr, k);
 		exit(7);
 		}
-	for (int j = 0; j < rank; ++ j) {
-		for (int i = 0; i < rank; ++ i) {
-			pSys[i * ncolsSys + rank] = (i == j) ? 1 : 0;
-			}
-		if (debuglevel_ >= 2) {
-			fshowmat(pSys, rank, ncolsSys, "pSys");
-			}
-		float * result = fmtrisolve(pSys, rank, ncolsSys, superior);
-		if (debuglevel_ >= 2) {
-			fshowmat(result, rank, 1, "Resultado");
-			}
-		for (int i = 0; i < rank; ++ i) {
-			pInv[i * rank + j] = result[i];
+	for (int i = 0; i < nr; ++ i) {
+		for (int l = 0; l < k; ++ l) {
+			pW[i * k + l] = plr -> pU[(ini + i) * k + l] * plr -> pS[l];
 			}
-		free(result);
-		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pInv, rank, rank, "Inversa");
 		}
-	return pInv;
+	cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasTrans, nr, plr -> ncols, k, 1, pW, k, plr -> pV, k, 0, pdst, plr -> ncols);
+	flops_ += (long long int) nr * k + 2LL * nr * plr -> ncols * k;
+	free(pW);
 	}
 
-float * fmtrisolve(float * pmat, int nrows, int ncols, bool superior) {
-	float * result;
-	result = (float *) malloc(nrows * sizeof(float));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+int flrread(FILE * fp, flowrank * plr) {
+// Lê do arquivo aberto uma matriz de posto baixo gravada por flrwrite. Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	int dims[3];
+	if (fread(dims, sizeof(int), 3, fp) != 3 || dims[0] <= 0 || dims[1] <= 0 || dims[2] < 0) {
+		return 5;
+		}
+	int nrows = dims[0], ncols = dims[1], rank = dims[2];
+	plr -> nrows = nrows;
+	plr -> ncols = ncols;
+	plr -> rank = rank;
+	plr -> pS = (float *) malloc(rank * sizeof(float));
+	plr -> pU = (float *) malloc(nrows * rank * sizeof(float));
+	plr -> pV = (float *) malloc(ncols * rank * sizeof(float));
+	plr -> pwork = (float *) malloc(rank * sizeof(float));
+	if ((plr -> pS == NULL || plr -> pU == NULL || plr -> pV == NULL || plr -> pwork == NULL) && rank > 0) {
+		printf("Não conseguiu alocar memória para as matrizes %d x %d! \n", nrows + ncols + 2, rank);
 		exit(7);
 		}
-	if (superior) {
-		for (int i = nrows - 1; i >= 0; -- i) {
-			float divisor = pmat[i * ncols + i];
-			if (divisor == 0) {
-				printf("O sistema é singular! %d \n");
-				exit(8);
-				}
-			float invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			float sum = 0;
-			for (int j = i + 1; j < nrows; ++ j) {
-				float coef = pmat[i * ncols + j];
-				float x = result[j];
-				sum += coef * x;
-				flops_ += 2;				
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
+	if (fread(plr -> pS, sizeof(float), rank, fp) != (size_t) rank 
+		|| fread(plr -> pU, sizeof(float), nrows * rank, fp) != (size_t) (nrows * rank) 
+		|| fread(plr -> pV, sizeof(float), ncols * rank, fp) != (size_t) (ncols * rank)) {
+		flrfree(plr);
+		return 4;
+		}
+	return 0;
+	}
+
+int flrsave(const char * fname, flowrank * plr) {
+// Grava a matriz de posto baixo no arquivo binário 'fname': FLR_MAGIC seguido dos dados gravados por flrwrite.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	FILE * fp = fopen(fname, "wb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
+		exit(4);
+		}
+	fwrite(FLR_MAGIC, 1, 4, fp);
+	flrwrite(fp, plr);
+	int retcode = ferror(fp) ? 4 : 0;
+	if (fclose(fp) != 0) {
+		retcode = 4;
+		}
+	return retcode;
+	}
+
+void flrwrite(FILE * fp, flowrank * plr) {
+// Grava a matriz de posto baixo no arquivo aberto: nrows, ncols e rank (int), seguidos de S (rank), U (nrows x rank) e
+// V (ncols x rank), em float, por linhas.
+	int dims[3] = {plr -> nrows, plr -> ncols, plr -> rank};
+	fwrite(dims, sizeof(int), 3, fp);
+	fwrite(plr -> pS, sizeof(float), plr -> rank, fp);
+	fwrite(plr -> pU, sizeof(float), plr -> nrows * plr -> rank, fp);
+	fwrite(plr -> pV, sizeof(float), plr -> ncols * plr -> rank, fp);
+	}
+
+bool fisddom(float * pmat, int nrows, int ncols) {
+// Verifica se a matriz 'pmat' é diagonalmente dominante.
+	for (int i = 0; i < nrows; ++ i) {
+		float sum = 0, ref = pmat[i * (ncols + 1)];
+		for (int j = 0; j < nrows; ++ j) {
+			if (j != i) {
+				sum += pmat[i * ncols + j];
+				if (sum >= ref) {
+					return false;
 					}
 				}
-			float parm = pmat[i * ncols + nrows];
-			float valor = (parm - sum) * invdivisor;
-			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+			}
+		}
+	return true;
+	}
+
+bool fissym(float * pmat, int nrows, int ncols) {
+	for (int i = 1; i < nrows; ++ i) {
+		for (int j = 0; j < i; ++ j) {
+			if (pmat[i * ncols + j] != pmat[j * ncols + i]) {
+				return false;
 				}
 			}
 		}
-	else {
-		for (int i = 0; i < nrows; ++ i) {
-			float divisor = pmat[i * ncols + i];
-			if (divisor == 0) {
-				printf("O sistema é singular! \n");
-				exit(8);
+	return true;
+	}
+
+bool fistris(float * pmat, int nrows, int ncols) {
+	for (int i = 1; i < nrows; ++ i) {
+		for (int j = 0; j < i; ++ j) {
+			if (pmat[i * ncols + j] != 0) {
+				return false;
 				}
-			float invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			float sum = 0;
-			for (int j = 0; j < i; ++ j) {
-				float coef = pmat[i * ncols + j];
-				float x = result[j];
-				sum += coef * x;
-				flops_ += 2;
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
-					}
+			}
+		}
+	return true;
+	}
+
+
+float * fmadd(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB, bool add) {
+// Retorna a soma das matrizes indicadas
+	int nrows = (nrowA > nrowB) ? nrowA : nrowB;
+	int ncols = (ncolA > ncolB) ? ncolA : ncolB;
+	float * result = (float *) malloc(nrows * ncols * sizeof(float));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
+		}
+	for (int i = 0; i < nrows; ++ i) {
+		for (int j = 0; j < ncols; ++ j) {
+			if (add) {
+				result[i * ncols + j] = pA[i * ncolA + j] + pB[i * ncolB + j];
 				}
-			float parm = pmat[i * ncols + nrows];
-			float valor = (parm - sum) * invdivisor;
-			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+			else {
+				result[i * ncols + j] = pA[i * ncolA + j] - pB[i * ncolB + j];
 				}
+			++ flops_;
 			}
 		}
 	return result;
 	}
-
-double * dmtrisolve(double * pmat, int nrows, int ncols, bool superior) {
-	double * result;
-	result = (double *) malloc(nrows * sizeof(double));
+	
+float * fmtimes(float * pmat, int nrows, int ncols, float value) {
+	int size = nrows * ncols;
+	float * result = (float *) malloc(size * sizeof(float));
 	if (result == NULL) {
 		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
 		exit(7);
 		}
-	if (superior) {
-		for (int i = nrows - 1; i >= 0; -- i) {
-			double divisor = pmat[i * (ncols + 1)];
-			if (divisor == 0) {
-				printf("O sistema é singular! \n");
-				exit(8);
-				}
-			double invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			double sum = 0;
-			for (int j = i + 1; j < nrows; ++ j) {
-				double coef = pmat[i * ncols + j];
-				double x = result[j];
-				sum += coef * x;
-				flops_ += 2;
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
-					}
-				}
-			double parm = pmat[(i + 1) * ncols - 1];
-			double valor = (parm - sum) * invdivisor;
-			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
-				}
+	for (int i = 0; i < size; ++ i) {
+		result[i] = pmat[i] * value;
+		++ flops_;
+		}
+	return result;
+	}
+
+float * f2diag(float * psrc, int rank, float * pdet) {
+// Diagonaliza um sistema por meio da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
+	int ncols = rank + 1;
+	float * pval = (float *) calloc(rank * ncols, sizeof(float));
+	if (pval == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
+		exit(7);
+		}
+	for (int i = 0; i < rank; ++ i) {
+		for (int j = 0; j <= rank; ++ j) {
+			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
 			}
 		}
-	else {
-		for (int i = 0; i < nrows; ++ i) {
-			double divisor = pmat[i * (ncols + 1)];
-			if (divisor == 0) {
-				printf("O sistema é singular! \n");
-				exit(8);
+	if (debuglevel_ >= 2) {
+		fshowmat(pval, rank, ncols, "Inicialização");
+		}
+	bool sinal = false;
+	float det = 1, maxval;
+	for (int j = 0; j < rank; ++ j) {
+		int maxrow = ffindmax(pval, rank, ncols, j, true, j);
+		maxval = pval[maxrow * ncols + j];
+		if (maxval == 0) {
+			printf("Matriz singular! \n");
+			exit(8);
+			}
+		if (j != maxrow) {
+			sinal = ! sinal;
+			fchangerows(pval, rank, ncols, j, maxrow);
+			if (debuglevel_ >= 2) {
+				printf("Coluna %d pivoteamento\n", j);
+				fshowmat(pval, rank, ncols, "");
 				}
-			float invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			double sum = 0;
-			for (int j = 0; j < i; ++ j) {
-				double coef = pmat[i * ncols + j];
-				double x = result[j];
-				sum += coef * x;
-				flops_ += 2;
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %f = %f * %f \n", j, sum, coef, x);
-					}
+			}
+		float invmaxval = 1 / maxval;
+		flops_ += FLOPS_DIV;			
+		for (int i = j + 1; i < rank; ++ i) {
+			double multiplier = pval[i * ncols + j] * invmaxval;
+			++ flops_;
+			pval[i * ncols + j] = 0;
+			for (int k = j + 1; k <= rank; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;				
 				}
-			double parm = pmat[(i + 1) * ncols - 1];
-			double valor = (parm - sum) * invdivisor;
+			}
+		for (int i = j - 1; i >= 0; -- i) {
+			double multiplier = pval[i * ncols + j] * invmaxval;
 			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %f = (%f - %f) / %f \n", i, valor, parm, sum, divisor);
+			pval[i * ncols + j] = 0;
+			for (int k = j + 1; k <= rank; ++ k) {
+				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
+				flops_ += 2;				
 				}
 			}
+		if (debuglevel_ >= 2) {
+			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
+			fshowmat(pval, rank, ncols, "");
+			}
 		}
-	return result;
+	for (int i = 0; i < rank; ++ i) {
+		det *= pval[i * ncols + i];
+		++ flops_;		
+		}
+	* pdet = det * (sinal ? -1 : 1);
+	return pval;
 	}
-	
-long double * ldmtrisolve(long double * pmat, int nrows, int ncols, bool superior) {
-	long double * result;
-	result = (long double *) malloc(nrows * sizeof(long double));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+
+float * f2hess(float * psrc, int nrows, int ncols, float ** ppQ) {
+// Reduz a matriz à forma de Hessenberg superior por reflexões de Householder, em precisão simples.
+// Retorna a matriz H e, se solicitada, a matriz ortogonal Q tal que A = Q H Q^T.
+	int n = nrows;
+	float * ph = (float *) malloc(n * n * sizeof(float));
+	float * pv = (float *) malloc(n * sizeof(float));
+	if (ph == NULL || pv == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, n + 1);
 		exit(7);
 		}
-	if (superior) {
-		for (int i = nrows - 1; i >= 0; -- i) {
-			long double divisor = pmat[i * (ncols + 1)];
-			if (divisor == 0) {
-				printf("O sistema é singular! \n");
-				exit(8);
-				}
-			long double invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			long double sum = 0;
-			for (int j = i + 1; j < nrows; ++ j) {
-				long double coef = pmat[i * ncols + j];
-				long double x = result[j];
-				sum += coef * x;
-				flops_ += 2;
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %Lf = %Lf * %Lf \n", j, sum, coef, x);
-					}
+	for (int i = 0; i < n; ++ i) {
+		for (int j = 0; j < n; ++ j) {
+			ph[i * n + j] = psrc[i * ncols + j];
+			}
+		}
+	float * pQ = (ppQ != NULL) ? fident(n) : NULL;
+	for (int k = 0; k < n - 2; ++ k) {
+		// Monta o vetor de Householder que anula a coluna 'k' abaixo da subdiagonal
+		float alpha = 0;
+		for (int i = k + 1; i < n; ++ i) {
+			pv[i] = ph[i * n + k];
+			alpha += pv[i] * pv[i];
+			}
+		alpha = sqrt(alpha);
+		flops_ += 2 * (n - k - 1) + FLOPS_SQRT;
+		if (alpha == 0) {
+			continue;
+			}
+		if (pv[k + 1] > 0) {
+			alpha = - alpha;
+			}
+		pv[k + 1] -= alpha;
+		float vnorm2 = 0;
+		for (int i = k + 1; i < n; ++ i) {
+			vnorm2 += pv[i] * pv[i];
+			}
+		if (vnorm2 == 0) {
+			continue;
+			}
+		float beta = 2 / vnorm2;
+		flops_ += 2 * (n - k - 1) + 1 + FLOPS_DIV;
+		// H <- P H
+		#pragma omp parallel for
+		for (int j = k; j < n; ++ j) {
+			float sum = 0;
+			for (int i = k + 1; i < n; ++ i) {
+				sum += pv[i] * ph[i * n + j];
 				}
-			long double parm = pmat[(i + 1) * ncols - 1];
-			long double valor = (parm - sum) * invdivisor;
-			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %Lf = (%Lf - %Lf) / %Lf \n", i, valor, parm, sum, divisor);
+			sum *= beta;
+			for (int i = k + 1; i < n; ++ i) {
+				ph[i * n + j] -= sum * pv[i];
 				}
 			}
-		}
-	else {
-		for (int i = 0; i < nrows; ++ i) {
-			long double divisor = pmat[i * (ncols + 1)];
-			if (divisor == 0) {
-				printf("O sistema é singular! \n");
-				exit(8);
+		// H <- H P e Q <- Q P
+		#pragma omp parallel for
+		for (int i = 0; i < n; ++ i) {
+			float sum = 0;
+			for (int j = k + 1; j < n; ++ j) {
+				sum += ph[i * n + j] * pv[j];
 				}
-			long double invdivisor = 1 / divisor;
-			flops_ += FLOPS_DIV;
-			long double sum = 0;
-			for (int j = 0; j < i; ++ j) {
-				long double coef = pmat[i * ncols + j];
-				long double x = result[j];
-				flops_ += 2;
-				sum += coef * x;
-				if (debuglevel_ >= 3) {
-					printf("Coluna %d: %Lf = %Lf * %Lf \n", j, sum, coef, x);
-					}
+			sum *= beta;
+			for (int j = k + 1; j < n; ++ j) {
+				ph[i * n + j] -= sum * pv[j];
 				}
-			long double parm = pmat[(i + 1) * ncols - 1];
-			long double valor = (parm - sum) * invdivisor;
-			++ flops_;			
-			result[i] = valor;
-			if (debuglevel_ >= 2) {
-				printf("Linha %d: %Lf = (%Lf - %Lf) / %Lf \n", i, valor, parm, sum, divisor);
+			if (pQ != NULL) {
+				sum = 0;
+				for (int j = k + 1; j < n; ++ j) {
+					sum += pQ[i * n + j] * pv[j];
+					}
+				sum *= beta;
+				for (int j = k + 1; j < n; ++ j) {
+					pQ[i * n + j] -= sum * pv[j];
+					}
 				}
 			}
+		flops_ += 4 * (n - k - 1) * ((n - k) + n * ((pQ != NULL) ? 2 : 1));
+		for (int i = k + 2; i < n; ++ i) {
+			ph[i * n + k] = 0;
+			}
 		}
-	return result;
+	free(pv);
+	if (debuglevel_ >= 2) {
+		fshowmat(ph, n, n, "Hessenberg");
+		}
+	if (ppQ != NULL) {
+		* ppQ = pQ;
+		}
+	return ph;
 	}
 
-	
-// Funções para cálculo das normas das matrizes em diversas precisões
-float fmnormi(float * pmat, int nrow, int ncol) {
-	if (pmat == NULL) {
-		return 0;
+int f2tridiag(float * psrc, int nrows, int ncols, float ** ppd, float ** ppe, float ** ppQ) {
+// Reduz a matriz simétrica à forma tridiagonal por transformações de Householder, A = Q T Q^T.
+// As reflexões são agrupadas em blocos de NB_TRID colunas e a parte restante da matriz é atualizada de uma só vez
+// por produtos de matrizes (A = A - V^T W - W^T V), como na rotina LATRD do LAPACK.
+// Informa a diagonal 'ppd' (n), a subdiagonal 'ppe' (n - 1, mais uma posição livre) e, se solicitada, a matriz ortogonal 'ppQ'.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	int n = nrows;
+	float * pA = (float *) malloc(n * n * sizeof(float));
+	float * pd = (float *) malloc(n * sizeof(float));
+	float * pe = (float *) malloc(n * sizeof(float));
+	float * ptau = (float *) malloc(n * sizeof(float));
+	float * pV = (float *) malloc(NB_TRID * n * sizeof(float));
+	float * pW = (float *) malloc(NB_TRID * n * sizeof(float));
+	float * ptmp = (float *) malloc((2 * NB_TRID + n) * sizeof(float));
+	if (pA == NULL || pd == NULL || pe == NULL || ptau == NULL || pV == NULL || pW == NULL || ptmp == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", n, n);
+		exit(7);
 		}
-	int size = nrow * ncol;
-	float max = 0;
-	while (size -- > 0) {
-		float valor = fabs(* pmat ++);
-		max = (valor > max) ? valor : max;
+	for (int i = 0; i < n; ++ i) {
+		memcpy(pA + i * n, psrc + i * ncols, n * sizeof(float));
+		ptau[i] = 0;
+		}
+	// Pela simetria, a linha i faz o papel da coluna i e o vetor de Householder fica guardado nela, à direita da subdiagonal
+	for (int k0 = 0; k0 < n - 2; k0 += NB_TRID) {
+		int kb = (n - 2 - k0 < NB_TRID) ? n - 2 - k0 : NB_TRID;
+		for (int c = 0; c < kb; ++ c) {
+			int i = k0 + c, len = n - i - 1;
+			float * prow = pA + i * n;
+			// Aplica à linha i as reflexões anteriores do bloco
+			if (c > 0) {
+				cblas_sgemv(CblasRowMajor, CblasTrans, c, len + 1, -1, pV + i, n, pW + i, n, 1, prow + i, 1);
+				cblas_sgemv(CblasRowMajor, CblasTrans, c, len + 1, -1, pW + i, n, pV + i, n, 1, prow + i, 1);
+				flops_ += 4LL * c * (len + 1);
+				}
+			pd[i] = prow[i];
+			// Reflexão que anula a linha além da subdiagonal
+			float * px = prow + i + 1;
+			float alpha = px[0], xnorm = cblas_snrm2(len - 1, px + 1, 1);
+			flops_ += 2 * len + FLOPS_SQRT;
+			float * pv = pV + c * n, * pw = pW + c * n;
+			if (xnorm == 0) {
+				pe[i] = alpha;
+				memset(pv, 0, n * sizeof(float));
+				memset(pw, 0, n * sizeof(float));
+				px[0] = 1;
+				continue;
+				}
+			float beta = - copysign(sqrt(alpha * alpha + xnorm * xnorm), alpha);
+			ptau[i] = (beta - alpha) / beta;
+			cblas_sscal(len - 1, 1 / (alpha - beta), px + 1, 1);
+			px[0] = 1;
+			pe[i] = beta;
+			flops_ += len + 4 + FLOPS_SQRT + 2 * FLOPS_DIV;
+			memset(pv, 0, (i + 1) * sizeof(float));
+			memcpy(pv + i + 1, px, len * sizeof(float));
+			// w = tau (A v - V^T W v - W^T V v) - (tau / 2) (w . v) v
+			float tau = ptau[i];
+			cblas_sgemv(CblasRowMajor, CblasNoTrans, len, len, tau, pA + (i + 1) * n + i + 1, n, px, 1, 0, pw + i + 1, 1);
+			flops_ += 2LL * len * len;
+			if (c > 0) {
+				cblas_sgemv(CblasRowMajor, CblasNoTrans, c, len, 1, pW + i + 1, n, px, 1, 0, ptmp, 1);
+				cblas_sgemv(CblasRowMajor, CblasNoTrans, c, len, 1, pV + i + 1, n, px, 1, 0, ptmp + NB_TRID, 1);
+				cblas_sgemv(CblasRowMajor, CblasTrans, c, len, - tau, pV + i + 1, n, ptmp, 1, 1, pw + i + 1, 1);
+				cblas_sgemv(CblasRowMajor, CblasTrans, c, len, - tau, pW + i + 1, n, ptmp + NB_TRID, 1, 1, pw + i + 1, 1);
+				flops_ += 8LL * c * len;
+				}
+			float gamma = - 0.5 * tau * cblas_sdot(len, pw + i + 1, 1, px, 1);
+			cblas_saxpy(len, gamma, px, 1, pw + i + 1, 1);
+			memset(pw, 0, (i + 1) * sizeof(float));
+			flops_ += 4 * len + 2;
+			}
+		// Atualização da parte restante da matriz pelo bloco
+		int s = k0 + kb, len = n - s;
+		cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, len, len, kb, -1, pV + s, n, pW + s, n, 1, pA + s * n + s, n);
+		cblas_sgemm(CblasRowMajor, CblasTrans, CblasNoTrans, len, len, kb, -1, pW + s, n, pV + s, n, 1, pA + s * n + s, n);
+		flops_ += 4LL * len * len * kb;
+		}
+	if (n >= 2) {
+		pd[n - 2] = pA[(n - 2) * n + n - 2];
+		pe[n - 2] = pA[(n - 2) * n + n - 1];
+		}
+	pd[n - 1] = pA[(n - 1) * n + n - 1];
+	pe[n - 1] = 0;
+	if (ppQ != NULL) {
+		// Acumula Q = H(0) H(1) ... H(n-3), da última reflexão para a primeira
+		float * pQ = fident(n);
+		for (int i = n - 3; i >= 0; -- i) {
+			int len = n - i - 1;
+			float * pv = pA + i * n + i + 1, * pq = pQ + (i + 1) * n + i + 1;
+			if (ptau[i] == 0) {
+				continue;
+				}
+			cblas_sgemv(CblasRowMajor, CblasTrans, len, len, 1, pq, n, pv, 1, 0, ptmp, 1);
+			#pragma omp parallel for
+			for (int r = 0; r < len; ++ r) {
+				cblas_saxpy(len, - ptau[i] * pv[r], ptmp, 1, pq + r * n, 1);
+				}
+			flops_ += 4LL * len * len;
+			}
+		* ppQ = pQ;
 		}
-	return max;
+	free(pA);
+	free(ptau);
+	free(pV);
+	free(pW);
+	free(ptmp);
+	* ppd = pd;
+	* ppe = pe;
+	return 0;
 	}
 
-float fmnorm2(float * pmat, int nrow, int ncol) {
-	if (pmat == NULL) {
-		return 0;
+float * fsolveDG(float * psrc, int rank, float * pdet) {
+// Retorna a solução do sistema por diagonalização e informa o valor do determinante, em precisão simples.
+	float * pD = f2diag(psrc, rank, pdet);
+	float * result = (float *) malloc(rank * sizeof(float));
+	if (result == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
+		exit(7);
 		}
-	int size = nrow * ncol;
-	float sum = 0;
-	while (size -- > 0) {
-		float valor = * pmat ++;
-		sum += valor * valor;
-		flops_ += 2;
+	for (int i = 0; i < rank; ++ i) {
+		result[i] = pD[i * (rank + 1) + rank] / pD[i * (rank +1) + i];
+		flops_ += FLOPS_DIV;
+		}		
+	if (debuglevel_ >= 2) {
+		fshowmat(result, rank, 1, "Resultado");
 		}
-	return sqrt(sum);
+	return result;
 	}
 
-double dmnorm2(double * pmat, int nrow, int ncol) {
-	if (pmat == NULL) {
-		return 0;
-		}
-	int size = nrow * ncol;
-	double sum = 0;
-	while (size -- > 0) {
-		double valor = * pmat ++;
-		sum += valor * valor;
-		flops_ += 2;		
+float ftrace(float * pmat, int nrows, int ncols) {
+// Retorna o traço da matriz 'pmat'.
+	float sum = 0;
+	for (int i = 0; i < nrows; ++ i) {
+		sum += pmat[i * (ncols + 1)];
 		}
-	return sqrt(sum);
+	return sum;
 	}
 
-long double ldmnorm2(long double * pmat, int nrow, int ncol) {
-	if (pmat == NULL) {
+	
+// Funções para leitura das matrizes gravadas pelo MATLAB	
+long long int fmat5tag(const unsigned char * p, const unsigned char * pfim, bool troca, int * ptipo, unsigned int * pnbytes, 
+	const unsigned char ** ppdados) {
+// Lê a etiqueta do elemento de dados MAT v5 em 'p' e informa seu tipo, seu tamanho em bytes e o início dos dados.
+// Retorna o tamanho total do elemento, com a etiqueta e o preenchimento até múltiplo de 8 bytes, ou 0 se ele não couber até 'pfim'.
+	if (pfim - p < 8) {
 		return 0;
 		}
-	int size = nrow * ncol;
-	long double sum = 0;
-	while (size -- > 0) {
-		long double valor = * pmat ++;
-		sum += valor * valor;
-		flops_ += 2;		
+	unsigned int w0 = fmat5u32(p, troca);
+	long long int total, usado;
+	if ((w0 >> 16) != 0) {
+		// Elemento pequeno: tipo e tamanho em 4 bytes, dados nos 4 seguintes
+		* ptipo = w0 & 0xffff;
+		* pnbytes = w0 >> 16;
+		* ppdados = p + 4;
+		total = usado = 8;
 		}
-	return sqrt(sum);
+	else {
+		* ptipo = w0;
+		* pnbytes = fmat5u32(p + 4, troca);
+		* ppdados = p + 8;
+		usado = 8 + (long long int) * pnbytes;
+		// Os elementos comprimidos não têm preenchimento
+		total = (* ptipo == miCOMPRESSED) ? usado : (usado + 7) & ~7LL;
+		}
+	return (usado > pfim - p) ? 0 : ((total < pfim - p) ? total : pfim - p);
 	}
 
-// Funções para exibição de matrizes em diversas precisões
-void fshowmat(float * pmat, int nrows, int ncols, const char * header) {
-	if (header != NULL && strlen(header) > 0) {
-		printf("%s \n", header);
+int fmat5tam(int tipo) {
+// Retorna o tamanho em bytes de um valor do tipo numérico MAT v5 'tipo', ou 0 se o tipo não for numérico.
+	static const int tam[] = {0, 1, 1, 2, 2, 4, 4, 4, 0, 8, 0, 0, 8, 8};
+	return (tipo > 0 && tipo < (int) (sizeof(tam) / sizeof(tam[0]))) ? tam[tipo] : 0;
+	}
+
+unsigned int fmat5u32(const unsigned char * p, bool troca) {
+// Retorna o inteiro de 32 bits em 'p', invertendo a ordem dos bytes se 'troca'.
+	unsigned int valor;
+	memcpy(& valor, p, 4);
+	return (troca) ? (valor >> 24) | ((valor >> 8) & 0xff00) | ((valor << 8) & 0xff0000) | (valor << 24) : valor;
+	}
+
+double fmat5val(const unsigned char * p, int tipo, size_t k, bool troca) {
+// Retorna o valor 'k' do vetor de dados MAT v5 do tipo numérico 'tipo' que começa em 'p', invertendo a ordem dos bytes se 'troca'.
+	int n = fmat5tam(tipo);
+	unsigned char b[8];
+	for (int i = 0; i < n; ++ i) {
+		b[i] = p[k * n + ((troca) ? n - 1 - i : i)];
+		}
+	switch (tipo) {
+		case miINT8: {signed char v; memcpy(& v, b, 1); return v;}
+		case miUINT8: return b[0];
+		case miINT16: {short v; memcpy(& v, b, 2); return v;}
+		case miUINT16: {unsigned short v; memcpy(& v, b, 2); return v;}
+		case miINT32: {int v; memcpy(& v, b, 4); return v;}
+		case miUINT32: {unsigned int v; memcpy(& v, b, 4); return v;}
+		case miSINGLE: {float v; memcpy(& v, b, 4); return v;}
+		case miDOUBLE: {double v; memcpy(& v, b, 8); return v;}
+		case miINT64: {long long int v; memcpy(& v, b, 8); return v;}
+		case miUINT64: {unsigned long long int v; memcpy(& v, b, 8); return v;}
+		default: return 0;
+		}
+	}
+
+double * lerbin(const char * fname, int size, int * pnrows, int * pncols, bool * pmapeada) {
+// Mapeia o arquivo binário 'fname''size'.fmb, gravado por fsavebin, e retorna sua matriz; retorna NULL se ele não existir.
+// O cabeçalho ocupa FMB_DADOS bytes: FMB_MAGIC seguido de tipo, nrows, ncols e ld (int); os dados vêm em seguida, por linhas
+// de 'ld' elementos de 'tipo' bytes (4: float, 8: double). Se forem double sem preenchimento (ld = ncols), a matriz retornada
+// é a própria região mapeada (em cópia na escrita), sem conversão nem cópia, e 'mapeada' é verdadeiro: ela não pode ser
+// liberada, e o mapeamento dura até o fim do programa. Se houver o arquivo texto 'fname''size' e o binário for inválido ou
+// estiver desatualizado em relação a ele (fmbatual), também retorna NULL, para que os dados sejam lidos do texto.
+	char src[FNAME_MAX_SIZE + 1], name[FNAME_MAX_SIZE + 8];
+	sprintf(src, "%s%d", fname, size);
+	sprintf(name, "%s.fmb", src);
+	HANDLE hfile, hmap;
+	long long int tam;
+	const char * pini = lermapa(name, true, & hfile, & hmap, & tam);
+	if (hfile == INVALID_HANDLE_VALUE) {
+		return NULL;
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			printf(" %f ", pmat[i * ncols + j]);
+	int cabec[4] = {0, -1, -1, -1};
+	if (pini != NULL && tam >= FMB_DADOS) {
+		memcpy(cabec, pini + 4, sizeof(cabec));
+		}
+	int tipo = cabec[0], nrows = cabec[1], ncols = cabec[2], ld = cabec[3];
+	bool valido = (pini != NULL && memcmp(pini, FMB_MAGIC, 4) == 0 && (tipo == 4 || tipo == 8) && nrows >= 0 && ncols >= 0
+		&& ld >= ncols && (long long int) nrows * ld * tipo <= tam - FMB_DADOS);
+	long long int chave[3];
+	if (! valido && ! lerchave(src, chave, false)) {
+		printf("O arquivo %s não contém uma matriz binária válida! \n", name);
+		exit(5);
+		}
+	// Com o arquivo texto disponível, um binário inválido (gravação interrompida, por exemplo) ou desatualizado é ignorado
+	if (! valido || ! fmbatual(name, src, pini)) {
+		if (pini != NULL) {
+			UnmapViewOfFile(pini);
 			}
-		printf("\n");
+		CloseHandle(hmap);
+		CloseHandle(hfile);
+		if (debuglevel_ >= 1) {
+			printf("Arquivo %s desatualizado ou inválido. \n", name);
+			}
+		return NULL;
 		}
-	}
-
-void dshowmat(double * pmat, int nrows, int ncols, const char * header) {
-	if (header != NULL && strlen(header) > 0) {
-		printf("%s \n", header);
+	if (debuglevel_ >= 1) {
+		printf("Arquivo %s: linhas = %d, colunas = %d, %s. \n", name, nrows, ncols, (tipo == 8) ? "double" : "float");
+		}
+	* pnrows = nrows;
+	* pncols = ncols;
+	const char * pdados = pini + FMB_DADOS;
+	* pmapeada = (tipo == 8 && ld == ncols);
+	if (* pmapeada) {
+		return (double *) pdados;
+		}
+	double * pval = (double *) malloc((size_t) nrows * ncols * sizeof(double));
+	if (pval == NULL && nrows * ncols > 0) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		exit(7);
 		}
 	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			printf(" %f ", pmat[i * ncols + j]);
+		if (tipo == 8) {
+			memcpy(pval + (size_t) i * ncols, pdados + (size_t) i * ld * tipo, ncols * sizeof(double));
+			}
+		else {
+			dcvtfd((const float *) pdados + (size_t) i * ld, pval + (size_t) i * ncols, ncols);
 			}
-		printf("\n");
 		}
+	UnmapViewOfFile(pini);
+	CloseHandle(hmap);
+	CloseHandle(hfile);
+	return pval;
 	}
 
-void ldshowmat(long double * pmat, int nrows, int ncols, const char * header) {
-	if (header != NULL && strlen(header) > 0) {
-		printf("%s \n", header);
+void fmbabre(const char * fname, int size, fmbfile * pmb) {
+// Abre o arquivo binário 'fname''size'.fmb para leitura por peças, sem mapeá-lo nem carregá-lo. Se ele não existir, for inválido
+// ou incompleto (numa conversão interrompida, por exemplo) ou estiver desatualizado em relação ao arquivo texto 'fname''size',
+// cria-o de novo a partir do texto, por fmbconverte.
+	char src[FNAME_MAX_SIZE + 1];
+	sprintf(src, "%s%d", fname, size);
+	sprintf(pmb->name, "%s.fmb", src);
+	pmb->tmp[0] = 0;
+	pmb->fp = fopen(pmb->name, "rb");
+	if (pmb->fp != NULL && ! fmblecabec(pmb, src)) {
+		long long int chave[3];
+		if (! lerchave(src, chave, false)) {
+			printf("O arquivo %s não contém uma matriz binária válida! \n", pmb->name);
+			exit(5);
+			}
+		if (debuglevel_ >= 1) {
+			printf("Arquivo %s desatualizado ou inválido. \n", pmb->name);
+			}
+		fclose(pmb->fp);
+		pmb->fp = NULL;
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			printf(" %f ", pmat[i * ncols + j]);
+	if (pmb->fp == NULL) {
+		fmbconverte(fname, size, pmb->name);
+		pmb->fp = fopen(pmb->name, "rb");
+		if (pmb->fp == NULL) {
+			printf("Não conseguiu abrir o arquivo %s! \n", pmb->name);
+			exit(4);
+			}
+		if (! fmblecabec(pmb, src)) {
+			printf("O arquivo %s não contém uma matriz binária válida! \n", pmb->name);
+			exit(5);
 			}
-		printf("\n");
 		}
-	}
-	
-
-// Outras funções úteis
-void ucrono(bool init, int divisor) {
-// Marca os tempos transcorridos entre chamadas
-	static double wstart, wend;
-    static HANDLE hProcess;
-    static FILETIME ftCreation, ftExit, ftKernel, ftUser1, ftUser2;
-    static SYSTEMTIME stUser1,stUser2;
-	if (init) {
-		// Inicializa as variáveis
-		hProcess = GetCurrentProcess();
+	pmb->paux = malloc(((pmb->ncols > 0) ? pmb->ncols : 1) * sizeof(double));
+	if (pmb->paux == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", pmb->ncols);
+		exit(7);
 		}
-	if (divisor == 0) {
-		// Começa a contagem
-		GetProcessTimes(hProcess, &ftCreation, &ftExit, &ftKernel, &ftUser1);
-		wstart = omp_get_wtime();
+	if (debuglevel_ >= 1) {
+		printf("Arquivo %s: linhas = %d, colunas = %d, %s. \n", pmb->name, pmb->nrows, pmb->ncols, (pmb->tipo == 8) ? "double" : "float");
+		}
+	}
+
+bool fmbatual(const char * name, const char * src, const char * pcabec) {
+// Verifica se o arquivo binário 'name', de cabeçalho 'pcabec', corresponde ao arquivo texto 'src'. Se o binário foi gravado com
+// a chave do texto, o tamanho e a data do texto devem ser os gravados; caso contrário, ele vale se não for mais antigo que o texto.
+// Sem o arquivo texto, o binário é a única fonte dos dados e sempre vale.
+	long long int chave[3], atual[3], bin[3];
+	memcpy(chave, pcabec + FMB_CHAVE, sizeof(chave));
+	if (! lerchave(src, atual, false)) {
+		return true;
+		}
+	if (chave[0] != 0 || chave[1] != 0) {
+		return (atual[0] == chave[0] && atual[1] == chave[1]);
+		}
+	return (lerchave(name, bin, false) && bin[1] >= atual[1]);
+	}
+
+void fmbconverte(const char * fname, int size, const char * name) {
+// Converte o arquivo texto 'fname''size', gravado pelo MATLAB/Octave, no arquivo binário 'name', em double, por blocos de
+// NB_LINHAS linhas, de modo que a matriz nunca fica inteira na memória. A chave do texto, obtida antes da leitura, vai para
+// o cabeçalho (fmbatual). Como em fsavecache, a gravação é feita num arquivo temporário próprio do processo, renomeado ao
+// final, de modo que uma conversão interrompida ou simultânea nunca deixa um arquivo incompleto com o nome 'name'.
+	char src[FNAME_MAX_SIZE + 1], tmp[FNAME_MAX_SIZE + 40];
+	sprintf(src, "%s%d", fname, size);
+	sprintf(tmp, "%s.%lu.tmp", name, (unsigned long) GetCurrentProcessId());
+	long long int chave[3];
+	bool fonte = lerchave(src, chave, false);
+	fmatfile mf;
+	lercabec(fname, size, & mf);
+	int nrows = mf.nrows, ncols = mf.ncols;
+	double * pbuf = (double *) malloc((size_t) NB_LINHAS * ((ncols > 0) ? ncols : 1) * sizeof(double));
+	if (pbuf == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", NB_LINHAS, ncols);
+		exit(7);
 		}
-	else {
-		// Encerra a contagem e imprime o resultado
-		GetProcessTimes(hProcess, &ftCreation, &ftExit, &ftKernel, &ftUser2);	
-		wend = omp_get_wtime();
-		FileTimeToSystemTime(& ftUser1, & stUser1);
-		FileTimeToSystemTime(& ftUser2, & stUser2);
-		double twall = (1000.0 * (wend - wstart)) / divisor;
-		double tuser = (1000.0 * (stUser2.wSecond - stUser1.wSecond) + stUser2.wMilliseconds - stUser1.wMilliseconds) / divisor;
-		printf("Tempo gasto = %f ms, user time = %f ms \n", twall, tuser);
+	FILE * fp = fopen(tmp, "wb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", tmp);
+		exit(4);
+		}
+	printf("Convertendo o arquivo %s para %s... \n", mf.name, name);
+	fsavebincabec(fp, sizeof(double), nrows, ncols, (fonte) ? chave : NULL);
+	fmatprec dst = {NULL, pbuf, NULL};
+	for (int ini = 0; ini < nrows; ini += NB_LINHAS) {
+		int nr = (nrows - ini < NB_LINHAS) ? nrows - ini : NB_LINHAS;
+		lerlinhas(& mf, nr, & dst);
+		fwrite(pbuf, sizeof(double), (size_t) nr * ncols, fp);
+		}
+	lerfecha(& mf);
+	free(pbuf);
+	int erro = ferror(fp);
+	if (fclose(fp) != 0 || erro || ! MoveFileExA(tmp, name, MOVEFILE_REPLACE_EXISTING)) {
+		printf("Não conseguiu gravar o arquivo %s! \n", name);
+		remove(tmp);
+		exit(4);
 		}
-	return;
 	}
 
-float * feqcaracL(float * pmat, int nrows, int ncols) {
-// Retorna os coeficientes do polinômio característico da matriz 'pmat' usando algoritmo de Leverrier
-	int rank = nrows + 1;
-	float * coef = (float *) malloc(rank * sizeof(float));
-	float * traces = (float *) malloc(rank * sizeof(float));
-	if (coef == NULL || traces == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x 2! \n", rank);
-		exit(7);
+void fmbcria(const char * name, int nrows, int ncols, fmbfile * pmb) {
+// Cria o arquivo binário 'name' para a gravação, por peças, de uma matriz 'nrows' x 'ncols' em float. Como em fmbconverte,
+// as peças vão para um arquivo temporário próprio do processo, renomeado para 'name' só por fmbfecha, de modo que uma gravação
+// interrompida nunca deixa um arquivo incompleto com esse nome.
+	strcpy(pmb->name, name);
+	sprintf(pmb->tmp, "%s.%lu.tmp", name, (unsigned long) GetCurrentProcessId());
+	pmb->fp = fopen(pmb->tmp, "wb");
+	if (pmb->fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", pmb->tmp);
+		exit(4);
 		}
-	float * pvals = (float *) malloc(nrows * nrows * sizeof(float));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, nrows);
-		exit(7);
+	setvbuf(pmb->fp, NULL, _IONBF, 0);
+	fsavebincabec(pmb->fp, sizeof(float), nrows, ncols);
+	pmb->tipo = sizeof(float);
+	pmb->nrows = nrows;
+	pmb->ncols = ncols;
+	pmb->ld = ncols;
+	pmb->paux = NULL;
+	}
+
+void fmbfecha(fmbfile * pmb) {
+// Fecha o arquivo aberto por fmbabre ou fmbcria; neste caso, renomeia o arquivo temporário para o nome definitivo.
+	int erro = ferror(pmb->fp);
+	if (fclose(pmb->fp) != 0 || erro || (pmb->tmp[0] != 0 && ! MoveFileExA(pmb->tmp, pmb->name, MOVEFILE_REPLACE_EXISTING))) {
+		printf("Não conseguiu gravar o arquivo %s! \n", pmb->name);
+		if (pmb->tmp[0] != 0) {
+			remove(pmb->tmp);
+			}
+		exit(4);
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < nrows; ++ j) {
-			pvals[i * nrows + j] = pmat[i * ncols + j];
+	free(pmb->paux);
+	}
+
+void fmbgravapeca(fmbfile * pmb, int i0, int j0, int nr, int nc, const float * psrc) {
+// Grava a peça 'psrc', de 'nr' x 'nc' elementos (ld = nc), a partir da linha 'i0' e da coluna 'j0' do arquivo criado por fmbcria.
+	for (int i = 0; i < nr; ++ i) {
+		long long int pos = FMB_DADOS + ((long long int) (i0 + i) * pmb->ld + j0) * pmb->tipo;
+		if (fseeko64(pmb->fp, pos, SEEK_SET) != 0 || fwrite(psrc + (size_t) i * nc, sizeof(float), nc, pmb->fp) != (size_t) nc) {
+			printf("Não conseguiu gravar o arquivo %s! \n", pmb->name);
+			exit(4);
+			}
+		}
+	}
+
+bool fmblecabec(fmbfile * pmb, const char * src) {
+// Lê o cabeçalho do arquivo binário aberto 'pmb' e confere-o com o tamanho do arquivo e com a chave do arquivo texto 'src'
+// (fmbatual). Retorna falso se ele for inválido, estiver incompleto ou desatualizado.
+	// As peças são lidas linha a linha, diretamente no destino
+	setvbuf(pmb->fp, NULL, _IONBF, 0);
+	char cabec[FMB_DADOS];
+	int dims[4] = {0, -1, -1, -1};
+	bool lido = (fread(cabec, 1, FMB_DADOS, pmb->fp) == FMB_DADOS);
+	if (lido) {
+		memcpy(dims, cabec + 4, sizeof(dims));
+		}
+	pmb->tipo = dims[0];
+	pmb->nrows = dims[1];
+	pmb->ncols = dims[2];
+	pmb->ld = dims[3];
+	pmb->paux = NULL;
+	long long int tam = (fseeko64(pmb->fp, 0, SEEK_END) == 0) ? ftello64(pmb->fp) : 0;
+	return (lido && memcmp(cabec, FMB_MAGIC, 4) == 0 && (pmb->tipo == 4 || pmb->tipo == 8) && pmb->nrows >= 0 && pmb->ncols >= 0
+		&& pmb->ld >= pmb->ncols && (long long int) pmb->nrows * pmb->ld * pmb->tipo <= tam - FMB_DADOS && fmbatual(pmb->name, src, cabec));
+	}
+
+void fmblepeca(fmbfile * pmb, int i0, int j0, int nr, int nc, float * pdst) {
+// Lê, em precisão simples, a peça de 'nr' x 'nc' elementos que começa na linha 'i0' e na coluna 'j0' do arquivo aberto por
+// fmbabre, gravando-a em 'pdst' (ld = nc). As linhas em double passam por 'paux' e são convertidas por fcvtdf.
+	for (int i = 0; i < nr; ++ i) {
+		long long int pos = FMB_DADOS + ((long long int) (i0 + i) * pmb->ld + j0) * pmb->tipo;
+		void * plinha = (pmb->tipo == 4) ? (void *) (pdst + (size_t) i * nc) : pmb->paux;
+		if (fseeko64(pmb->fp, pos, SEEK_SET) != 0 || fread(plinha, pmb->tipo, nc, pmb->fp) != (size_t) nc) {
+			printf("Não conseguiu ler o arquivo %s! \n", pmb->name);
+			exit(4);
+			}
+		if (pmb->tipo == 8) {
+			fcvtdf((const double *) pmb->paux, pdst + (size_t) i * nc, nc);
+			}
+		}
+	}
+
+double * lercache(const char * fname, int size, int * pnrows, int * pncols, bool renova) {
+// Mapeia o cache 'fname''size'.cache, gravado por fsavecache, e retorna sua matriz, em double, se o arquivo texto 'fname''size'
+// for o mesmo registrado no cabeçalho; caso contrário, retorna NULL. Com o tamanho e a data gravados, o cache vale sem outra
+// verificação; se só a data mudou, o hash do texto decide, de modo que o arquivo inteiro só é percorrido nesse caso. Se o hash
+// confirmar o cache e 'renova', a chave gravada passa a ter a nova data, e o cache é mapeado de novo. Como em
+// lerbin, a matriz é a própria região mapeada (em cópia na escrita), não pode ser liberada, e o mapeamento dura até o fim do programa.
+	char src[FNAME_MAX_SIZE + 1], name[FNAME_MAX_SIZE + 8];
+	sprintf(src, "%s%d", fname, size);
+	sprintf(name, "%s.cache", src);
+	HANDLE hfile, hmap;
+	long long int tam, chave[3], atual[3];
+	const char * pini = lermapa(name, true, & hfile, & hmap, & tam);
+	if (hfile == INVALID_HANDLE_VALUE) {
+		return NULL;
+		}
+	int cabec[4] = {0, -1, -1, -1};
+	if (pini != NULL && tam >= FMB_DADOS) {
+		memcpy(cabec, pini + 4, sizeof(cabec));
+		memcpy(chave, pini + FMB_CHAVE, sizeof(chave));
+		}
+	int nrows = cabec[1], ncols = cabec[2];
+	bool valido = (pini != NULL && memcmp(pini, FMB_MAGIC, 4) == 0 && cabec[0] == 8 && nrows >= 0 && ncols >= 0 && cabec[3] == ncols
+		&& (long long int) nrows * ncols * 8 == tam - FMB_DADOS);
+	// O hash, que exige percorrer o arquivo texto, só é calculado se o tamanho for o mesmo e a data não
+	valido = valido && lerchave(src, atual, false) && atual[0] == chave[0];
+	valido = valido && (atual[1] == chave[1] || (lerchave(src, atual, true) && atual[0] == chave[0] && atual[2] == chave[2]));
+	if (! valido) {
+		if (pini != NULL) {
+			UnmapViewOfFile(pini);
+			}
+		CloseHandle(hmap);
+		CloseHandle(hfile);
+		if (debuglevel_ >= 1) {
+			printf("Cache %s desatualizado ou inválido. \n", name);
 			}
+		return NULL;
 		}
-	float * plast = pvals;
-	for (int i = 1 ; i < rank ; ++ i) {
-		if (debuglevel_ >= 3) {
-			printf("Coef. %d: ", i);
+	if (renova && atual[1] != chave[1]) {
+		// O texto só foi regravado: a chave é renovada no próprio cabeçalho, fora do mapeamento, que o compartilhamento não permite
+		// alterar; se outro processo estiver com o cache aberto, a gravação falha e o hash volta a ser calculado na próxima leitura
+		UnmapViewOfFile(pini);
+		CloseHandle(hmap);
+		CloseHandle(hfile);
+		FILE * fp = fopen(name, "r+b");
+		if (fp != NULL) {
+			bool ok = (fseek(fp, FMB_CHAVE, SEEK_SET) == 0 && fwrite(atual, sizeof(long long int), 3, fp) == 3);
+			ok = (fclose(fp) == 0) && ok;
+			if (ok && debuglevel_ >= 1) {
+				printf("Chave do cache %s renovada. \n", name);
+				}
 			}
-		if (i > 1) {
-			float * result = fmmult(pvals, nrows, nrows, plast, nrows, nrows);
-			if (debuglevel_ >= 2) {
-				printf("A^%d \n", i);
-				fshowmat(result, nrows, nrows, "");
+		return lercache(fname, size, pnrows, pncols, false);
+		}
+	if (debuglevel_ >= 1) {
+		printf("Arquivo %s: linhas = %d, colunas = %d, lido do cache. \n", src, nrows, ncols);
+		}
+	* pnrows = nrows;
+	* pncols = ncols;
+	return (double *) (pini + FMB_DADOS);
+	}
+
+bool lerchave(const char * name, long long int * pchave, bool hash) {
+// Obtém a chave do arquivo 'name' para o cache: tamanho, data da última gravação e, se 'hash', o hash (fnvhash) do conteúdo,
+// em 'pchave[0]', '[1]' e '[2]'. Retorna falso se o arquivo não existir ou não puder ser lido.
+	WIN32_FILE_ATTRIBUTE_DATA atr;
+	if (! GetFileAttributesExA(name, GetFileExInfoStandard, & atr)) {
+		return false;
+		}
+	pchave[0] = ((long long int) atr.nFileSizeHigh << 32) | atr.nFileSizeLow;
+	pchave[1] = ((long long int) atr.ftLastWriteTime.dwHighDateTime << 32) | atr.ftLastWriteTime.dwLowDateTime;
+	pchave[2] = 0;
+	if (! hash) {
+		return true;
+		}
+	HANDLE hfile, hmap;
+	long long int tam;
+	const char * pini = lermapa(name, false, & hfile, & hmap, & tam);
+	if (hfile == INVALID_HANDLE_VALUE) {
+		return false;
+		}
+	if (pini != NULL) {
+		pchave[2] = fnvhash(pini, tam);
+		UnmapViewOfFile(pini);
+		}
+	CloseHandle(hmap);
+	CloseHandle(hfile);
+	return (pini != NULL || tam == 0);
+	}
+
+void lercabec(const char * fname, int size, fmatfile * pmf) {
+// Mapeia em memória o arquivo 'fname''size', gravado pelo MATLAB/Octave, e lê o cabeçalho pelas palavras-chave ("# type:",
+// "# rows:", "# columns:"), em qualquer ordem; as demais linhas de comentário são desprezadas.
+// Deixa 'pcur' na primeira linha de dados e informa as dimensões da matriz em 'nrows' e 'ncols'.
+	sprintf(pmf->name, "%s%d", fname, size);
+	long long int tam;
+	pmf->pini = lermapa(pmf->name, false, & pmf->hfile, & pmf->hmap, & tam);
+	if (pmf->pini == NULL) {
+		printf("Não conseguiu ler o arquivo %s! \n", pmf->name);
+		exit(4);
+		}
+	pmf->pfim = pmf->pini + tam;
+	const char * p = pmf->pini, * pfim = pmf->pfim;
+	int nrows = -1, ncols = -1;
+	while (true) {
+		while (p < pfim && isspace(* p)) {
+			++ p;
+			}
+		if (p == pfim || * p != '#') {
+			break;
+			}
+		for (++ p; p < pfim && isblank(* p); ++ p);
+		const char * pchave = p;
+		while (p < pfim && * p != ':' && * p != '\n') {
+			++ p;
+			}
+		int nchave = p - pchave;
+		if (p < pfim && * p == ':') {
+			for (++ p; p < pfim && isblank(* p); ++ p);
+			const char * pvalor = p;
+			if (nchave == 4 && strncmp(pchave, "rows", 4) == 0) {
+				nrows = (int) lerval(& p, pfim);
+				nrows = (p == pvalor) ? -1 : nrows;
 				}
-			if (i > 2) {
-				free(plast);
+			else if (nchave == 7 && strncmp(pchave, "columns", 7) == 0) {
+				ncols = (int) lerval(& p, pfim);
+				ncols = (p == pvalor) ? -1 : ncols;
+				}
+			else if (nchave == 4 && strncmp(pchave, "type", 4) == 0) {
+				if (pfim - p >= 6 && strncmp(p, "scalar", 6) == 0) {
+					nrows = ncols = 1;
+					}
+				else if (pfim - p < 6 || strncmp(p, "matrix", 6) != 0) {
+					printf("O arquivo %s não contém uma matriz real! \n", pmf->name);
+					lerfecha(pmf);
+					exit(5);
+					}
 				}
-			plast = result;
-			}
-		traces[i] = ftrace(plast, nrows, ncols);
-		if (debuglevel_ >= 3) {
-			printf("s = %f, ", traces[i]);
 			}
-		float sum = 0;
-		for (int k = 1 ; k < i ; ++ k) {
-			sum += coef[k] * traces[i - k];
-			flops_ += 2;
+		while (p < pfim && * p != '\n') {
+			++ p;
 			}
-		coef[i] = (traces[i] - sum) / i;
-		flops_ += 1 + FLOPS_DIV;			
-		if (debuglevel_ >= 3) {
-			printf("sum = %f, a = %f: ", sum, coef[i]);
+		}
+	if (nrows < 0 || ncols < 0) {
+		printf("O cabeçalho do arquivo %s não informa as dimensões da matriz! \n", pmf->name);
+		lerfecha(pmf);
+		exit(5);
+		}
+	// Cada valor ocupa ao menos dois caracteres, contando o separador
+	if (nrows > 0 && ncols > 0 && 2LL * nrows * ncols - 1 > pfim - p) {
+		printf("As dimensões %d x %d do cabeçalho não cabem no arquivo %s! \n", nrows, ncols, pmf->name);
+		lerfecha(pmf);
+		exit(5);
+		}
+	pmf->pcur = p;
+	pmf->nrows = nrows;
+	pmf->ncols = ncols;
+	pmf->linha = 0;
+	if (debuglevel_ >= 1) {
+		printf("Arquivo %s: linhas = %d, colunas = %d. \n", pmf->name, nrows, ncols);
+		}
+	}
+
+void lerfecha(fmatfile * pmf) {
+// Desfaz o mapeamento do arquivo aberto por lercabec.
+	UnmapViewOfFile(pmf->pini);
+	CloseHandle(pmf->hmap);
+	CloseHandle(pmf->hfile);
+	}
+
+int lerimgtoken(FILE * fp) {
+// Lê o próximo inteiro do cabeçalho de uma imagem PGM/PFM, desprezando comentários. Retorna -1 se não houver.
+	int c = fgetc(fp);
+	while (c == '#' || isspace(c)) {
+		if (c == '#') {
+			while (c != '\n' && c != EOF) {
+				c = fgetc(fp);
+				}
 			}
+		c = fgetc(fp);
 		}
-	bool impar = rank & 1;
-	coef[0] = impar ? -1 : 1;
-	return coef;
+	if (! isdigit(c)) {
+		return -1;
+		}
+	int valor = 0;
+	while (isdigit(c)) {
+		valor = 10 * valor + c - '0';
+		c = fgetc(fp);
+		}
+	return valor;
 	}
 
-float * feqcaracLF(float * pmat, int nrows, int ncols, float * pdet, float ** ppinv) {
-// Retorna os coeficientes do polinômio característico da matriz 'pmat' usando algoritmo de Leverrier-Faddeev. Também calcula o determinante e a matriz inversa.
-	int rank = nrows + 1;
-	float nrows2 = nrows * nrows;
-	float * coef = (float *) malloc(rank * sizeof(float));
-	if (coef == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x 2! \n", rank);
-		exit(7);
+float * lerimg(const char * fname, int * pnrows, int * pncols) {
+// Carrega uma imagem em tons de cinza, PGM (P2 ou P5, 8 ou 16 bits) ou PFM (Pf), numa matriz de 'nrows' linhas (altura) por 'ncols'
+// colunas (largura), com a primeira linha no topo da imagem.
+	FILE * fp = fopen(fname, "rb");
+	if (fp == NULL) {
+		printf("Não conseguiu ler o arquivo %s! \n", fname);
+		exit(4);
 		}
-	float * pvals = (float *) malloc(nrows2 * sizeof(float));
-	if (pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, nrows);
+	char tipo[2];
+	if (fread(tipo, 1, 2, fp) != 2 || tipo[0] != 'P' || (tipo[1] != '2' && tipo[1] != '5' && tipo[1] != 'f')) {
+		printf("O arquivo %s não é uma imagem PGM ou PFM em tons de cinza! \n", fname);
+		fclose(fp);
+		exit(5);
+		}
+	int ncols = lerimgtoken(fp), nrows = lerimgtoken(fp);
+	int maxval = 0;
+	float escala = 0;
+	if (tipo[1] == 'f') {
+		if (fscanf(fp, "%f", & escala) != 1 || escala == 0) {
+			nrows = -1;
+			}
+		fgetc(fp);
+		}
+	else {
+		maxval = lerimgtoken(fp);
+		nrows = (maxval <= 0 || maxval > 65535) ? -1 : nrows;
+		}
+	if (nrows <= 0 || ncols <= 0) {
+		printf("Cabeçalho inválido no arquivo %s! \n", fname);
+		fclose(fp);
+		exit(5);
+		}
+	if (debuglevel_ >= 1) {
+		printf("Arquivo %s: linhas = %d, colunas = %d. \n", fname, nrows, ncols);
+		}
+	float * pmat = (float *) malloc(nrows * ncols * sizeof(float));
+	unsigned char * pbuf = (unsigned char *) malloc(ncols * 4);
+	if (pmat == NULL || pbuf == NULL) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+		fclose(fp);
 		exit(7);
 		}
+	int nbytes = (tipo[1] == 'f') ? 4 : ((maxval > 255) ? 2 : 1);
 	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < nrows; ++ j) {
-			pvals[i * nrows + j] = pmat[i * ncols + j];
+		// No formato PFM, as linhas são gravadas de baixo para cima
+		float * prow = pmat + ((tipo[1] == 'f') ? nrows - 1 - i : i) * ncols;
+		if (tipo[1] == '2') {
+			for (int j = 0; j < ncols; ++ j) {
+				prow[j] = lerimgtoken(fp);
+				}
+			continue;
 			}
-		}
-	float * plast = pvals, * pdiff;
-	for (int i = 1 ; i < rank; ++ i) {
-		if (debuglevel_ >= 3) {
-			printf("Coef. %d: ", i);
+		if (fread(pbuf, nbytes, ncols, fp) != (size_t) ncols) {
+			printf("O arquivo %s está incompleto! \n", fname);
+			fclose(fp);
+			exit(4);
 			}
-		if (i > 1) {
-			float * pident = fident(nrows, coef[i - 1]);
-			pdiff = fmadd(plast, nrows, nrows, pident, nrows, nrows, false);
-			free(pident);
-			float * result = fmmult(pvals, nrows, nrows, pdiff, nrows, nrows);
-			if ((i != rank - 1) || (ppinv == NULL)) {
-				free(pdiff);
+		for (int j = 0; j < ncols; ++ j) {
+			unsigned char * pb = pbuf + j * nbytes;
+			if (nbytes == 1) {
+				prow[j] = pb[0];
 				}
-			if (debuglevel_ >= 2) {
-				printf("A%d \n", i);
-				fshowmat(result, nrows, nrows, "");
+			else if (nbytes == 2) {
+				prow[j] = (pb[0] << 8) | pb[1];
 				}
-			if (i > 2) {
-				free(plast);
+			else {
+				// Escala negativa indica valores little-endian
+				unsigned int bits = (escala < 0) ? (pb[0] | (pb[1] << 8) | (pb[2] << 16) | ((unsigned int) pb[3] << 24))
+					: (pb[3] | (pb[2] << 8) | (pb[1] << 16) | ((unsigned int) pb[0] << 24));
+				memcpy(prow + j, & bits, 4);
 				}
-			plast = result;
-			}
-		coef[i] = ftrace(plast, nrows, ncols) / i;
-		flops_ += FLOPS_DIV;			
-		if (debuglevel_ >= 3) {
-			printf("q = %f: ", coef[i]);
 			}
 		}
-	coef[rank] = plast[0];
-	bool impar = rank & 1;
-	float fdet;
-	if (pdet != NULL) {
-		fdet = impar ? - coef[rank] : coef[rank];
-		* pdet = fdet;
+	free(pbuf);
+	fclose(fp);
+	* pnrows = nrows;
+	* pncols = ncols;
+	return pmat;
+	}
+
+int lerlinha(const char ** pp, const char * pfim, int ncols, fmatprec * pdst, size_t pos) {
+// Converte até 'ncols' valores da linha de dados que começa em '*pp', gravando-os a partir da posição 'pos' de cada destino
+// pedido em 'pdst', e deixa '*pp' onde a conversão parou, depois dos espaços seguintes. Retorna o número de valores convertidos.
+	const char * p = * pp;
+	int k;
+	for (k = 0; k < ncols; ++ k) {
+		while (p < pfim && isblank(* p)) {
+			++ p;
+			}
+		const char * pini = p;
+		double valor = lerval(& p, pfim);
+		if (p == pini) {
+			break;
+			}
+		if (pdst->pf != NULL) {
+			pdst->pf[pos + k] = valor;
+			}
+		if (pdst->pd != NULL) {
+			pdst->pd[pos + k] = valor;
+			}
+		if (pdst->pld != NULL) {
+			pdst->pld[pos + k] = valor;
+			}
 		}
-	if ((ppinv != NULL) && (* pdet != 0)) {
-		* ppinv = fmtimes(pdiff, rank, rank, 1/fdet);
+	while (p < pfim && isblank(* p)) {
+		++ p;
 		}
-	coef[0] = impar ? -1 : 1;
-	return coef;
+	* pp = p;
+	return k;
 	}
 
-void ffromsys(float * psys, int nrows, int ncols, float ** ppA, float ** ppB) {
-	int nrows2 = nrows * nrows;
-	float * pmat = (float *) malloc(nrows2 * sizeof(float));
-	float * pvals = (float *) malloc(nrows * sizeof(float));
-	if (pmat == NULL || pvals == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, nrows + 1);
+void lerlinhas(fmatfile * pmf, int nrows, fmatprec * pdst) {
+// Lê as próximas 'nrows' linhas de dados do arquivo aberto por lercabec, com 'ncols' valores cada, nos destinos pedidos em 'pdst'.
+// Uma varredura sequencial localiza o início de cada linha, desprezando linhas em branco; as linhas são então convertidas
+// em paralelo, cada uma diretamente na sua posição em cada destino, em todas as precisões pedidas de uma só vez.
+	const char * p = pmf->pcur, * pfim = pmf->pfim;
+	int ncols = pmf->ncols;
+	if (nrows <= 0) {
+		return;
+		}
+	const char ** plinhas = (const char **) malloc(nrows * sizeof(const char *));
+	if (plinhas == NULL) {
+		printf("Não conseguiu alocar memória para as %d linhas do arquivo %s! \n", nrows, pmf->name);
+		lerfecha(pmf);
 		exit(7);
 		}
 	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < nrows; ++ j) {
-			pmat[i * nrows + j] = psys[i * ncols + j];
+		while (p < pfim && isspace(* p)) {
+			++ p;
 			}
-		pvals[i] = psys[i * ncols + nrows];
-		}
-	* ppA = pmat;
-	* ppB = pvals;
-	return;
-	}
-	
-float * fident(int rank, float val) {
-// Retorna uma matriz identidade com o 'rank' indicado
-	float * result = (float *) calloc(rank * rank, sizeof(float));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, rank);
-		exit(7);
-		}
-	for (int i = 0; i < rank; ++ i) {
-		result[i * (rank + 1)] = val;
+		if (p == pfim) {
+			printf("O arquivo %s tem apenas %d linhas de dados, e não %d! \n", pmf->name, pmf->linha + i, pmf->nrows);
+			lerfecha(pmf);
+			exit(5);
+			}
+		plinhas[i] = p;
+		p = (const char *) memchr(p, '\n', pfim - p);
+		p = (p == NULL) ? pfim : p;
 		}
-	return result;
-	}
-
-bool fisddom(float * pmat, int nrows, int ncols) {
-// Verifica se a matriz 'pmat' é diagonalmente dominante.
+	int erro = nrows;
+	#pragma omp parallel for reduction(min: erro) if ((long long int) nrows * ncols > 10000)
 	for (int i = 0; i < nrows; ++ i) {
-		float sum = 0, ref = pmat[i * (ncols + 1)];
-		for (int j = 0; j < nrows; ++ j) {
-			if (j != i) {
-				sum += pmat[i * ncols + j];
-				if (sum >= ref) {
-					return false;
-					}
+		const char * q = plinhas[i];
+		if (lerlinha(& q, pfim, ncols, pdst, (size_t) i * ncols) < ncols || (q < pfim && * q != '\n' && * q != '\r')) {
+			erro = (i < erro) ? i : erro;
+			}
+		}
+	if (erro < nrows) {
+		// Converte de novo a primeira linha com erro, para informá-lo
+		const char * q = plinhas[erro];
+		int k = lerlinha(& q, pfim, ncols, pdst, (size_t) erro * ncols);
+		if (k == ncols) {
+			printf("A linha %d do arquivo %s tem colunas demais! \n", pmf->linha + erro + 1, pmf->name);
+			}
+		else if (q == pfim || * q == '\n' || * q == '\r') {
+			printf("A linha %d do arquivo %s tem apenas %d valores! \n", pmf->linha + erro + 1, pmf->name, k);
+			}
+		else {
+			printf("Valor inválido na linha %d do arquivo %s! \n", pmf->linha + erro + 1, pmf->name);
+			}
+		lerfecha(pmf);
+		exit((k == ncols) ? 9 : 5);
+		}
+	free(plinhas);
+	if (debuglevel_ >= 2) {
+		for (int i = 0; i < nrows; ++ i) {
+			for (int j = 0; j < ncols; ++ j) {
+				size_t pos = (size_t) i * ncols + j;
+				printf(" %Lf ", (pdst->pld != NULL) ? pdst->pld[pos] : (pdst->pd != NULL) ? pdst->pd[pos] : pdst->pf[pos]);
 				}
+			printf("\n");
 			}
 		}
-	return true;
+	pmf->linha += nrows;
+	pmf->pcur = p;
 	}
 
-bool fissym(float * pmat, int nrows, int ncols) {
-	for (int i = 1; i < nrows; ++ i) {
-		for (int j = 0; j < i; ++ j) {
-			if (pmat[i * ncols + j] != pmat[j * ncols + i]) {
-				return false;
-				}
-			}
+const char * lermapa(const char * name, bool copia, HANDLE * phfile, HANDLE * phmap, long long int * ptam) {
+// Mapeia em memória o arquivo 'name', só para leitura ou, se 'copia', em cópia na escrita, e informa seu tamanho.
+// Retorna o início da região mapeada ou NULL se o arquivo não existir ('hfile' = INVALID_HANDLE_VALUE), estiver vazio ou não
+// puder ser mapeado.
+	* phmap = NULL;
+	* ptam = 0;
+	* phfile = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	LARGE_INTEGER tam;
+	if (* phfile == INVALID_HANDLE_VALUE || ! GetFileSizeEx(* phfile, & tam) || tam.QuadPart == 0) {
+		return NULL;
 		}
-	return true;
+	* ptam = tam.QuadPart;
+	* phmap = CreateFileMappingA(* phfile, NULL, (copia) ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+	return (* phmap == NULL) ? NULL : (const char *) MapViewOfFile(* phmap, (copia) ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
 	}
 
-bool fistris(float * pmat, int nrows, int ncols) {
-	for (int i = 1; i < nrows; ++ i) {
-		for (int j = 0; j < i; ++ j) {
-			if (pmat[i * ncols + j] != 0) {
-				return false;
-				}
+float * flermat(const char * fname, int size, int * pnrows, int * pncols) {
+// Carrega os dados 'fname''size', gravados pelo MATLAB, diretamente numa matriz em precisão simples, sem passar por uma cópia em
+// precisão dupla. Retorna a matriz e informa suas dimensões ('nrows' x 'ncols').
+	float * pval;
+	lermatP(fname, size, pnrows, pncols, & pval, NULL, NULL);
+	return pval;
+	}
+
+double * lermat(const char * fname, int size, int * pnrows, int * pncols) {
+// Carrega os dados 'fname''size', gravados pelo MATLAB, numa matriz em precisão dupla.
+// Retorna a matriz e informa suas dimensões ('nrows' x 'ncols').
+	double * pval;
+	lermatP(fname, size, pnrows, pncols, NULL, & pval, NULL);
+	return pval;
+	}
+
+void lermatP(const char * fname, int size, int * pnrows, int * pncols, float ** ppf, double ** ppd, long double ** ppld) {
+// Carrega os dados 'fname''size', gravados pelo MATLAB, diretamente nas precisões pedidas (ponteiros não nulos): simples em '*ppf',
+// dupla em '*ppd' e estendida em '*ppld', e informa suas dimensões ('nrows' x 'ncols'). Procura os dados, nesta ordem, na versão
+// binária gravada pelo problema 47, se não estiver desatualizada, no arquivo MAT 'fname''size'.mat (variável 'fname' ou, se não
+// houver, a primeira matriz), no arquivo MAT dados'size'.mat (variável 'fname'), no cache 'fname''size'.cache e no arquivo texto
+// 'fname''size'. O arquivo texto é convertido uma única vez, em todas as precisões pedidas e também em dupla, para gravar o cache
+// (fsavecache); os formatos binários, lidos em precisão dupla, são copiados para as demais.
+	char name[FNAME_MAX_SIZE + 1];
+	bool mapeada = false;
+	double * pval = lerbin(fname, size, pnrows, pncols, & mapeada);
+	if (pval == NULL) {
+		sprintf(name, "%s%d.mat", fname, size);
+		pval = lermat5(name, fname, true, pnrows, pncols);
+		}
+	if (pval == NULL) {
+		sprintf(name, "dados%d.mat", size);
+		pval = lermat5(name, fname, false, pnrows, pncols);
+		}
+	if (pval == NULL) {
+		pval = lercache(fname, size, pnrows, pncols);
+		mapeada = (pval != NULL);
+		}
+	if (pval == NULL) {
+		// A chave do arquivo texto é obtida antes da leitura, para que uma alteração durante ela invalide o cache
+		long long int chave[3];
+		sprintf(name, "%s%d", fname, size);
+		bool fonte = lerchave(name, chave, false);
+		double * pd;
+		lertexto(fname, size, pnrows, pncols, ppf, & pd, ppld);
+		if (fonte && (long long int) * pnrows * * pncols > 0) {
+			fsavecache(fname, size, pd, * pnrows, * pncols, chave);
+			}
+		if (ppd != NULL) {
+			* ppd = pd;
+			}
+		else {
+			free(pd);
 			}
+		return;
+		}
+	if (ppf != NULL) {
+		* ppf = fmcopy(pval, * pnrows, * pncols);
+		}
+	if (ppld != NULL) {
+		* ppld = ldmcopy(pval, * pnrows, * pncols);
+		}
+	if (ppd != NULL) {
+		* ppd = pval;
+		}
+	else if (! mapeada) {
+		free(pval);
 		}
-	return true;
 	}
 
-
-float * fmadd(float * pA, int nrowA, int ncolA, float * pB, int nrowB, int ncolB, bool add) {
-// Retorna a soma das matrizes indicadas
-	int nrows = (nrowA > nrowB) ? nrowA : nrowB;
-	int ncols = (ncolA > ncolB) ? ncolA : ncolB;
-	float * result = (float *) malloc(nrows * ncols * sizeof(float));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
-		exit(7);
+double * lermat5(const char * name, const char * var, bool primeira, int * pnrows, int * pncols) {
+// Lê a matriz 'var' do arquivo MAT do MATLAB 'name', no nível 5 sem compressão (save -v6), em qualquer ordem de bytes; se ela
+// não existir e 'primeira' for verdadeiro, lê a primeira matriz do arquivo. Aceita matrizes reais bidimensionais de qualquer
+// classe numérica, com os dados em qualquer tipo de armazenamento, e converte-as para double, por linhas.
+// Retorna NULL se o arquivo não existir ou não contiver a matriz.
+	HANDLE hfile, hmap;
+	long long int tam;
+	const unsigned char * pini = (const unsigned char *) lermapa(name, false, & hfile, & hmap, & tam);
+	if (hfile == INVALID_HANDLE_VALUE) {
+		return NULL;
 		}
-	for (int i = 0; i < nrows; ++ i) {
+	// Cabeçalho: 116 bytes de texto, 8 de deslocamento, versão e indicador da ordem dos bytes ("IM" na ordem nativa)
+	if (pini == NULL || tam < MAT5_CABEC || (memcmp(pini + 126, "IM", 2) != 0 && memcmp(pini + 126, "MI", 2) != 0)) {
+		printf("O arquivo %s não é um arquivo MAT do MATLAB (nível 5)! \n", name);
+		exit(5);
+		}
+	bool troca = (pini[126] == 'M');
+	const unsigned char * p = pini + MAT5_CABEC, * pfim = pini + tam;
+	double * pval = NULL;
+	bool comprimido = false;
+	const char * alvo = var;
+	while (pval == NULL && (p < pfim || (alvo != NULL && primeira))) {
+		if (p >= pfim) {
+			// Não achou 'var': procura a primeira matriz
+			p = pini + MAT5_CABEC;
+			alvo = NULL;
+			}
+		int tipo;
+		unsigned int nbytes;
+		const unsigned char * pdados;
+		long long int total = fmat5tag(p, pfim, troca, & tipo, & nbytes, & pdados);
+		if (total == 0) {
+			p = pfim;
+			continue;
+			}
+		p += total;
+		comprimido = comprimido || (tipo == miCOMPRESSED);
+		if (tipo != miMATRIX) {
+			continue;
+			}
+		// Subelementos: 0: indicadores e classe, 1: dimensões, 2: nome, 3: parte real
+		const unsigned char * q = pdados, * qfim = pdados + nbytes, * psub[4];
+		int tsub[4], nsub = 0;
+		unsigned int nbsub[4];
+		for (long long int t; nsub < 4 && (t = fmat5tag(q, qfim, troca, tsub + nsub, nbsub + nsub, psub + nsub)) != 0; ++ nsub) {
+			q += t;
+			}
+		if (nsub < 3 || nbsub[0] < 8 || tsub[1] != miINT32) {
+			continue;
+			}
+		unsigned int flags = fmat5u32(psub[0], troca), classe = flags & 0xff;
+		int nnome = nbsub[2];
+		const char * pnome = (const char *) psub[2];
+		if ((alvo != NULL && (nnome != (int) strlen(alvo) || memcmp(pnome, alvo, nnome) != 0)) 
+			|| classe < mxDOUBLE_CLASS || classe > mxUINT64_CLASS) {
+			continue;
+			}
+		if (nsub < 4 || fmat5tam(tsub[3]) == 0 || nbsub[1] != 8 || (flags & MAT5_COMPLEXO) != 0) {
+			printf("A variável %.*s do arquivo %s não é uma matriz real bidimensional! \n", nnome, pnome, name);
+			exit(5);
+			}
+		int nrows = fmat5u32(psub[1], troca), ncols = fmat5u32(psub[1] + 4, troca);
+		if (nrows < 0 || ncols < 0 || (long long int) nrows * ncols * fmat5tam(tsub[3]) != nbsub[3]) {
+			printf("A variável %.*s do arquivo %s está incompleta! \n", nnome, pnome, name);
+			exit(5);
+			}
+		if (debuglevel_ >= 1) {
+			printf("Arquivo %s, variável %.*s: linhas = %d, colunas = %d. \n", name, nnome, pnome, nrows, ncols);
+			}
+		pval = (double *) malloc((size_t) nrows * ncols * sizeof(double));
+		if (pval == NULL && nrows * ncols > 0) {
+			printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+			exit(7);
+			}
+		// Os dados do MATLAB são gravados por colunas
 		for (int j = 0; j < ncols; ++ j) {
-			if (add) {
-				result[i * ncols + j] = pA[i * ncolA + j] + pB[i * ncolB + j];
-				}
-			else {
-				result[i * ncols + j] = pA[i * ncolA + j] - pB[i * ncolB + j];
+			for (int i = 0; i < nrows; ++ i) {
+				pval[(size_t) i * ncols + j] = fmat5val(psub[3], tsub[3], (size_t) j * nrows + i, troca);
 				}
-			++ flops_;
 			}
+		* pnrows = nrows;
+		* pncols = ncols;
 		}
-	return result;
+	if (pval == NULL && comprimido) {
+		printf("O arquivo %s contém variáveis comprimidas, que não são lidas; grave-o com save -v6. \n", name);
+		}
+	UnmapViewOfFile(pini);
+	CloseHandle(hmap);
+	CloseHandle(hfile);
+	return pval;
 	}
-	
-float * fmtimes(float * pmat, int nrows, int ncols, float value) {
-	int size = nrows * ncols;
-	float * result = (float *) malloc(size * sizeof(float));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
+
+void lertexto(const char * fname, int size, int * pnrows, int * pncols, float ** ppf, double ** ppd, long double ** ppld) {
+// Carrega os dados do arquivo texto 'fname''size', gravado pelo MATLAB, diretamente nas precisões pedidas (ponteiros não nulos),
+// como lermatP, e informa suas dimensões ('nrows' x 'ncols').
+	fmatfile mf;
+	lercabec(fname, size, & mf);
+	size_t n = (size_t) mf.nrows * mf.ncols;
+	fmatprec dst = {NULL, NULL, NULL};
+	dst.pf = (ppf != NULL) ? (float *) malloc(n * sizeof(float)) : NULL;
+	dst.pd = (ppd != NULL) ? (double *) malloc(n * sizeof(double)) : NULL;
+	dst.pld = (ppld != NULL) ? (long double *) malloc(n * sizeof(long double)) : NULL;
+	if (n > 0 && ((ppf != NULL && dst.pf == NULL) || (ppd != NULL && dst.pd == NULL) || (ppld != NULL && dst.pld == NULL))) {
+		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", mf.nrows, mf.ncols);
+		lerfecha(& mf);
 		exit(7);
 		}
-	for (int i = 0; i < size; ++ i) {
-		result[i] = pmat[i] * value;
-		++ flops_;
+	lerlinhas(& mf, mf.nrows, & dst);
+	// Depois dos dados só pode haver linhas em branco ou, a partir de uma linha '#', comentários e outras variáveis do arquivo
+	for (const char * p = mf.pcur; p < mf.pfim && * p != '#'; ++ p) {
+		if (! isspace(* p)) {
+			printf("O arquivo %s tem mais linhas de dados que as %d informadas no cabeçalho! \n", mf.name, mf.nrows);
+			lerfecha(& mf);
+			exit(5);
+			}
+		}
+	* pnrows = mf.nrows;
+	* pncols = mf.ncols;
+	lerfecha(& mf);
+	if (ppf != NULL) {
+		* ppf = dst.pf;
+		}
+	if (ppd != NULL) {
+		* ppd = dst.pd;
+		}
+	if (ppld != NULL) {
+		* ppld = dst.pld;
 		}
-	return result;
 	}
 
-float * f2diag(float * psrc, int rank, float * pdet) {
-// Diagonaliza um sistema por meio da Eliminação Gaussiana com pivotação e informa o valor do determinante, em precisão simples.
-	int ncols = rank + 1;
-	float * pval = (float *) calloc(rank * ncols, sizeof(float));
-	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", rank, ncols);
-		exit(7);
+double lerval(const char ** pp, const char * pfim) {
+// Converte o número que começa em '*pp', sem copiá-lo, e avança '*pp' até o fim dele; se não houver número, '*pp' não muda.
+// Mantissas de até 2^53 com expoente decimal de até 22 são convertidas exatamente com uma única multiplicação ou divisão
+// (método de Clinger); os demais casos, raros nos arquivos do MATLAB, usam strtod, que arredonda corretamente.
+	static const double pot10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	const char * p = * pp;
+	bool neg = false;
+	if (p < pfim && (* p == '-' || * p == '+')) {
+		neg = (* p ++ == '-');
 		}
-	for (int i = 0; i < rank; ++ i) {
-		for (int j = 0; j <= rank; ++ j) {
-			pval[i * ncols + j] = psrc[i * (rank + 1) + j];
+	unsigned long long mant = 0;
+	int ndig = 0, exp10 = 0;
+	bool digitos = false;
+	for (; p < pfim && isdigit(* p); ++ p, digitos = true) {
+		if (ndig < 19) {
+			mant = 10 * mant + (* p - '0');
+			ndig += (mant != 0);
+			}
+		else {
+			++ exp10;
 			}
 		}
-	if (debuglevel_ >= 2) {
-		fshowmat(pval, rank, ncols, "Inicialização");
+	if (p < pfim && * p == '.') {
+		for (++ p; p < pfim && isdigit(* p); ++ p, digitos = true) {
+			if (ndig < 19) {
+				mant = 10 * mant + (* p - '0');
+				ndig += (mant != 0);
+				-- exp10;
+				}
+			}
 		}
-	bool sinal = false;
-	float det = 1, maxval;
-	for (int j = 0; j < rank; ++ j) {
-		int maxrow = ffindmax(pval, rank, ncols, j, true, j);
-		maxval = pval[maxrow * ncols + j];
-		if (maxval == 0) {
-			printf("Matriz singular! \n");
-			exit(8);
+	if (! digitos) {
+		// Inf e NaN, como gravados pelo Octave
+		if (pfim - p >= 3 && tolower(p[0]) == 'i' && tolower(p[1]) == 'n' && tolower(p[2]) == 'f') {
+			* pp = p + 3;
+			return neg ? - HUGE_VAL : HUGE_VAL;
 			}
-		if (j != maxrow) {
-			sinal = ! sinal;
-			fchangerows(pval, rank, ncols, j, maxrow);
-			if (debuglevel_ >= 2) {
-				printf("Coluna %d pivoteamento\n", j);
-				fshowmat(pval, rank, ncols, "");
-				}
+		if (pfim - p >= 3 && tolower(p[0]) == 'n' && tolower(p[1]) == 'a' && tolower(p[2]) == 'n') {
+			* pp = p + 3;
+			return NAN;
 			}
-		float invmaxval = 1 / maxval;
-		flops_ += FLOPS_DIV;			
-		for (int i = j + 1; i < rank; ++ i) {
-			double multiplier = pval[i * ncols + j] * invmaxval;
-			++ flops_;
-			pval[i * ncols + j] = 0;
-			for (int k = j + 1; k <= rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;				
+		return 0;
+		}
+	if (p < pfim && (* p == 'e' || * p == 'E')) {
+		const char * q = p + 1;
+		bool eneg = false;
+		if (q < pfim && (* q == '-' || * q == '+')) {
+			eneg = (* q ++ == '-');
+			}
+		if (q < pfim && isdigit(* q)) {
+			int e = 0;
+			for (; q < pfim && isdigit(* q); ++ q) {
+				e = (e < 10000) ? 10 * e + (* q - '0') : e;
 				}
+			exp10 += eneg ? - e : e;
+			p = q;
 			}
-		for (int i = j - 1; i >= 0; -- i) {
-			double multiplier = pval[i * ncols + j] * invmaxval;
-			++ flops_;			
-			pval[i * ncols + j] = 0;
-			for (int k = j + 1; k <= rank; ++ k) {
-				pval[i * ncols + k] -= pval[j * ncols + k] * multiplier;
-				flops_ += 2;				
+		}
+	double valor;
+	if (ndig < 19 && mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+		valor = (double) mant;
+		valor = (exp10 < 0) ? valor / pot10[- exp10] : valor * pot10[exp10];
+		valor = neg ? - valor : valor;
+		}
+	else {
+		// strtod precisa do número inteiro, terminado em '\0'; números longos (muitos zeros, por exemplo) vão para o heap
+		char buf[64], * pbuf = buf;
+		size_t len = p - * pp;
+		if (len >= sizeof(buf)) {
+			pbuf = (char *) malloc(len + 1);
+			if (pbuf == NULL) {
+				printf("Não conseguiu alocar memória para o número de %lld caracteres! \n", (long long int) len);
+				exit(7);
 				}
 			}
-		if (debuglevel_ >= 2) {
-			printf("Coluna %d eliminação. Pivô = %f\n", j, maxval);
-			fshowmat(pval, rank, ncols, "");
+		memcpy(pbuf, * pp, len);
+		pbuf[len] = '\0';
+		valor = strtod(pbuf, NULL);
+		if (pbuf != buf) {
+			free(pbuf);
 			}
 		}
-	for (int i = 0; i < rank; ++ i) {
-		det *= pval[i * ncols + i];
-		++ flops_;		
-		}
-	* pdet = det * (sinal ? -1 : 1);
-	return pval;
+	* pp = p;
+	return valor;
 	}
 
-float * fsolveDG(float * psrc, int rank, float * pdet) {
-// Retorna a solução do sistema por diagonalização e informa o valor do determinante, em precisão simples.
-	float * pD = f2diag(psrc, rank, pdet);
-	float * result = (float *) malloc(rank * sizeof(float));
-	if (result == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x 1! \n", rank);
-		exit(7);
-		}
-	for (int i = 0; i < rank; ++ i) {
-		result[i] = pD[i * (rank + 1) + rank] / pD[i * (rank +1) + i];
-		flops_ += FLOPS_DIV;
-		}		
-	if (debuglevel_ >= 2) {
-		fshowmat(result, rank, 1, "Resultado");
-		}
-	return result;
+int fsavebin(const char * fname, double * pmat, int nrows, int ncols, const long long int * pchave) {
+// Grava a matriz no arquivo binário 'fname', no formato lido por lerbin, em double e sem preenchimento (ld = ncols).
+// Se a matriz vier de um arquivo texto, 'pchave' traz a chave dele (lerchave). Retorna 0 se tiver sucesso e um código de erro
+// em caso contrário.
+	return fsavebinP(fname, pmat, sizeof(double), nrows, ncols, pchave);
 	}
 
-float ftrace(float * pmat, int nrows, int ncols) {
-// Retorna o traço da matriz 'pmat'.
-	float sum = 0;
-	for (int i = 0; i < nrows; ++ i) {
-		sum += pmat[i * (ncols + 1)];
+int fsavebinP(const char * fname, const void * pmat, int tipo, int nrows, int ncols, const long long int * pchave) {
+// Grava a matriz no arquivo binário 'fname', no formato lido por lerbin, com elementos de 'tipo' bytes (4 = float, 8 = double)
+// e sem preenchimento (ld = ncols), com a chave 'pchave' do arquivo texto de origem, se houver.
+// Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	FILE * fp = fopen(fname, "wb");
+	if (fp == NULL) {
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
+		exit(4);
 		}
-	return sum;
+	fsavebincabec(fp, tipo, nrows, ncols, pchave);
+	size_t n = (size_t) nrows * ncols;
+	int retcode = (ferror(fp) || fwrite(pmat, tipo, n, fp) != n) ? 4 : 0;
+	if (fclose(fp) != 0) {
+		retcode = 4;
+		}
+	return retcode;
 	}
 
-	
-// Funções para leitura das matrizes gravadas pelo MATLAB	
-double fgetval(char ** pbuffer) {
-// Extrai o primeiro valor existente no "buffer"
-	char * pchar = * pbuffer, valor [bufsize], * pvalor = valor;
-	while (isblank(* pchar)) {
-		pchar ++;
+void fsavebincabec(FILE * fp, int tipo, int nrows, int ncols, const long long int * pchave) {
+// Grava o cabeçalho do arquivo binário de matriz densa, com elementos de 'tipo' bytes e sem preenchimento (ld = ncols).
+// Na conversão ou no cache de um arquivo texto, 'pchave' traz o tamanho, a data e o hash desse arquivo, gravados em FMB_CHAVE.
+	char cabec[FMB_DADOS];
+	int dims[4] = {tipo, nrows, ncols, ncols};
+	memset(cabec, 0, FMB_DADOS);
+	memcpy(cabec, FMB_MAGIC, 4);
+	memcpy(cabec + 4, dims, sizeof(dims));
+	if (pchave != NULL) {
+		memcpy(cabec + FMB_CHAVE, pchave, 3 * sizeof(long long int));
+		}
+	fwrite(cabec, 1, FMB_DADOS, fp);
+	}
+
+void fsavecache(const char * fname, int size, double * pmat, int nrows, int ncols, long long int * pchave) {
+// Grava o cache 'fname''size'.cache da matriz lida do arquivo texto 'fname''size', cujos tamanho e data, obtidos antes da
+// leitura, estão em 'pchave'; o hash é calculado agora e, se o arquivo texto tiver mudado nesse meio tempo, o cache não é gravado.
+// O cache é gravado num arquivo temporário próprio do processo e depois renomeado, de modo que processos simultâneos nunca vêem
+// um cache incompleto. Falhas não são fatais: o cache apenas deixa de existir.
+	char src[FNAME_MAX_SIZE + 1], name[FNAME_MAX_SIZE + 8], tmp[FNAME_MAX_SIZE + 32];
+	sprintf(src, "%s%d", fname, size);
+	sprintf(name, "%s.cache", src);
+	long long int atual[3];
+	if (pmat == NULL || ! lerchave(src, atual, true) || atual[0] != pchave[0] || atual[1] != pchave[1]) {
+		return;
+		}
+	pchave[2] = atual[2];
+	sprintf(tmp, "%s.%lu.tmp", name, (unsigned long) GetCurrentProcessId());
+	FILE * fp = fopen(tmp, "wb");
+	if (fp == NULL) {
+		return;
 		}
-	while (! isblank(* pchar) )	{
-		* pvalor ++ = * pchar ++;
+	fsavebincabec(fp, sizeof(double), nrows, ncols, pchave);
+	size_t n = (size_t) nrows * ncols;
+	bool ok = (fwrite(pmat, sizeof(double), n, fp) == n);
+	ok = (fclose(fp) == 0) && ok;
+	if (! ok || ! MoveFileExA(tmp, name, MOVEFILE_REPLACE_EXISTING)) {
+		remove(tmp);
+		return;
 		}
-	* pvalor = '\0';
-	if (debuglevel_ >= 3) {
-		printf(" '%s' -> %f", valor, atof(valor));
+	if (debuglevel_ >= 1) {
+		printf("Cache %s gravado. \n", name);
 		}
-	* pbuffer = pchar;
-	return atof(valor);
 	}
 
-double * lermat(const char * fname, int size, int * pnrows, int * pncols) {
-// Carrega os dados do arquivo 'fname''size', gravado pelo MATLAB, numa matriz.
-// Retorna a matriz e informa suas dimensões ('nrows' x 'ncols').
-// Considera que a matriz está gravada no formato correto.
-	// Tenta abrir o arquivo
-	char name[FNAME_MAX_SIZE + 1];
-	sprintf(name, "%s%d", fname, size);
-	FILE * fp = fopen (name, "r");
+int fsaveimg(const char * fname, float * pmat, int nrows, int ncols, bool pfm) {
+// Grava a matriz como imagem em tons de cinza: PFM (float, little-endian) se 'pfm' ou, caso contrário, PGM binária,
+// com 8 bits se todos os valores couberem em [0, 255] e 16 bits se não; os valores são arredondados e limitados a [0, 65535].
+	FILE * fp = fopen(fname, "wb");
 	if (fp == NULL) {
-		printf("Não conseguiu ler o arquivo %s! \n", name);
+		printf("Não conseguiu abrir o arquivo %s! \n", fname);
 		exit(4);
 		}
-	char * pbuf, buf[bufsize];
-	// Despreza as 3 primeiras linhas
-	for (int i = 0; i < 3; ++ i) {
-		fgets(buf, bufsize, fp);
-		}
-	// Obtém as dimensões da matriz
-	int nrows, ncols;
-	fgets(buf, bufsize, fp);
-	nrows = atoi(buf + POSROWNBR);
-	fgets(buf, bufsize, fp);
-	ncols = atoi(buf + POSCOLNBR);
-	if (debuglevel_ >= 1) {
-		printf("Arquivo %s: linhas = %d, colunas = %d. \n", name, nrows, ncols);
+	float max = 0;
+	for (int i = 0; i < nrows * ncols; ++ i) {
+		max = (pmat[i] > max) ? pmat[i] : max;
 		}
-	double * result, * pval;
-	result = pval = (double *) malloc(nrows * ncols * sizeof(double));
-	if (pval == NULL) {
-		printf("Não conseguiu alocar memória para a matriz %d x %d! \n", nrows, ncols);
-		fclose(fp);
+	int nbytes = (pfm) ? 4 : ((max > 255.5) ? 2 : 1);
+	if (pfm) {
+		fprintf(fp, "Pf\n%d %d\n-1.0\n", ncols, nrows);
+		}
+	else {
+		fprintf(fp, "P5\n%d %d\n%d\n", ncols, nrows, (nbytes == 1) ? 255 : 65535);
+		}
+	unsigned char * pbuf = (unsigned char *) malloc(ncols * 4);
+	if (pbuf == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %d! \n", ncols * 4);
 		exit(7);
 		}
 	for (int i = 0; i < nrows; ++ i) {
-		buf[bufsize - 2] = '\0';
-		fgets(buf, bufsize, fp);
-		if (buf[bufsize - 2] != '\0') {
-			printf("A matriz tem colunas demais!");
-			fclose(fp);
-			exit(9);
+		float * prow = pmat + ((pfm) ? nrows - 1 - i : i) * ncols;
+		for (int j = 0; j < ncols; ++ j) {
+			unsigned char * pb = pbuf + j * nbytes;
+			if (pfm) {
+				unsigned int bits;
+				memcpy(& bits, prow + j, 4);
+				pb[0] = bits;
+				pb[1] = bits >> 8;
+				pb[2] = bits >> 16;
+				pb[3] = bits >> 24;
+				continue;
+				}
+			float v = prow[j] + 0.5f;
+			int valor = (v < 0) ? 0 : ((v > 65535) ? 65535 : (int) v);
+			if (nbytes == 1) {
+				pb[0] = valor;
+				}
+			else {
+				pb[0] = valor >> 8;
+				pb[1] = valor;
+				}
 			}
-		pbuf = buf;
-		for (int k = 0; k < ncols; ++ k) {
-			double valor;
-			valor = fgetval(& pbuf);	
-			* pval ++ = valor;
-			if (debuglevel_ >= 2) {
-				printf(" %f ", valor);
+		fwrite(pbuf, nbytes, ncols, fp);
+		}
+	free(pbuf);
+	fclose(fp);
+	return 0;
+	}
+
+void fsavecabec(FILE * fp, const char * fname, int nrows, int ncols) {
+// Grava o cabeçalho da matriz 'fname' no arquivo aberto, como o Octave o grava e lercabec o lê.
+	fprintf(fp, "# Created by exercmat.c\n# name: %s\n# type: matrix\n# rows: %d\n# columns: %d\n", fname, nrows, ncols);
+	}
+
+int fsavelinhas(FILE * fp, float * pmat, int nrows, int ncols) {
+// Grava as 'nrows' linhas da matriz no arquivo aberto, cada valor precedido de um espaço, como no Octave.
+// As linhas são formatadas em paralelo, por fsaveval, em blocos de cerca de FSAVE_BLOCO bytes, cada um gravado com um único fwrite.
+// Retorna 0 se tiver sucesso e um código de erro se alguma gravação no arquivo, desta ou de chamadas anteriores, tiver falhado.
+	size_t tamlinha = (size_t) ncols * (FSAVE_VALMAX + 1) + 1;
+	int nb = FSAVE_BLOCO / tamlinha;
+	nb = (nb < 1) ? 1 : ((nb > nrows) ? nrows : nb);
+	if (nb <= 0) {
+		return (ferror(fp)) ? 4 : 0;
+		}
+	char * pbuf = (char *) malloc(nb * tamlinha);
+	size_t * ptam = (size_t *) malloc(nb * sizeof(size_t));
+	if (pbuf == NULL || ptam == NULL) {
+		printf("Não conseguiu alocar memória para o vetor %lld! \n", (long long int) nb * tamlinha);
+		exit(7);
+		}
+	for (int ini = 0; ini < nrows; ini += nb) {
+		int nr = (nrows - ini < nb) ? nrows - ini : nb;
+		#pragma omp parallel for if ((long long int) nr * ncols > 10000)
+		for (int i = 0; i < nr; ++ i) {
+			char * p = pbuf + i * tamlinha;
+			float * prow = pmat + (size_t) (ini + i) * ncols;
+			for (int j = 0; j < ncols; ++ j) {
+				* p ++ = ' ';
+				p += fsaveval(p, prow[j]);
 				}
+			* p ++ = '\n';
+			ptam[i] = p - (pbuf + i * tamlinha);
 			}
-		if (debuglevel_ >= 2) {
-			printf("\n");
+		// Junta as linhas do bloco e grava-o
+		size_t n = 0;
+		for (int i = 0; i < nr; ++ i) {
+			memmove(pbuf + n, pbuf + i * tamlinha, ptam[i]);
+			n += ptam[i];
+			}
+		if (fwrite(pbuf, 1, n, fp) != n) {
+			break;
 			}
 		}
-	* pnrows = nrows;
-	* pncols = ncols;
-	fclose(fp);
-	return result;
+	free(pbuf);
+	free(ptam);
+	return (ferror(fp)) ? 4 : 0;
 	}
 
-int fsavemat(const char * fname, float * pmat, int nrows, int ncols, bool header) {
-// Grava a matriz no arquivo 'fname'.
+int fsavemat(const char * fname, float * pmat, int nrows, int ncols, bool header, bool binario) {
+// Grava a matriz no arquivo 'fname': em texto, com ou sem o cabeçalho do Octave, ou, se 'binario', no formato binário lido
+// por lerbin, em float. Retorna 0 se tiver sucesso e um código de erro em caso contrário.
+	if (binario) {
+		return fsavebinP(fname, pmat, sizeof(float), nrows, ncols);
+		}
 	FILE * fp = fopen (fname, "w");
 	if (fp == NULL) {
 		printf("Não conseguiu abrir o arquivo %s! \n", fname);
@@ -5000,15 +9674,93 @@ int fsavemat(const char * fname, float * pmat, int nrows, int ncols, bool header
 		}
 	// Grava um cabeçalho
 	if (header) {
-		fprintf(fp, "#Created by exercmat.c \n# name: %s \n# type: matrix \n# rows: %d \n# columns: %d \n",
-			fname, nrows, ncols);
+		fsavecabec(fp, fname, nrows, ncols);
 		}
-	for (int i = 0; i < nrows; ++ i) {
-		for (int j = 0; j < ncols; ++ j) {
-			fprintf(fp, "%f ", pmat[i * ncols + j]);
+	int retcode = fsavelinhas(fp, pmat, nrows, ncols);
+	if (fclose(fp) != 0) {
+		retcode = 4;
+		}
+	return retcode;
+	}
+
+int fsaveval(char * p, float val) {
+// Escreve em 'p' a representação decimal mais curta (até 9 algarismos) que, lida por lerval, reproduz exatamente 'val', e
+// retorna o número de caracteres escritos (no máximo FSAVE_VALMAX). Para cada número de algarismos, o candidato arredondado é
+// reconvertido como em lerval (uma única multiplicação ou divisão exata); fora do alcance dessa conversão, usa sprintf e strtod.
+	static const double pot10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	char * pini = p;
+	if (val != val) {
+		memcpy(p, "NaN", 3);
+		return 3;
+		}
+	if (val < 0 || (val == 0 && 1 / val < 0)) {
+		* p ++ = '-';
+		}
+	double x = fabs((double) val);
+	if (x == 0 || x > FLT_MAX) {
+		memcpy(p, (x == 0) ? "0" : "Inf", (x == 0) ? 1 : 3);
+		return p - pini + ((x == 0) ? 1 : 3);
+		}
+	int e10 = (int) floor(log10(x)), k = 0;
+	long long int mant = 0;
+	bool achou = false;
+	for (int nd = 1; nd <= 9 && ! achou; ++ nd) {
+		k = nd - 1 - e10;
+		if (k < -22 || k > 22) {
+			break;
 			}
-		fprintf(fp, "\n");
+		mant = (long long int) (((k >= 0) ? x * pot10[k] : x / pot10[- k]) + 0.5);
+		achou = ((float) ((k >= 0) ? mant / pot10[k] : mant * pot10[- k]) == (float) x);
 		}
-	fclose(fp);
-	return 0;
+	if (! achou) {
+		for (int nd = 1; nd <= 9; ++ nd) {
+			int len = sprintf(p, "%.*g", nd, x);
+			if ((float) strtod(p, NULL) == (float) x) {
+				return p - pini + len;
+				}
+			}
+		}
+	for (; mant % 10 == 0; mant /= 10, -- k);
+	char dig[20];
+	int nd = 0;
+	for (; mant > 0; mant /= 10) {
+		dig[nd ++] = '0' + mant % 10;
+		}
+	// Posição do ponto decimal, contada a partir do primeiro algarismo
+	int pos = nd - k;
+	if (pos >= 1 && pos <= 9) {
+		for (int i = 0; i < pos || i < nd; ++ i) {
+			if (i == pos) {
+				* p ++ = '.';
+				}
+			* p ++ = (i < nd) ? dig[nd - 1 - i] : '0';
+			}
+		}
+	else if (pos <= 0 && pos >= -3) {
+		* p ++ = '0';
+		* p ++ = '.';
+		for (int i = pos; i < 0; ++ i) {
+			* p ++ = '0';
+			}
+		for (int i = nd - 1; i >= 0; -- i) {
+			* p ++ = dig[i];
+			}
+		}
+	else {
+		* p ++ = dig[nd - 1];
+		if (nd > 1) {
+			* p ++ = '.';
+			}
+		for (int i = nd - 2; i >= 0; -- i) {
+			* p ++ = dig[i];
+			}
+		int e = pos - 1;
+		* p ++ = 'e';
+		* p ++ = (e < 0) ? '-' : '+';
+		e = (e < 0) ? - e : e;
+		* p ++ = '0' + e / 10;
+		* p ++ = '0' + e % 10;
+		}
+	return p - pini;
 	}
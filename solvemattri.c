@@ -10,13 +10,10 @@ Uso:
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
+#include <windows.h>
 
-#define bufsize 10000			// para leitura dos dados em arquivo
-#define POSROWNBR 7				// posio do nmero de linhas no arquivo
-#define POSCOLNBR 10			// posio do nmero de colunas no arquivo
 
 
-double fgetval(char ** pbuffer);
 double dmnorm2(double * pmat, int nrow, int ncol);
 double * dmtrisolve(double * pmat, int nrows, int ncols, bool superior);
 float fmnorm2(float * pmat, int nrow, int ncol);
@@ -25,7 +22,9 @@ float * fmcopy(double * psrc, int nrows, int ncols);
 float * fmtrisolve(float * pmat, int nrows, int ncols, bool superior);
 long double * ldmcopy(double * psrc, int nrows, int ncols);
 long double * ldmtrisolve(long double * pmat, int nrows, int ncols, bool superior);
+double * lerdados(const char * p, const char * pfim, const char * name, int * pnrows, int * pncols);
 double * lermat(const char * fname, int * nrows, int * ncolA);
+double lerval(const char ** pp, const char * pfim);
 int main(int argc, const char * argv[]);
 
 static int debuglevel_ = 0;
@@ -323,77 +322,218 @@ long double ldmnorm2(long double * pmat, int nrow, int ncol) {
 	}
 
 // Funes para leitura das matrizes gravadas pelo MATLAB	
-double fgetval(char ** pbuffer) {
-// Extrai o primeiro valor existente no "buffer"
-	char * pchar = * pbuffer, valor [bufsize], * pvalor = valor;
-	while (isblank(* pchar)) {
-		pchar ++;
-		}
-	while (! isblank(* pchar) )	{
-		* pvalor ++ = * pchar ++;
-		}
-	* pvalor = '\0';
-	if (debuglevel_ >= 3) {
-		printf(" '%s' -> %f", valor, atof(valor));
+double * lerdados(const char * p, const char * pfim, const char * name, int * pnrows, int * pncols) {
+// Converte o contedo do arquivo 'name', mapeado em memria entre 'p' e 'pfim', numa matriz, sem copi-lo e sem limite de
+// tamanho da linha. O cabealho  lido pelas palavras-chave ("# type:", "# rows:", "# columns:"), em qualquer ordem.
+// Retorna a matriz e informa suas dimenses ('nrows' x 'ncols'), ou NULL em caso de erro.
+	int nrows = -1, ncols = -1;
+	while (true) {
+		while (p < pfim && isspace(* p)) {
+			++ p;
+			}
+		if (p == pfim || * p != '#') {
+			break;
+			}
+		for (++ p; p < pfim && isblank(* p); ++ p);
+		const char * pchave = p;
+		while (p < pfim && * p != ':' && * p != '\n') {
+			++ p;
+			}
+		int nchave = p - pchave;
+		if (p < pfim && * p == ':') {
+			for (++ p; p < pfim && isblank(* p); ++ p);
+			const char * pvalor = p;
+			if (nchave == 4 && strncmp(pchave, "rows", 4) == 0) {
+				nrows = (int) lerval(& p, pfim);
+				nrows = (p == pvalor) ? -1 : nrows;
+				}
+			else if (nchave == 7 && strncmp(pchave, "columns", 7) == 0) {
+				ncols = (int) lerval(& p, pfim);
+				ncols = (p == pvalor) ? -1 : ncols;
+				}
+			else if (nchave == 4 && strncmp(pchave, "type", 4) == 0) {
+				if (pfim - p >= 6 && strncmp(p, "scalar", 6) == 0) {
+					nrows = ncols = 1;
+					}
+				else if (pfim - p < 6 || strncmp(p, "matrix", 6) != 0) {
+					printf("O arquivo %s no contm uma matriz real! \n", name);
+					return NULL;
+					}
+				}
+			}
+		while (p < pfim && * p != '\n') {
+			++ p;
+			}
 		}
-	* pbuffer = pchar;
-	return atof(valor);
-	}
-
-double * lermat(const char * fname, int * pnrows, int * pncols) {
-// Carrega os dados do arquivo 'fname', gravado pelo MATLAB, numa matriz.
-// Retorna a matriz e informa suas dimenses ('nrows' x 'ncols').
-// Considera que a matriz est gravada no formato correto.
-	// Tenta abrir o arquivo
-	char * pchar, * pbuf, buf [bufsize];
-	FILE * fp = fopen (fname, "r");
-	if (fp == NULL) {
-		printf("No conseguiu ler o arquivo %s! \n", fname);
+	if (nrows < 0 || ncols < 0) {
+		printf("O cabealho do arquivo %s no informa as dimenses da matriz! \n", name);
 		return NULL;
 		}
-	// Despreza as 3 primeiras linhas
-	for (int i = 0; i < 3; ++ i) {
-		fgets(buf, bufsize, fp);
-		}
-	// Obtm as dimenses da matriz
-	int nrows, ncols;
-	fgets(buf, bufsize, fp);
-	nrows = atoi(buf + POSROWNBR);
-	fgets(buf, bufsize, fp);
-	ncols = atoi(buf + POSCOLNBR);
 	if (debuglevel_ >= 1) {
-		printf("Arquivo %s: linhas = %d, colunas = %d. \n", fname, nrows, ncols);
+		printf("Arquivo %s: linhas = %d, colunas = %d. \n", name, nrows, ncols);
 		}
 	double * result, * pval;
-	result = pval = (double *) malloc(nrows * ncols * sizeof(double));
+	result = pval = (double *) malloc((size_t) nrows * ncols * sizeof(double));
 	if (pval == NULL) {
 		printf("No conseguiu alocar memria para a matriz %d x %d! \n", nrows, ncols);
-		fclose(fp);
 		return NULL;
 		}
 	for (int i = 0; i < nrows; ++ i) {
-		buf[bufsize - 2] = '\0';
-		fgets(buf, bufsize, fp);
-		if (buf[bufsize - 2] != '\0') {
-			printf("A matriz tem colunas demais!");
-			fclose(fp);
-			return NULL;
+		// Despreza linhas em branco
+		while (p < pfim && isspace(* p)) {
+			++ p;
 			}
-		pbuf = buf;
 		for (int k = 0; k < ncols; ++ k) {
-			double valor;
-			valor = fgetval(& pbuf);	
+			while (p < pfim && isblank(* p)) {
+				++ p;
+				}
+			const char * pini = p;
+			double valor = lerval(& p, pfim);
+			if (p == pini) {
+				if (p == pfim || * p == '\n' || * p == '\r') {
+					printf("A linha %d do arquivo %s tem apenas %d valores! \n", i + 1, name, k);
+					}
+				else {
+					printf("Valor invlido na linha %d do arquivo %s! \n", i + 1, name);
+					}
+				free(result);
+				return NULL;
+				}
 			* pval ++ = valor;
 			if (debuglevel_ >= 2) {
 				printf(" %f ", valor);
 				}
 			}
+		while (p < pfim && isblank(* p)) {
+			++ p;
+			}
+		if (p < pfim && * p != '\n' && * p != '\r') {
+			printf("A linha %d do arquivo %s tem colunas demais! \n", i + 1, name);
+			free(result);
+			return NULL;
+			}
 		if (debuglevel_ >= 2) {
 			printf("\n");
 			}
 		}
 	* pnrows = nrows;
 	* pncols = ncols;
-	fclose(fp);
 	return result;
 	}
+
+double * lermat(const char * name, int * pnrows, int * pncols) {
+// Carrega os dados do arquivo 'name', gravado pelo MATLAB, numa matriz.
+// Retorna a matriz e informa suas dimenses ('nrows' x 'ncols'), ou NULL em caso de erro.
+	// Tenta mapear o arquivo em memria
+	HANDLE hfile = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL), hmap = NULL;
+	LARGE_INTEGER tam;
+	const char * pini = NULL;
+	if (hfile != INVALID_HANDLE_VALUE && GetFileSizeEx(hfile, & tam) && tam.QuadPart > 0) {
+		hmap = CreateFileMappingA(hfile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (hmap != NULL) {
+			pini = (const char *) MapViewOfFile(hmap, FILE_MAP_READ, 0, 0, 0);
+			}
+		}
+	if (pini == NULL) {
+		printf("No conseguiu ler o arquivo %s! \n", name);
+		if (hmap != NULL) {
+			CloseHandle(hmap);
+			}
+		if (hfile != INVALID_HANDLE_VALUE) {
+			CloseHandle(hfile);
+			}
+		return NULL;
+		}
+	double * result = lerdados(pini, pini + tam.QuadPart, name, pnrows, pncols);
+	UnmapViewOfFile(pini);
+	CloseHandle(hmap);
+	CloseHandle(hfile);
+	return result;
+	}
+
+double lerval(const char ** pp, const char * pfim) {
+// Converte o nmero que comea em '*pp', sem copi-lo, e avana '*pp' at o fim dele; se no houver nmero, '*pp' no muda.
+// Mantissas de at 2^53 com expoente decimal de at 22 so convertidas exatamente com uma nica multiplicao ou diviso
+// (mtodo de Clinger); os demais casos, raros nos arquivos do MATLAB, usam strtod, que arredonda corretamente.
+	static const double pot10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+	const char * p = * pp;
+	bool neg = false;
+	if (p < pfim && (* p == '-' || * p == '+')) {
+		neg = (* p ++ == '-');
+		}
+	unsigned long long mant = 0;
+	int ndig = 0, exp10 = 0;
+	bool digitos = false;
+	for (; p < pfim && isdigit(* p); ++ p, digitos = true) {
+		if (ndig < 19) {
+			mant = 10 * mant + (* p - '0');
+			ndig += (mant != 0);
+			}
+		else {
+			++ exp10;
+			}
+		}
+	if (p < pfim && * p == '.') {
+		for (++ p; p < pfim && isdigit(* p); ++ p, digitos = true) {
+			if (ndig < 19) {
+				mant = 10 * mant + (* p - '0');
+				ndig += (mant != 0);
+				-- exp10;
+				}
+			}
+		}
+	if (! digitos) {
+		// Inf e NaN, como gravados pelo Octave
+		if (pfim - p >= 3 && tolower(p[0]) == 'i' && tolower(p[1]) == 'n' && tolower(p[2]) == 'f') {
+			* pp = p + 3;
+			return neg ? - HUGE_VAL : HUGE_VAL;
+			}
+		if (pfim - p >= 3 && tolower(p[0]) == 'n' && tolower(p[1]) == 'a' && tolower(p[2]) == 'n') {
+			* pp = p + 3;
+			return NAN;
+			}
+		return 0;
+		}
+	if (p < pfim && (* p == 'e' || * p == 'E')) {
+		const char * q = p + 1;
+		bool eneg = false;
+		if (q < pfim && (* q == '-' || * q == '+')) {
+			eneg = (* q ++ == '-');
+			}
+		if (q < pfim && isdigit(* q)) {
+			int e = 0;
+			for (; q < pfim && isdigit(* q); ++ q) {
+				e = (e < 10000) ? 10 * e + (* q - '0') : e;
+				}
+			exp10 += eneg ? - e : e;
+			p = q;
+			}
+		}
+	double valor;
+	if (ndig < 19 && mant <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22) {
+		valor = (double) mant;
+		valor = (exp10 < 0) ? valor / pot10[- exp10] : valor * pot10[exp10];
+		valor = neg ? - valor : valor;
+		}
+	else {
+		// strtod precisa do nmero inteiro, terminado em '\0'; nmeros longos (muitos zeros, por exemplo) vo para o heap
+		char buf[64], * pbuf = buf;
+		size_t len = p - * pp;
+		if (len >= sizeof(buf)) {
+			pbuf = (char *) malloc(len + 1);
+			if (pbuf == NULL) {
+				printf("No conseguiu alocar memria para o nmero de %lld caracteres! \n", (long long int) len);
+				exit(7);
+				}
+			}
+		memcpy(pbuf, * pp, len);
+		pbuf[len] = '\0';
+		valor = strtod(pbuf, NULL);
+		if (pbuf != buf) {
+			free(pbuf);
+			}
+		}
+	* pp = p;
+	return valor;
+	}